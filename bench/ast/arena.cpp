@@ -0,0 +1,127 @@
+#include "bench/common.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Parses and destroys ULAM stdlib if `ULAM_PATH' is set, generated modules
+// otherwise, with nodes allocated individually and in arena. Each mode runs
+// in separate process to report its peak RSS.
+
+static constexpr unsigned ModuleNum = 200;
+static constexpr unsigned FunNum = 20;
+static constexpr unsigned Iterations = 20;
+
+using Module = std::pair<std::string, std::string>; // {name, text}
+
+static std::string quark_text(const std::string& name, unsigned n) {
+    std::string text = "quark " + name + " {\n  Unsigned(8) mValue = " +
+                       std::to_string(n % 256) + ";\n";
+    for (unsigned i = 0; i < FunNum; ++i) {
+        const auto idx = std::to_string(i);
+        text += "  Int scaled" + idx + "(Int x, Int y) {\n";
+        text += "    Int r = x * " + idx + " + (Int) mValue - y / 2;\n";
+        text += "    for (Int i = 0; i < y; ++i) { r += i; }\n";
+        text += "    return (r > " + std::to_string(n + i) + ") ? r - 1 : r;\n";
+        text += "  }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+static std::string read_file(const std::filesystem::path& path) {
+    std::ifstream file{path};
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+static std::vector<Module> corpus() {
+    std::vector<Module> modules;
+    const char* ulam_path = std::getenv("ULAM_PATH");
+    if (ulam_path) {
+        const std::filesystem::path dir =
+            std::filesystem::path{ulam_path} / "share" / "ulam" / "stdlib";
+        for (const auto& item : std::filesystem::directory_iterator{dir}) {
+            if (item.path().extension() == ".ulam")
+                modules.emplace_back(
+                    item.path().stem().string(), read_file(item.path()));
+        }
+    } else {
+        for (unsigned n = 0; n < ModuleNum; ++n) {
+            auto name = "Q" + std::to_string(n);
+            auto text = quark_text(name, n);
+            modules.emplace_back(std::move(name), std::move(text));
+        }
+    }
+    return modules;
+}
+
+static int run(const std::vector<Module>& modules, bool use_arena) {
+    const std::string name = use_arena ? "ast/arena" : "ast/heap";
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        ulam::Context ctx;
+        auto ast = ulam::make<ulam::ast::Root>(use_arena);
+        ulam::Parser parser{ctx, ast->ctx()};
+        for (const auto& [module_name, text] : modules) {
+            auto module = parser.parse_module_str(text, module_name + ".ulam");
+            if (!module) {
+                std::cerr << "failed to parse `" << module_name << "'\n";
+                return -1;
+            }
+            if (!ast->has_module(module->name_id()))
+                ast->add_module(std::move(module));
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    bench::report(name, modules.size() * Iterations, "modules", duration);
+    std::cout << name << ": peak RSS " << usage.ru_maxrss << "KB\n";
+    return 0;
+}
+
+int main() {
+    auto modules = corpus();
+    if (modules.empty()) {
+        std::cerr << "no input\n";
+        return -1;
+    }
+    std::size_t size = 0;
+    for (const auto& module : modules)
+        size += module.second.size();
+    std::cout << "ast/arena: " << modules.size() << " modules, "
+              << (size / 1024) << "KB\n";
+
+    for (bool use_arena : {false, true}) {
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "fork failed\n";
+            return -1;
+        }
+        if (pid == 0) {
+            int ret = run(modules, use_arena);
+            std::cout.flush();
+            std::_Exit(ret == 0 ? 0 : 1);
+        }
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != 0)
+            return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "bench/common.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/parser.hpp>
+#include <libulam/sema.hpp>
+
+namespace bench {
+
+ulam::Ptr<ulam::ast::Root> analyze(
+    ulam::Context& ctx,
+    const std::string& text,
+    const std::string& module_name) {
+    auto ast = ulam::make<ulam::ast::Root>();
+
+    ulam::Parser parser{ctx, ast->ctx().str_pool(), ast->ctx().text_pool()};
+    auto module = parser.parse_module_str(text, module_name);
+    if (!module) {
+        std::cerr << "failed to parse `" << module_name << "'\n";
+        std::exit(-1);
+    }
+    ast->add(std::move(module));
+
+    auto program = ulam::sema::init(ctx, ulam::ref(ast));
+    if (!program || !ulam::sema::resolve(ctx, program)) {
+        std::cerr << "failed to analyze `" << module_name << "'\n";
+        std::exit(-1);
+    }
+    return ast;
+}
+
+void report(
+    const std::string& name,
+    double num,
+    const std::string& unit,
+    Clock::duration duration) {
+    double sec = std::chrono::duration<double>(duration).count();
+    std::cout << name << ": " << std::fixed << std::setprecision(0) << num
+              << " " << unit << " in " << std::setprecision(3) << sec
+              << "s, " << std::setprecision(0) << (num / sec) << " " << unit
+              << "/s\n";
+}
+
+} // namespace bench
@@ -0,0 +1,23 @@
+#pragma once
+#include <chrono>
+#include <libulam/ast.hpp>
+#include <libulam/context.hpp>
+#include <string>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+ulam::Ptr<ulam::ast::Root> analyze(
+    ulam::Context& ctx,
+    const std::string& text,
+    const std::string& module_name);
+
+// prints `<name>: <num> <unit> in <sec>s, <num/sec> <unit>/s'
+void report(
+    const std::string& name,
+    double num,
+    const std::string& unit,
+    Clock::duration duration);
+
+} // namespace bench
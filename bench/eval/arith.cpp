@@ -0,0 +1,64 @@
+#include "bench/common.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+static const char* Program = R"END(
+quark Arith {
+  Int poly(Int x) {
+    Int r = 0;
+    for (Int i = 0; i < 100; ++i) {
+      r = (r + x * i - (i / 3) * 2 + (i % 5)) % 65536;
+      if (r > 1000 && i > 50)
+        r = r - 1000;
+    }
+    return r;
+  }
+}
+)END";
+
+static constexpr unsigned Iterations = 400;
+
+// number of loop iterations per `poly` call
+static constexpr unsigned LoopNum = 100;
+
+static long expected(long x) {
+    long r = 0;
+    for (long i = 0; i < (long)LoopNum; ++i) {
+        r = (r + x * i - (i / 3) * 2 + (i % 5)) % 65536;
+        if (r > 1000 && i > 50)
+            r = r - 1000;
+    }
+    return r;
+}
+
+static int run(const std::string& name, bool bytecode) {
+    ulam::Context ctx;
+    ctx.options.eval_options.bytecode = bytecode;
+    auto ast = bench::analyze(ctx, Program, "Arith");
+
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+    const unsigned Arg = 7;
+    const std::string text = "Arith a; a.poly(" + std::to_string(Arg) + ");";
+
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        auto res = eval.eval(text);
+        if (!res || res.value().rvalue().get<ulam::Integer>() != expected(Arg)) {
+            std::cerr << "unexpected result\n";
+            return -1;
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+
+    bench::report(name, LoopNum * Iterations, "iterations", duration);
+    return 0;
+}
+
+int main() {
+    if (run("eval/arith", false) != 0)
+        return -1;
+    return run("eval/arith/bytecode", true);
+}
@@ -0,0 +1,72 @@
+#include "bench/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+static const char* Program = R"END(
+quark Consts(Unsigned w) {
+  constant Int c = (Int) w * 3;
+
+  Int sum(Int x) {
+    Int r = 0;
+    for (Int i = 0; i < 100; ++i) {
+      r += x + (c * 2 - 1) + (Int) (Unsigned(w).maxof / 2);
+      r -= Int(8).maxof - 16 + (w > 4 ? c : -c);
+    }
+    return r;
+  }
+}
+
+element Main {
+  Int run(Int x) {
+    Consts(8) a;
+    return a.sum(x);
+  }
+}
+)END";
+
+static constexpr unsigned Iterations = 400;
+
+// number of loop iterations per `sum` call
+static constexpr unsigned LoopNum = 100;
+
+static long expected(long x) {
+    const long w = 8;
+    const long c = w * 3;
+    long r = 0;
+    for (long i = 0; i < (long)LoopNum; ++i) {
+        r += x + (c * 2 - 1) + (255 / 2);
+        r -= 127 - 16 + c;
+    }
+    return r;
+}
+
+static int run(const std::string& name, bool fold_consts) {
+    ulam::Context ctx;
+    ctx.options.eval_options.fold_consts = fold_consts;
+    auto ast = bench::analyze(ctx, Program, "Main");
+
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+    const unsigned Arg = 7;
+    const std::string text = "Main m; m.run(" + std::to_string(Arg) + ");";
+
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        auto res = eval.eval(text);
+        if (!res || res.value().rvalue().get<ulam::Integer>() != expected(Arg)) {
+            std::cerr << "unexpected result\n";
+            return -1;
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+
+    bench::report(name, LoopNum * Iterations, "iterations", duration);
+    return 0;
+}
+
+int main() {
+    if (run("eval/consts/nofold", false) != 0)
+        return -1;
+    return run("eval/consts/fold", true);
+}
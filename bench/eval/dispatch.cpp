@@ -0,0 +1,77 @@
+#include "bench/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+// Virtual calls from a base class method on elements of a deep hierarchy
+// with multiple inheritance (cf. t41365, t41376). The call site sees more
+// dynamic classes than call cache can hold.
+
+static constexpr unsigned Depth = 12;
+static constexpr unsigned CallNum = 100; // below loop limit
+static constexpr unsigned Iterations = 20;
+
+// Q0 <- Q1 (+ M1) <- ... <- Q<Depth - 1> (+ M<Depth - 1>),
+// element E<k> inherits Q<k>, even levels override `v'
+static std::string program_text() {
+    std::string text = R"END(
+quark Q0 {
+  virtual Int v(Int x) { return x; }
+  virtual Int w() { return 0; }
+  Int run(Int n) {
+    Int s = 0;
+    for (Int i = 0; i < n; ++i)
+      s += v(i);
+    return s;
+  }
+}
+)END";
+    for (unsigned n = 1; n < Depth; ++n) {
+        const auto idx = std::to_string(n);
+        const auto prev = std::to_string(n - 1);
+        text += "quark M" + idx + " {\n";
+        text += "  virtual Int m" + idx + "() { return " + idx + "; }\n";
+        text += "  virtual Int w() { return " + idx + "; }\n";
+        text += "}\n";
+        text += "quark Q" + idx + " : Q" + prev + " + M" + idx + " {\n";
+        if (n % 2 == 0)
+            text += "  @Override Int v(Int x) { return x + " + idx + "; }\n";
+        text += "  Unsigned(2) mQ" + idx + ";\n";
+        text += "}\n";
+    }
+    for (unsigned n = 0; n < Depth; ++n) {
+        const auto idx = std::to_string(n);
+        text += "element E" + idx + " : Q" + idx + " {}\n";
+    }
+    return text;
+}
+
+static ulam::Integer expected(unsigned k) {
+    ulam::Integer overrider = k - (k % 2);
+    return CallNum * (CallNum - 1) / 2 + CallNum * overrider;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = bench::analyze(ctx, program_text(), "Dispatch");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        for (unsigned k = 0; k < Depth; ++k) {
+            const auto idx = std::to_string(k);
+            auto res = eval.eval(
+                "E" + idx + " e; e.run(" + std::to_string(CallNum) + ");");
+            if (!res ||
+                res.value().rvalue().get<ulam::Integer>() != expected(k)) {
+                std::cerr << "unexpected result\n";
+                return -1;
+            }
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+    bench::report(
+        "eval/dispatch", Depth * CallNum * Iterations, "calls", duration);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "bench/common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/sema/eval/env.hpp>
+#include <libulam/sema/eval/native.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/builtin/int.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+// Calls of native functions bound via sema::NativeRegistry from a loop,
+// several natives per class as in System or Math.
+
+static constexpr unsigned CallNum = 100; // below loop limit
+static constexpr unsigned Iterations = 200;
+
+static const char* Program = R"END(
+quark Math {
+  Int add(Int a, Int b) native;
+  Int max(Int a, Int b) native;
+  Int min(Int a, Int b) native;
+}
+
+element Run {
+  Int run(Int n) {
+    Math m;
+    Int s = 0;
+    for (Int i = 0; i < n; ++i)
+      s = m.add(s, m.max(m.min(i, 50), 0));
+    return s;
+  }
+}
+)END";
+
+using ulam::sema::ExprRes;
+using ulam::sema::NativeCall;
+
+template <typename F> static ExprRes binary(NativeCall& call, F f) {
+    auto a = call.args().pop_front().move_value().move_rvalue();
+    auto b = call.args().pop_front().move_value().move_rvalue();
+    auto type = call.env().builtins().int_type();
+    auto value = f(a.get<ulam::Integer>(), b.get<ulam::Integer>());
+    return {type, ulam::Value{type->construct(value)}};
+}
+
+static ExprRes math_add(NativeCall& call) {
+    return binary(call, [](auto a, auto b) { return a + b; });
+}
+
+static ExprRes math_max(NativeCall& call) {
+    return binary(call, [](auto a, auto b) { return std::max(a, b); });
+}
+
+static ExprRes math_min(NativeCall& call) {
+    return binary(call, [](auto a, auto b) { return std::min(a, b); });
+}
+
+static ulam::Integer expected() {
+    ulam::Integer sum = 0;
+    for (ulam::Integer i = 0; i < CallNum; ++i)
+        sum += std::min<ulam::Integer>(i, 50);
+    return sum;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = bench::analyze(ctx, Program, "Math");
+    auto& natives = ast->program()->natives();
+    natives.add("Math", "add@232i_232i", math_add);
+    natives.add("Math", "max@232i_232i", math_max);
+    natives.add("Math", "min@232i_232i", math_min);
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    const auto text = "Run r; r.run(" + std::to_string(CallNum) + ");";
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        auto res = eval.eval(text);
+        if (!res || res.value().rvalue().get<ulam::Integer>() != expected()) {
+            std::cerr << "unexpected result\n";
+            return -1;
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+    bench::report("eval/native", 3 * CallNum * Iterations, "calls", duration);
+    return 0;
+}
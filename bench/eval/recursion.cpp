@@ -0,0 +1,53 @@
+#include "bench/common.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+static const char* Program = R"END(
+quark Fib {
+  Int fib(Int n) {
+    if (n < 2)
+      return n;
+    return fib(n - 1) + fib(n - 2);
+  }
+}
+)END";
+
+static constexpr unsigned FibArg = 15;
+static constexpr unsigned Iterations = 20;
+
+// number of `fib` calls made to compute fib(n)
+static unsigned long call_num(unsigned n) {
+    return (n < 2) ? 1 : 1 + call_num(n - 1) + call_num(n - 2);
+}
+
+static int run(const std::string& name, bool bytecode) {
+    ulam::Context ctx;
+    ctx.options.eval_options.bytecode = bytecode;
+    auto ast = bench::analyze(ctx, Program, "Fib");
+
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+    const std::string text =
+        "Fib f; f.fib(" + std::to_string(FibArg) + ");";
+
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        auto res = eval.eval(text);
+        if (!res || res.value().rvalue().get<ulam::Integer>() != 610) {
+            std::cerr << "unexpected result\n";
+            return -1;
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+
+    bench::report(name, call_num(FibArg) * Iterations, "calls", duration);
+    return 0;
+}
+
+int main() {
+    if (run("eval/recursion", false) != 0)
+        return -1;
+    return run("eval/recursion/bytecode", true);
+}
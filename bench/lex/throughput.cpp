@@ -0,0 +1,130 @@
+#include "bench/common.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <libulam/context.hpp>
+#include <libulam/lex.hpp>
+#include <libulam/preproc.hpp>
+#include <libulam/src.hpp>
+#include <libulam/src_man.hpp>
+#include <libulam/token.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Lexes ULAM stdlib and test sources if `ULAM_PATH' is set,
+// generated text otherwise.
+
+static const char* Program = R"END(
+/**
+   Counter quark.
+   \symbol Cn
+ */
+quark Counter(Unsigned cBits) {
+  typedef Unsigned(cBits) Count;
+  constant Count cMax = Count.maxof;
+  Count mCount = 0;
+
+  // increments counter, returns true on overflow
+  Bool increment() {
+    if (mCount == cMax) {
+      mCount = 0;
+      return true;
+    }
+    ++mCount;
+    return false;
+  }
+}
+
+element Ticker : Counter(8) {
+  DebugUtils du;
+  String mName = "ticker";
+
+  Void behave() {
+    if (increment())
+      du.print(mName); /* overflow */
+    else
+      du.print((Int) mCount * 0x10);
+  }
+}
+)END";
+
+static constexpr std::size_t MB = 1024 * 1024;
+
+// total size of text lexed
+static constexpr std::size_t TotalSize = 64 * MB;
+
+static std::string read_file(const std::filesystem::path& path) {
+    std::ifstream file{path};
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+static void add_dir(
+    std::vector<std::string>& texts, const std::filesystem::path& dir) {
+    if (!std::filesystem::is_directory(dir)) {
+        std::cerr << "directory `" << dir.string() << "' not found\n";
+        std::exit(-1);
+    }
+    for (const auto& item : std::filesystem::directory_iterator{dir}) {
+        if (item.is_regular_file())
+            texts.push_back(read_file(item.path()));
+    }
+}
+
+static std::vector<std::string> corpus() {
+    std::vector<std::string> texts;
+    const char* ulam_path = std::getenv("ULAM_PATH");
+    if (ulam_path) {
+        const std::filesystem::path root{ulam_path};
+        add_dir(texts, root / "share" / "ulam" / "stdlib");
+        add_dir(texts, root / "src" / "test" / "generic" / "safe");
+    } else {
+        std::string text;
+        while (text.size() < MB)
+            text += Program;
+        texts.push_back(std::move(text));
+    }
+    return texts;
+}
+
+int main() {
+    auto texts = corpus();
+    std::size_t size = 0;
+    for (const auto& text : texts)
+        size += text.size();
+    if (size == 0) {
+        std::cerr << "no input\n";
+        return -1;
+    }
+
+    ulam::Context ctx;
+    ulam::Preproc pp{ctx};
+    std::vector<ulam::Src*> srcs;
+    for (unsigned n = 0; n < texts.size(); ++n)
+        srcs.push_back(ctx.src_man().string(texts[n], std::to_string(n)));
+
+    std::size_t lexed = 0;
+    std::size_t tokens = 0;
+    auto start = bench::Clock::now();
+    while (lexed < TotalSize) {
+        for (auto src : srcs) {
+            ulam::Lex lex{pp, ctx.src_man(), src->id(), src->content()};
+            ulam::Token token;
+            do {
+                lex.lex(token);
+                ++tokens;
+            } while (token.type != ulam::tok::Eof);
+        }
+        lexed += size;
+    }
+    auto duration = bench::Clock::now() - start;
+
+    std::cout << "lex/throughput: " << texts.size() << " sources, "
+              << (size / 1024) << "KB, "
+              << (tokens / (lexed / size)) << " tokens\n";
+    bench::report("lex/throughput", (double)lexed / MB, "MB", duration);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench/common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser/parallel.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Parses generated modules with increasing number of threads.
+
+static constexpr unsigned ModuleNum = 256;
+static constexpr unsigned FunNum = 40;
+static constexpr unsigned Iterations = 4;
+
+static std::string quark_text(const std::string& name, unsigned n) {
+    std::string text = "quark " + name + " {\n  Unsigned(8) mValue = " +
+                       std::to_string(n % 256) + ";\n";
+    for (unsigned i = 0; i < FunNum; ++i) {
+        const auto idx = std::to_string(i);
+        text += "  Int scaled" + idx + "(Int x, Int y) {\n";
+        text += "    Int r = x * " + idx + " + (Int) mValue - y / 2;\n";
+        text += "    for (Int i = 0; i < y; ++i) { r += i; }\n";
+        text += "    return (r > " + std::to_string(n + i) + ") ? r - 1 : r;\n";
+        text += "  }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+int main() {
+    std::vector<std::string> texts;
+    std::size_t size = 0;
+    for (unsigned n = 0; n < ModuleNum; ++n) {
+        texts.push_back(quark_text("Q" + std::to_string(n), n));
+        size += texts.back().size();
+    }
+    std::cout << "parser/parallel: " << ModuleNum << " modules, "
+              << (size / 1024) << "KB\n";
+
+    const unsigned max_jobs =
+        std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    for (unsigned jobs = 1; jobs <= max_jobs; jobs *= 2) {
+        auto start = bench::Clock::now();
+        for (unsigned i = 0; i < Iterations; ++i) {
+            ulam::Context ctx;
+            auto ast = ulam::make<ulam::ast::Root>();
+            ulam::ParallelParser parser{ctx, ast->ctx()};
+            for (unsigned n = 0; n < ModuleNum; ++n)
+                parser.add_module_str(
+                    texts[n], "Q" + std::to_string(n) + ".ulam");
+            for (auto& module : parser.parse(jobs)) {
+                if (!module) {
+                    std::cerr << "failed to parse\n";
+                    return -1;
+                }
+                ast->add_module(std::move(module));
+            }
+        }
+        auto duration = bench::Clock::now() - start;
+        bench::report(
+            "parser/parallel (" + std::to_string(jobs) + " jobs)",
+            ModuleNum * Iterations, "modules", duration);
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "bench/common.hpp"
+#include <iostream>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <string>
+
+// Parses a large generated module with preprocessor running inline and
+// in a separate thread.
+
+static constexpr unsigned FunNum = 4000;
+static constexpr unsigned Iterations = 4;
+
+static std::string module_text() {
+    std::string text = "/** Generated quark. */\nquark Gen {\n";
+    text += "  Unsigned(8) mValue = 1;\n";
+    for (unsigned i = 0; i < FunNum; ++i) {
+        const auto idx = std::to_string(i);
+        text += "  // scaled value " + idx + "\n";
+        text += "  Int scaled" + idx + "(Int x, Int y) {\n";
+        text += "    Int r = x * " + idx + " + (Int) mValue - y / 2;\n";
+        text += "    for (Int i = 0; i < y; ++i) { r += i; }\n";
+        text += "    return (r > " + idx + ") ? r - 1 : r;\n";
+        text += "  }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+int main() {
+    const auto text = module_text();
+    std::cout << "parser/pipeline: " << (text.size() / 1024) << "KB\n";
+
+    for (bool preproc_thread : {false, true}) {
+        auto start = bench::Clock::now();
+        for (unsigned i = 0; i < Iterations; ++i) {
+            ulam::Context ctx;
+            ctx.options.parser_options.preproc_thread = preproc_thread;
+            auto ast = ulam::make<ulam::ast::Root>();
+            ulam::Parser parser{ctx, ast->ctx()};
+            auto module = parser.parse_module_str(text, "Gen.ulam");
+            if (!module || ctx.diag().err_num() > 0) {
+                std::cerr << "failed to parse\n";
+                return -1;
+            }
+            ast->add_module(std::move(module));
+        }
+        auto duration = bench::Clock::now() - start;
+        bench::report(
+            std::string{"parser/pipeline ("} +
+                (preproc_thread ? "preproc thread" : "inline") + ")",
+            FunNum * Iterations, "functions", duration);
+    }
+    return 0;
+}
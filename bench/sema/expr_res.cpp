@@ -0,0 +1,75 @@
+#include "bench/common.hpp"
+#include <any>
+#include <cstdlib>
+#include <iostream>
+#include <libulam/sema/expr_res.hpp>
+#include <libulam/semantic/typed_value.hpp>
+#include <string>
+#include <vector>
+
+using ulam::sema::ExprRes;
+
+// Result with extra data stored in std::any, as before the typed data
+// slot, for comparison
+
+namespace legacy {
+
+struct ExprRes {
+    ExprRes() {}
+
+    ExprRes copy() const {
+        ExprRes res;
+        res.typed_value = typed_value.copy();
+        res.data = data;
+        return res;
+    }
+
+    template <typename T> T get() const { return std::any_cast<T>(data); }
+
+    ulam::TypedValue typed_value;
+    ulam::sema::ExprError error{ulam::sema::ExprError::Nil};
+    std::uint16_t flags{0};
+    std::any data;
+};
+
+} // namespace legacy
+
+static constexpr unsigned Iterations = 2000000;
+
+// typical data of test evaluator: generated code fragments
+static const std::vector<std::string> Strings = {
+    "1", "self", "a + b", "q.get(0)", "(Int) (c << 1u) - x"};
+
+template <typename R, typename Set, typename Get>
+static std::size_t run(const std::string& name, Set set, Get get) {
+    std::size_t len = 0;
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        R res;
+        set(res, Strings[i % Strings.size()]);
+        auto copy = res.copy();
+        len += get(copy).size();
+    }
+    bench::report(name, Iterations, "results", bench::Clock::now() - start);
+    return len;
+}
+
+int main() {
+    auto len = run<legacy::ExprRes>(
+        "sema/expr_res std::any (set, copy, get)",
+        [](legacy::ExprRes& res, const std::string& str) { res.data = str; },
+        [](const legacy::ExprRes& res) { return res.get<std::string>(); });
+    auto len2 = run<ExprRes>(
+        "sema/expr_res data slot (set, copy, get)",
+        [](ExprRes& res, const std::string& str) { res.set_data(str); },
+        [](const ExprRes& res) -> const std::string& {
+            return res.data<std::string>();
+        });
+    if (len != len2) {
+        std::cerr << "unexpected result\n";
+        return -1;
+    }
+    std::cout << "sizeof: std::any " << sizeof(legacy::ExprRes)
+              << ", data slot " << sizeof(ExprRes) << "\n";
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "bench/common.hpp"
+#include <iostream>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <string>
+#include <vector>
+
+// Subtype checks and base offset lookups over all class pairs of a deep
+// hierarchy with multiple inheritance, as done for casts and `as'/`is'
+// conditions.
+
+static constexpr unsigned Depth = 24;
+static constexpr unsigned Iterations = 2000;
+
+// Q0 <- Q1 (+ M1) <- ... <- Q<Depth - 1> (+ M<Depth - 1>), element E<k>
+// inherits Q<k>
+static std::string program_text() {
+    std::string text = "quark Q0 { Bool mQ0; }\n";
+    for (unsigned n = 1; n < Depth; ++n) {
+        const auto idx = std::to_string(n);
+        text += "quark M" + idx + " { Bool mM" + idx + "; }\n";
+        text += "quark Q" + idx + " : Q" + std::to_string(n - 1) + " + M" +
+                idx + " {}\n";
+    }
+    for (unsigned n = 0; n < Depth; ++n) {
+        const auto idx = std::to_string(n);
+        text += "element E" + idx + " : Q" + idx + " {}\n";
+    }
+    return text;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = bench::analyze(ctx, program_text(), "Ancestry");
+
+    auto module = ast->program()->module("Ancestry");
+    std::vector<ulam::Ref<ulam::Class>> classes;
+    for (auto cls : module->classes())
+        classes.push_back(cls);
+
+    std::size_t checks = 0;
+    ulam::bitsize_t off_sum = 0;
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        for (auto base : classes) {
+            for (auto cls : classes) {
+                if (base->is_base_of(cls))
+                    off_sum += cls->base_off(base);
+                ++checks;
+            }
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+    if (off_sum == 0) {
+        std::cerr << "no bases found\n";
+        return -1;
+    }
+    bench::report("semantic/ancestry", checks, "checks", duration);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "bench/common.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <libulam/semantic/value/bits.hpp>
+#include <string>
+
+using ulam::Bits;
+using ulam::BitsView;
+
+// Reference implementation of bit-at-a-time/unit-at-a-time operations,
+// used before word-level kernels, for comparison
+
+namespace legacy {
+
+using size_t = Bits::size_t;
+using unit_t = Bits::unit_t;
+using UnitBinOp = std::function<unit_t(unit_t, unit_t)>;
+
+void write(BitsView view, size_t idx, const BitsView other) {
+    for (size_t off = 0; off < other.len(); off += Bits::UnitSize) {
+        size_t len = std::min<size_t>(Bits::UnitSize, other.len() - off);
+        view.write(idx + off, len, other.read(off, len));
+    }
+}
+
+Bits copy(const BitsView view) {
+    Bits bits{view.len()};
+    write(bits.view(), 0, view);
+    return bits;
+}
+
+bool equal(const BitsView view, const BitsView other) {
+    if (view.len() != other.len())
+        return false;
+    for (size_t off = 0; off < view.len(); off += Bits::UnitSize) {
+        size_t len = std::min<size_t>(Bits::UnitSize, view.len() - off);
+        if (view.read(off, len) != other.read(off, len))
+            return false;
+    }
+    return true;
+}
+
+void bin_op(BitsView view, const BitsView other, UnitBinOp op) {
+    size_t len = std::min(view.len(), other.len());
+    size_t rest = view.len() - len;
+    for (size_t off = 0; off < rest; off += Bits::UnitSize) {
+        size_t chunk = std::min<size_t>(Bits::UnitSize, rest - off);
+        view.write(off, chunk, op(view.read(off, chunk), 0));
+    }
+    size_t other_off = other.len() - len;
+    for (size_t off = 0; off < len; off += Bits::UnitSize) {
+        size_t chunk = std::min<size_t>(Bits::UnitSize, len - off);
+        view.write(
+            rest + off, chunk,
+            op(view.read(rest + off, chunk),
+               other.read(other_off + off, chunk)));
+    }
+}
+
+} // namespace legacy
+
+static Bits make_bits(Bits::size_t len, unsigned seed) {
+    Bits bits{len};
+    Bits::unit_t value = 0x9e3779b97f4a7c15ull * (seed + 1);
+    for (Bits::size_t off = 0; off < len; off += Bits::UnitSize) {
+        Bits::size_t chunk = std::min<size_t>(Bits::UnitSize, len - off);
+        value ^= value << 13;
+        value ^= value >> 7;
+        value ^= value << 17;
+        bits.write(off, chunk, value >> (Bits::UnitSize - chunk));
+    }
+    return bits;
+}
+
+static void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << what << ": results do not match\n";
+        std::exit(-1);
+    }
+}
+
+template <typename F>
+static void run(const std::string& name, unsigned iterations, F f) {
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < iterations; ++i)
+        f();
+    bench::report(name, iterations, "ops", bench::Clock::now() - start);
+}
+
+// `off` is used to make views unaligned
+static void bench_size(
+    const std::string& size_name,
+    Bits::size_t len,
+    Bits::size_t off,
+    unsigned iterations) {
+    const Bits a = make_bits((Bits::size_t)(len + off), 1);
+    const Bits b = make_bits((Bits::size_t)(len + off), 2);
+    const BitsView va = a.view(off, len);
+    const BitsView vb = b.view(off, len);
+
+    // sanity check
+    check(legacy::equal(va.copy().view(), legacy::copy(va).view()), "copy");
+    {
+        Bits x = a.copy();
+        Bits y = a.copy();
+        x.view(off, len) &= vb;
+        legacy::bin_op(y.view(off, len), vb, std::bit_and<Bits::unit_t>{});
+        check(x == y, "&=");
+    }
+
+    const std::string prefix = "semantic/bits/" + size_name + "/";
+    // prevents results from being optimized out
+    volatile unsigned long sink = 0;
+
+    run(prefix + "copy/old", iterations, [&]() {
+        sink += legacy::copy(va).read_bit(0);
+    });
+    run(prefix + "copy/new", iterations, [&]() {
+        sink += va.copy().read_bit(0);
+    });
+
+    Bits dst{(Bits::size_t)(len + off)};
+    run(prefix + "write/old", iterations, [&]() {
+        legacy::write(dst.view(), off, vb);
+    });
+    run(prefix + "write/new", iterations, [&]() {
+        dst.view().write(off, vb);
+    });
+
+    Bits acc = a.copy();
+    run(prefix + "and/old", iterations, [&]() {
+        legacy::bin_op(acc.view(off, len), vb, std::bit_and<Bits::unit_t>{});
+    });
+    run(prefix + "and/new", iterations, [&]() {
+        acc.view(off, len) &= vb;
+    });
+
+    Bits c = a.copy();
+    run(prefix + "eq/old", iterations, [&]() {
+        sink += legacy::equal(va, c.view(off, len));
+    });
+    run(prefix + "eq/new", iterations, [&]() {
+        sink += (c.view(off, len) == va);
+    });
+}
+
+int main() {
+    bench_size("atom", Bits::AtomSize, 0, 2000000);
+    bench_size("atom-unaligned", Bits::AtomSize, 3, 2000000);
+    bench_size("8k", Bits::Size8k, 0, 50000);
+    bench_size("8k-unaligned", Bits::Size8k, 3, 50000);
+}
@@ -0,0 +1,61 @@
+#include "bench/common.hpp"
+#include <iostream>
+#include <libulam/context.hpp>
+#include <string>
+
+// Analyzes a class chain with repeated template instance lookups and
+// overloaded methods merged into every descendant (see TypeKey).
+
+static constexpr unsigned Depth = 30;
+static constexpr unsigned FunNum = 8;
+static constexpr unsigned TypeDefNum = 8;
+static constexpr unsigned Iterations = 20;
+
+static std::string program_text() {
+    std::string text = R"END(
+quark T(Unsigned a, Int b) {
+  Unsigned(8) mT;
+  Int get(Int x) { return x + b; }
+  Int get(Unsigned x) { return (Int) x + (Int) a; }
+}
+)END";
+    for (unsigned n = 0; n < Depth; ++n) {
+        const auto idx = std::to_string(n);
+        text += "quark C" + idx;
+        if (n > 0)
+            text += " : C" + std::to_string(n - 1);
+        text += " {\n";
+        for (unsigned i = 0; i < TypeDefNum; ++i) {
+            const auto args =
+                std::to_string(i % 4) + "u, " + std::to_string(n % 4);
+            text += "  typedef T(" + args + ") T" + std::to_string(i) + ";\n";
+        }
+        for (unsigned i = 0; i < FunNum; ++i) {
+            const auto fun = "  Int f" + std::to_string(i);
+            text += fun + "(Int x) { return x; }\n";
+            text += fun + "(Unsigned x) { return (Int) x; }\n";
+            text += fun + "(T(1u, " + std::to_string(i % 4) +
+                    ") t) { return t.get(1); }\n";
+        }
+        text += "}\n";
+    }
+    text += "element Main : C" + std::to_string(Depth - 1) + " {}\n";
+    return text;
+}
+
+int main() {
+    const auto text = program_text();
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        ulam::Context ctx;
+        auto ast = bench::analyze(ctx, text, "Main");
+        if (!ast || ctx.diag().err_num() > 0) {
+            std::cerr << "failed to analyze\n";
+            return -1;
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+    bench::report(
+        "semantic/type_keys", (Depth + 1) * Iterations, "classes", duration);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench/common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/sim.hpp>
+#include <string>
+#include <thread>
+
+// Events on a grid filled with diffusing elements (cf. MFM Dreg/Res): each
+// event reads a neighbor through event window and swaps with it if empty.
+// Runs with one worker and with a worker per hardware thread.
+
+static constexpr unsigned Size = 64;
+static constexpr unsigned EventNum = 50000;
+
+static const char* Program = R"END(
+quark EventWindow {
+  Atom& aref(Int index) native;
+}
+
+element Empty {}
+
+element Res {
+  Unsigned(8) mAge;
+  Void behave() {
+    EventWindow ew;
+    ++mAge;
+    Int site = (Int) (mAge % 4u) + 1;
+    Atom other = ew.aref(site);
+    if (other as Empty) {
+      ew.aref(site) = ew.aref(0);
+      ew.aref(0) = other;
+    }
+  }
+}
+)END";
+
+static void run(ulam::Ref<ulam::Program> program, unsigned threads) {
+    auto sym = program->module("Sim")->get("Res");
+    auto res = sym->get<ulam::Class>();
+
+    ulam::sim::Grid grid{Size, Size};
+    for (unsigned y = 0; y < Size; y += 2) {
+        for (unsigned x = 0; x < Size; x += 2)
+            grid.set(x, y, res);
+    }
+
+    ulam::sim::SimOptions options;
+    options.threads = threads;
+    options.tile_size = 16;
+    ulam::sim::Sim sim{program, grid, options};
+    auto stats = sim.run(EventNum);
+    if (stats.failed > 0)
+        std::cerr << stats.failed << " events failed\n";
+    bench::report(
+        "sim/events (" + std::to_string(threads) + " threads)", stats.events,
+        "events", stats.duration);
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = bench::analyze(ctx, Program, "Sim");
+    run(ast->program(), 1);
+    run(ast->program(), std::max(std::thread::hardware_concurrency(), 2u));
+    return 0;
+}
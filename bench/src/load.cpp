@@ -0,0 +1,81 @@
+#include "bench/common.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/ast/nodes/root.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <string>
+#include <unistd.h>
+
+// Parses a module loading hundreds of generated files.
+
+static constexpr unsigned FileNum = 400;
+static constexpr unsigned FunNum = 30;
+static constexpr unsigned Iterations = 10;
+
+static std::string quark_text(unsigned n) {
+    const std::string name = "Q" + std::to_string(n);
+    std::string text = "/**\n   Generated quark " + name + ".\n */\n";
+    text += "quark " + name + " {\n  Unsigned(8) mValue = " +
+            std::to_string(n % 256) + ";\n";
+    for (unsigned i = 0; i < FunNum; ++i) {
+        const auto idx = std::to_string(i);
+        text += "\n  // returns value scaled by " + idx + "\n";
+        text += "  Int scaled" + idx + "(Int x) {\n";
+        text += "    Int r = x * " + idx + " + (Int) mValue;\n";
+        text += "    if (r > " + std::to_string(n + i) + ")\n";
+        text += "      return r - 1;\n";
+        text += "    return r;\n  }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+static void write_file(const std::filesystem::path& path, std::string text) {
+    std::ofstream file{path};
+    file << text;
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("ulam_bench_load_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+
+    std::size_t size = 0;
+    std::string main_text{"ulam 1;\n"};
+    for (unsigned n = 0; n < FileNum; ++n) {
+        const std::string filename = "Q" + std::to_string(n) + ".ulam";
+        auto text = quark_text(n);
+        size += text.size();
+        write_file(dir / filename, std::move(text));
+        main_text += "load \"" + filename + "\";\n";
+    }
+    main_text += "element Main {\n  Void behave() {}\n}\n";
+    size += main_text.size();
+    write_file(dir / "Main.ulam", main_text);
+
+    int ret = 0;
+    auto start = bench::Clock::now();
+    for (unsigned i = 0; i < Iterations; ++i) {
+        ulam::Context ctx;
+        auto ast = ulam::make<ulam::ast::Root>();
+        ulam::Parser parser{ctx, ast->ctx().str_pool(), ast->ctx().text_pool()};
+        auto module = parser.parse_module_file(dir / "Main.ulam");
+        if (!module) {
+            std::cerr << "failed to parse\n";
+            ret = -1;
+            break;
+        }
+    }
+    auto duration = bench::Clock::now() - start;
+    std::filesystem::remove_all(dir);
+    if (ret != 0)
+        return ret;
+
+    std::cout << "src/load: " << (FileNum + 1) << " files, " << (size / 1024)
+              << "KB\n";
+    bench::report("src/load", (FileNum + 1) * Iterations, "files", duration);
+    return 0;
+}
@@ -1,11 +1,16 @@
 #pragma once
+#include <libulam/memory/arena.hpp>
+#include <libulam/memory/ptr.hpp>
 #include <libulam/str_pool.hpp>
 
 namespace ulam::ast {
 
 class Context {
 public:
-    Context() { _text_pool.put(""); }
+    explicit Context(bool use_arena = false):
+        _arena{use_arena ? make<mem::Arena>() : Ptr<mem::Arena>{}} {
+        _text_pool.put("");
+    }
 
     str_id_t str_id(const std::string_view str) { return _str_pool.put(str); }
 
@@ -25,7 +30,11 @@ public:
     UniqStrPool& text_pool() { return _text_pool; }
     const UniqStrPool& text_pool() const { return _text_pool; }
 
+    // AST node arena, null if nodes are allocated individually
+    Ref<mem::Arena> arena() { return ref(_arena); }
+
 private:
+    Ptr<mem::Arena> _arena;
     UniqStrPool _str_pool;
     UniqStrPool _text_pool;
 };
@@ -3,6 +3,7 @@
 #include <libulam/ast/str.hpp>
 #include <libulam/ast/visitor.hpp>
 #include <libulam/detail/variant.hpp>
+#include <libulam/memory/arena.hpp>
 #include <libulam/memory/ptr.hpp>
 #include <libulam/semantic/scope.hpp>
 #include <libulam/src_loc.hpp>
@@ -66,6 +67,11 @@ class Node {
 public:
     virtual ~Node();
 
+    // allocated in current arena if set (see mem::Arena::Scope),
+    // arena memory is released with arena
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr);
+
     virtual void accept(Visitor& visitor);
 
     virtual unsigned child_num() const { return 0; }
@@ -100,6 +106,11 @@ public:
         _map[name_id] = node;
     }
 
+    void replace(str_id_t name_id, Ref<N> node) {
+        ulam_assert(has(name_id));
+        _map[name_id] = node;
+    }
+
     Ref<N> get(str_id_t name_id) {
         auto it = _map.find(name_id);
         return (it != _map.end()) ? it->second : Ref<N>{};
@@ -197,8 +208,11 @@ public:
     Ref<Node> child(unsigned n) override { return ref(_items[n]); }
     Ref<const Node> child(unsigned n) const override { return ref(_items[n]); }
 
+protected:
+    void clear() { _items.clear(); }
+
 private:
-    std::vector<ItemT> _items; // TODO: list?
+    std::vector<ItemT, mem::ArenaAllocator<ItemT>> _items; // TODO: list?
 };
 
 // List of nodes of multiple types
@@ -241,7 +255,7 @@ public:
     }
 
 private:
-    std::vector<ItemT> _items; // TODO: list?
+    std::vector<ItemT, mem::ArenaAllocator<ItemT>> _items; // TODO: list?
 };
 
 template <typename B, typename... Ns> class Variant : public B {
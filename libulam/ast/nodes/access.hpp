@@ -6,12 +6,14 @@
 #include <libulam/ast/nodes/exprs.hpp>
 #include <libulam/ast/nodes/params.hpp>
 #include <libulam/ast/nodes/type.hpp>
+#include <libulam/semantic/fun/call_cache.hpp>
 
 namespace ulam::ast {
 
 class FunCall : public Tuple<OpExpr, Expr, ArgList> {
     ULAM_AST_EXPR
     ULAM_AST_SIMPLE_ATTR(Op, fun_op, Op::None)
+    ULAM_AST_PTR_ATTR(FunCallCache, call_cache)
 public:
     FunCall(Ptr<Expr>&& callable, Ptr<ArgList>&& args):
         Tuple{std::move(callable), std::move(args), Op::FunCall} {}
@@ -3,6 +3,7 @@
 #include <libulam/ast/node.hpp>
 #include <libulam/ast/nodes/stmt.hpp>
 #include <libulam/sema/expr_res.hpp>
+#include <libulam/semantic/value/fold_cache.hpp>
 
 #define ULAM_AST_EXPR                                                          \
     ULAM_AST_NODE                                                              \
@@ -17,6 +18,7 @@ namespace ulam::ast {
 
 class Expr : public Stmt {
     ULAM_AST_NODE
+    ULAM_AST_PTR_ATTR(FoldCache, fold_cache)
 public:
     virtual sema::ExprRes accept(ExprVisitor& v) { return {}; };
 };
@@ -6,6 +6,7 @@
 #include <libulam/ast/str.hpp>
 #include <libulam/semantic/number.hpp>
 #include <libulam/semantic/ops.hpp>
+#include <libulam/semantic/scope/slot.hpp>
 #include <libulam/semantic/type/class_name_kind.hpp>
 #include <libulam/semantic/type_ops.hpp>
 #include <libulam/semantic/value.hpp>
@@ -49,6 +50,7 @@ class Ident : public Expr, public Named {
     ULAM_AST_SIMPLE_ATTR(bool, is_self, false)
     ULAM_AST_SIMPLE_ATTR(bool, is_super, false)
     ULAM_AST_SIMPLE_ATTR(bool, is_local, false)
+    ULAM_AST_SIMPLE_ATTR(local_slot_t, local_slot, NoLocalSlot)
 public:
     Ident(Str name): Named{name} {}
 };
@@ -14,6 +14,7 @@
 #include <libulam/semantic/ops.hpp>
 #include <libulam/semantic/type.hpp>
 #include <libulam/semantic/type/class_kind.hpp>
+#include <libulam/semantic/type/local_cache.hpp>
 #include <libulam/semantic/var.hpp>
 #include <libulam/str_pool.hpp>
 #include <libulam/types.hpp>
@@ -95,6 +96,7 @@ public:
 
 class TypeDef : public Tuple<Stmt, TypeName, TypeExpr>, public DefNode {
     ULAM_AST_NODE
+    ULAM_AST_PTR_ATTR(LocalTypeCache, type_cache)
 public:
     TypeDef(Ptr<TypeName>&& type_name, Ptr<TypeExpr>&& type_expr):
         Tuple{std::move(type_name), std::move(type_expr)} {}
@@ -113,6 +115,8 @@ public:
 
 class FunDefBody : public Block {
     ULAM_AST_NODE
+    ULAM_AST_SIMPLE_ATTR(local_slot_t, local_slot_num, NoLocalSlot)
+    ULAM_AST_SIMPLE_ATTR(bool, is_const_folded, false)
 };
 
 class FunRetType : public Tuple<Stmt, TypeName, ExprList> {
@@ -163,6 +167,7 @@ public:
 
 class VarDef : public VarDefBase {
     ULAM_AST_NODE
+    ULAM_AST_PTR_ATTR(LocalTypeCache, type_cache)
 public:
     VarDef(Str name, Ptr<ExprList>&& array_dims, Ptr<InitValue>&& init):
         VarDefBase{name, std::move(array_dims), std::move(init)} {}
@@ -13,7 +13,9 @@ class Root : public List<Node, ModuleDef> {
     ULAM_AST_NODE
     ULAM_AST_PTR_ATTR(Program, program)
 public:
-    Root();
+    // in arena mode nodes of parsed modules are allocated in context arena,
+    // modules must not outlive the tree
+    explicit Root(bool use_arena = false);
     ~Root();
 
     Context& ctx() { return _ctx; }
@@ -22,6 +24,10 @@ public:
     bool has_module(str_id_t name_id) const;
     void add_module(Ptr<ModuleDef>&& mod);
 
+    // replaces module with the same name, returns replaced module or
+    // null if module is added
+    Ptr<ModuleDef> replace_module(Ptr<ModuleDef>&& mod);
+
 private:
     Context _ctx;
     NameIdMap<ModuleDef> _name_id_map;
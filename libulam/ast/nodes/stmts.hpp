@@ -53,6 +53,8 @@ public:
 
 class For : public Tuple<Stmt, Stmt, Cond, Expr, Stmt> {
     ULAM_AST_NODE
+    // iteration defines names in scope (see sema::LocalResolver)
+    ULAM_AST_SIMPLE_ATTR(bool, has_scope_defs, true)
 public:
     For(Ptr<Stmt>&& init, Ptr<Cond>&& cond, Ptr<Expr>&& upd, Ptr<Stmt>&& body):
         Tuple{
@@ -67,6 +69,7 @@ public:
 
 class While : public Tuple<Stmt, Cond, Stmt> {
     ULAM_AST_NODE
+    ULAM_AST_SIMPLE_ATTR(bool, has_scope_defs, true)
 public:
     While(Ptr<Cond>&& cond, Ptr<Stmt>&& body):
         Tuple{std::move(cond), std::move(body)} {}
@@ -4,6 +4,7 @@
 #include <libulam/ast/nodes/expr.hpp>
 #include <libulam/ast/nodes/init.hpp>
 #include <libulam/ast/nodes/stmt.hpp>
+#include <libulam/semantic/scope/slot.hpp>
 #include <libulam/semantic/type/class/prop.hpp>
 #include <libulam/semantic/var.hpp>
 #include <utility>
@@ -18,6 +19,7 @@ class VarDefBase : public Tuple<Stmt, ExprList, InitValue>,
     ULAM_AST_SIMPLE_ATTR(bool, is_const, false)
     ULAM_AST_SIMPLE_ATTR(bool, is_parameter, false)
     ULAM_AST_SIMPLE_ATTR(bool, is_ref, false)
+    ULAM_AST_SIMPLE_ATTR(local_slot_t, local_slot, NoLocalSlot)
 protected:
     VarDefBase(Str name, Ptr<ExprList>&& array_dims, Ptr<InitValue>&& init):
         Tuple{std::move(array_dims), std::move(init)}, Named{name} {}
@@ -0,0 +1,34 @@
+#pragma once
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/src_man.hpp>
+#include <libulam/str_pool.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ulam::ast {
+
+// Binary module format: header, table of module sources (paths and content
+// hashes), tables of referenced name and text strings, nodes in pre-order.
+// Node locations are stored as source index and offset in source.
+// Only attributes set by parser are stored.
+
+constexpr std::uint32_t SerialFormatVersion = 1;
+
+// returns empty string if module cannot be serialized
+std::string write_module(
+    SrcMan& src_man,
+    const UniqStrPool& str_pool,
+    const UniqStrPool& text_pool,
+    Ref<const ModuleDef> module);
+
+// returns null if data is invalid or any of module sources has changed,
+// sources are loaded if not yet known to `src_man'
+Ptr<ModuleDef> read_module(
+    SrcMan& src_man,
+    UniqStrPool& str_pool,
+    UniqStrPool& text_pool,
+    std::string_view data);
+
+} // namespace ulam::ast
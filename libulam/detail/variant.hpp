@@ -17,7 +17,6 @@ public:
     template <typename T>
     explicit Variant(T&& value): _value{std::forward<T>(value)} {}
     Variant() {}
-    virtual ~Variant() {}
 
     Variant(const Variant&) = default;
     Variant& operator=(const Variant&) = default;
@@ -39,6 +39,13 @@ public:
         emit(Diag::Debug, std::forward<Ts>(args)...);
     }
 
+    // number of errors emitted so far
+    unsigned err_num() const { return _err_num; }
+
+    // quiet mode: errors are only counted, fatal errors do not terminate
+    bool is_quiet() const { return _is_quiet; }
+    void set_quiet(bool is_quiet) { _is_quiet = is_quiet; }
+
     void
     emit(Diag::Level lvl, Ref<const ast::Node> node, const std::string& text);
 
@@ -60,6 +67,7 @@ private:
 
     std::reference_wrapper<SrcMan> _src_man;
     unsigned _err_num{0};
+    bool _is_quiet{false};
 };
 
 } // namespace ulam
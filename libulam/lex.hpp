@@ -11,22 +11,16 @@ class Preproc;
 
 class Lex {
 public:
-    Lex(Preproc& pp, SrcMan& src_man, src_id_t src_id, const mem::BufRef buf):
-        _pp{pp},
-        _src_man{src_man},
-        _src_id{src_id},
-        _buf{buf},
-        _cur{buf.start()},
-        _line{buf.start()} {}
+    Lex(Preproc& pp, SrcMan& src_man, src_id_t src_id, const mem::BufRef buf);
 
     void lex(Token& token);
     void lex_path(Token& token);
 
 private:
-    chr_t chr() const { return _cur + 1 - _line; }
     bool at(char ch) const { return *_cur == ch; }
 
     void advance(std::size_t len = 1);
+    void advance_to(const char* cur);
     void skip_whitespace();
     void newline(std::size_t size = 1);
 
@@ -42,17 +36,13 @@ private:
     void lex_word();
 
     Preproc& _pp;
-    SrcMan& _src_man;
-    const src_id_t _src_id;
     const mem::BufRef _buf;
+    const loc_id_t _loc_id; // location ID of buffer start
 
     const char* _cur;
-    const char* _line;
     const char* _tok_start{};
     Token* _tok{};
 
-    linum_t _linum{1};
-
     bool _expect_path{false};
 };
 
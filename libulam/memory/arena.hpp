@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <libulam/memory/ptr.hpp>
+#include <type_traits>
+
+namespace ulam::mem {
+
+// Bump allocator, memory is released all at once when arena is destroyed
+class Arena {
+private:
+    struct Page {
+        Page* next;
+    };
+
+public:
+    // Sets arena used by allocations in current thread (see ast::Node)
+    class Scope {
+    public:
+        explicit Scope(Ref<Arena> arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Ref<Arena> _prev;
+    };
+
+    explicit Arena(std::size_t pagesize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // aligned to `max_align_t'
+    void* alloc(std::size_t size);
+
+    // total size of allocated pages
+    std::size_t size() const { return _size; }
+
+    static Ref<Arena> current();
+
+private:
+    void alloc_page(std::size_t size);
+
+    const std::size_t _pagesize;
+    Page* _pages{nullptr};
+    char* _cur{nullptr};
+    char* _end{nullptr};
+    std::size_t _size{0};
+};
+
+// Standard allocator interface for Arena, uses `operator new' if arena is
+// not set, by default uses current arena (see Arena::Scope)
+template <typename T> class ArenaAllocator {
+    template <typename U> friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(): ArenaAllocator{Arena::current()} {}
+    explicit ArenaAllocator(Ref<Arena> arena): _arena{arena} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other): _arena{other._arena} {}
+
+    T* allocate(std::size_t n) {
+        const auto size = n * sizeof(T);
+        return static_cast<T*>(
+            _arena ? _arena->alloc(size) : ::operator new(size));
+    }
+
+    void deallocate(T* ptr, std::size_t n) {
+        if (!_arena)
+            ::operator delete(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return _arena == other._arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return !operator==(other);
+    }
+
+private:
+    Ref<Arena> _arena;
+};
+
+} // namespace ulam::mem
@@ -5,11 +5,11 @@
 #include <libulam/ast/context.hpp>
 #include <libulam/ast/nodes.hpp>
 #include <libulam/detail/variant.hpp>
+#include <libulam/parser/token_ring.hpp>
 #include <libulam/preproc.hpp>
 #include <libulam/semantic/ops.hpp>
 #include <libulam/str_pool.hpp>
 #include <libulam/token.hpp>
-#include <stack>
 #include <string_view>
 #include <utility>
 
@@ -23,10 +23,20 @@ public:
     using Path = std::filesystem::path;
 
     Parser(Context& ctx, ast::Context& ast_ctx):
-        Parser{ctx, ast_ctx.str_pool(), ast_ctx.text_pool()} {}
-
-    Parser(Context& ctx, UniqStrPool& str_pool, UniqStrPool& text_pool):
-        _ctx{ctx}, _str_pool{str_pool}, _text_pool{text_pool}, _pp{ctx} {}
+        Parser{
+            ctx, ast_ctx.str_pool(), ast_ctx.text_pool(), ast_ctx.arena()} {}
+
+    // module nodes are allocated in `arena' if set
+    Parser(
+        Context& ctx,
+        UniqStrPool& str_pool,
+        UniqStrPool& text_pool,
+        Ref<mem::Arena> arena = {}):
+        _ctx{ctx},
+        _str_pool{str_pool},
+        _text_pool{text_pool},
+        _arena{arena},
+        _pp{ctx} {}
 
     Ptr<ast::ModuleDef> parse_module_file(const Path& path);
     Ptr<ast::ModuleDef>
@@ -91,6 +101,10 @@ private:
     void diag(loc_id_t loc_id, std::size_t size, std::string text);
     template <typename... Ts> void panic(Ts... stop);
 
+    // parses main source added to preprocessor, runs preprocessor in
+    // a separate thread if enabled (see ParserOptions::preproc_thread)
+    Ptr<ast::ModuleDef> parse_main_module(const std::string_view name);
+
     Ptr<ast::ModuleDef> parse_module(const std::string_view name);
     void parse_module_var_or_type_def(Ref<ast::ModuleDef> node);
     Ptr<ast::TypeDef> parse_module_type_def(bool is_marked_local);
@@ -199,6 +213,7 @@ private:
     Number num_lit_number();
 
     const std::string_view tok_str();
+    const Path& tok_src_path();
     ast::Str tok_ast_str();
     str_id_t tok_str_id();
 
@@ -208,10 +223,13 @@ private:
     Context& _ctx;
     UniqStrPool& _str_pool;
     UniqStrPool& _text_pool;
+    Ref<mem::Arena> _arena;
     Preproc _pp;
 
     Token _tok;
-    std::stack<Token> _back;
+    // consumed tokens are kept for putback
+    TokenRing _ring;
+    bool _pp_async{false};
 
     Ref<ast::ClassDef> _cur_cls_def{};
     Ref<ast::FunDef> _cur_fun_def{};
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/str_pool.hpp>
+#include <libulam/types.hpp>
+#include <string>
+
+namespace ulam {
+
+class Context;
+
+// On-disk cache of parsed modules (see ParserOptions::cache_dir),
+// keyed by module path, main source content and parser options.
+// Cached modules are discarded if any of their sources has changed.
+class ParseCache {
+public:
+    struct Stats {
+        std::atomic<std::size_t> hits{0};
+        std::atomic<std::size_t> misses{0};
+        std::atomic<std::size_t> stores{0};
+    };
+
+    ParseCache(Context& ctx, UniqStrPool& str_pool, UniqStrPool& text_pool);
+
+    bool enabled() const { return !_dir.empty(); }
+
+    // registers main source with source manager
+    Ptr<ast::ModuleDef> load(const Path& path);
+
+    void store(const Path& path, Ref<const ast::ModuleDef> module);
+
+    static const Stats& stats() { return _stats; }
+
+private:
+    Path cache_path(const Path& path);
+
+    Context& _ctx;
+    UniqStrPool& _str_pool;
+    UniqStrPool& _text_pool;
+    Path _dir;
+
+    static Stats _stats;
+};
+
+} // namespace ulam
@@ -5,6 +5,10 @@ namespace ulam {
 
 struct ParserOptions {
     bool allow_assign_in_ternary{false};
+    // parsed modules are cached in this directory if not empty
+    Path cache_dir{};
+    // preprocessor runs ahead of parser in a separate thread
+    bool preproc_thread{false};
 };
 
 const ParserOptions DefaultParserOptions{};
@@ -0,0 +1,61 @@
+#pragma once
+#include <libulam/ast/context.hpp>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/memory/arena.hpp>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/str_pool.hpp>
+#include <libulam/types.hpp>
+#include <string>
+#include <vector>
+
+namespace ulam {
+
+class Context;
+
+// Parses independent modules concurrently. Each worker has its own context
+// and string pools, parsed modules are serialized and merged into target
+// pools in order of adding, so string and location IDs do not depend on
+// scheduling. Modules with errors are re-parsed sequentially to report
+// diagnostics in order.
+class ParallelParser {
+public:
+    ParallelParser(Context& ctx, ast::Context& ast_ctx):
+        ParallelParser{
+            ctx, ast_ctx.str_pool(), ast_ctx.text_pool(), ast_ctx.arena()} {}
+
+    ParallelParser(
+        Context& ctx,
+        UniqStrPool& str_pool,
+        UniqStrPool& text_pool,
+        Ref<mem::Arena> arena = {}):
+        _ctx{ctx}, _str_pool{str_pool}, _text_pool{text_pool}, _arena{arena} {}
+
+    void add_module_file(const Path& path);
+    void add_module_str(const std::string& text, const Path& path);
+
+    // string source available to all modules, see Parser::add_str_src
+    void add_str_src(const std::string& text, const Path& path);
+
+    // returns modules in order of adding, null if module could not be parsed
+    std::vector<Ptr<ast::ModuleDef>> parse(unsigned jobs);
+
+private:
+    struct Job {
+        Path path;
+        std::string text;
+        bool is_str;
+        std::string data; // serialized module, empty on error
+    };
+
+    void run(Job& job);
+    Ptr<ast::ModuleDef> merge(Job& job);
+
+    Context& _ctx;
+    UniqStrPool& _str_pool;
+    UniqStrPool& _text_pool;
+    Ref<mem::Arena> _arena;
+    std::vector<Job> _jobs;
+    std::vector<std::pair<Path, std::string>> _str_srcs;
+};
+
+} // namespace ulam
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <libulam/assert.hpp>
+#include <libulam/token.hpp>
+#include <vector>
+
+namespace ulam {
+
+// Bounded single-producer/single-consumer ring of tokens between
+// preprocessor and parser. Positions are monotonic, slot is position modulo
+// ring size. Last `HistSize' consumed tokens are not released to producer,
+// so consumer can step back (see Parser::putback). After `Eof' is pushed
+// consumer keeps getting it, like from preprocessor.
+class TokenRing {
+public:
+    static constexpr std::size_t HistSize = 4;
+    // enough for history and lookahead when filled on demand
+    static constexpr std::size_t MinSize = 8;
+    static constexpr std::size_t DefaultSize = 1024;
+
+    explicit TokenRing(std::size_t size = MinSize) { reset(size); }
+
+    TokenRing(const TokenRing&) = delete;
+    TokenRing& operator=(const TokenRing&) = delete;
+
+    // drops all tokens, `size' must be a power of 2;
+    // must not be called while producer is running
+    void reset(std::size_t size);
+
+    // producer: waits for a free slot, returns false if ring is closed
+    bool push(const Token& token) {
+        auto write = _write.load(std::memory_order_relaxed);
+        if (write - _released.load(std::memory_order_acquire) == _mask + 1 &&
+            !wait_free(write))
+            return false;
+        _tokens[write & _mask] = token;
+        _write.store(write + 1, std::memory_order_release);
+        if (token.is(tok::Eof))
+            _eof.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: next token is available without waiting
+    bool has_next() const {
+        return _read != _write.load(std::memory_order_acquire);
+    }
+
+    // consumer: waits for next token, repeats final `Eof'
+    const Token& next() {
+        if (!has_next() && !wait_next())
+            return _tokens[(_read - 1) & _mask];
+        const auto& token = _tokens[_read++ & _mask];
+        if (_read > _released_local + HistSize) {
+            _released_local = _read - HistSize;
+            _released.store(_released_local, std::memory_order_release);
+        }
+        return token;
+    }
+
+    // consumer: steps back, returns token consumed before current one
+    const Token& back() {
+        ulam_assert(_read > _released_local + 1);
+        --_read;
+        return _tokens[(_read - 1) & _mask];
+    }
+
+    // consumer: stop producer
+    void close() { _closed.store(true, std::memory_order_release); }
+
+private:
+    bool wait_free(std::size_t write);
+    // returns false at end of stream
+    bool wait_next();
+
+    std::vector<Token> _tokens;
+    std::size_t _mask{0};
+    alignas(64) std::atomic<std::size_t> _write{0};
+    alignas(64) std::atomic<std::size_t> _released{0};
+    std::atomic<bool> _closed{false};
+    std::atomic<bool> _eof{false};
+    // consumer only
+    alignas(64) std::size_t _read{0};
+    std::size_t _released_local{0};
+};
+
+} // namespace ulam
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <libulam/diag.hpp>
 #include <libulam/lex.hpp>
 #include <libulam/src_loc.hpp>
@@ -27,11 +28,15 @@ public:
 
     void add_string(std::string text, Path path);
 
+    // repeats final `Eof' at end of input
     Preproc& operator>>(Token& token);
 
     const Path& current_path() const;
 
-    Version version() const { return _version; }
+    // NOTE: read by parser while preprocessor may run in another thread
+    Version version() const {
+        return _version.load(std::memory_order_relaxed);
+    }
 
 private:
     void push(Src* src);
@@ -56,8 +61,9 @@ private:
 
     Context& _ctx;
     utils::PathResolver _path_resolver;
-    Version _version;
+    std::atomic<Version> _version;
     std::stack<std::pair<Src*, Lex>> _stack;
+    Token _eof{};
 };
 
 } // namespace ulam
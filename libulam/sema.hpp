@@ -7,11 +7,26 @@
 
 namespace ulam::sema {
 
+// If AST already has a program (e.g. a base program shared by forked
+// processes), only modules added after previous call are initialized,
+// call `resolve' to resolve them.
 Ref<Program> init(Context& ctx, Ref<ast::Root> ast);
 
 Ref<Module>
 init(Context& ctx, Ref<ast::Root> ast, Ref<ast::ModuleDef> module_def);
 
+// Replaces module with the same name (or adds a new one) in analyzed AST.
+// The module, modules depending on it (transitively) and modules whose class
+// templates are used by affected modules are re-initialized, other modules
+// keep their classes; call `resolve' to resolve re-initialized modules.
+// Dependencies are recorded on import, so modules that have not yet
+// resolved a name from the changed module are not affected.
+// Class and element IDs of removed classes are reused. If the tree uses
+// an arena, nodes of re-initialized modules are copied into it and are only
+// freed with the tree, so arena memory grows with every update.
+Ref<Module>
+update(Context& ctx, Ref<ast::Root> ast, Ptr<ast::ModuleDef>&& module_def);
+
 bool resolve(EvalEnv& env);
 
 bool resolve(Context& ctx, Ref<Program> program);
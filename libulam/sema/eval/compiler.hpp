@@ -0,0 +1,108 @@
+#pragma once
+#include <libulam/ast/nodes.hpp>
+#include <libulam/ast/visitor.hpp>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/sema/eval/helper.hpp>
+#include <libulam/semantic/fun.hpp>
+#include <libulam/semantic/fun/code.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <vector>
+
+namespace ulam::sema {
+
+// Compiles function body to register bytecode (see sema::EvalVm).
+// Supported are functions taking and returning primitive values by value,
+// with bodies consisting of local variable definitions without arrays,
+// assignments, conditionals, loops and calls of other member functions;
+// expressions may refer to local variables, literals and named constants.
+// Anything else makes the function unsupported, such functions are always
+// evaluated by the tree-walking evaluator. Must be called in function scope.
+class EvalCompiler : public EvalHelper, public ast::Visitor {
+public:
+    using EvalHelper::EvalHelper;
+    using ast::Visitor::visit;
+
+    Ptr<FunCode> compile(Ref<Fun> fun, Ref<Class> eff_cls);
+
+    void visit(Ref<ast::FunDefBody> node) override;
+    void visit(Ref<ast::Block> node) override;
+    void visit(Ref<ast::EmptyStmt> node) override;
+    void visit(Ref<ast::ExprStmt> node) override;
+    void visit(Ref<ast::VarDefList> node) override;
+    void visit(Ref<ast::If> node) override;
+    void visit(Ref<ast::For> node) override;
+    void visit(Ref<ast::While> node) override;
+    void visit(Ref<ast::Return> node) override;
+    void visit(Ref<ast::Break> node) override;
+    void visit(Ref<ast::Continue> node) override;
+
+    void visit(Ref<ast::TypeOpExpr> node) override;
+    void visit(Ref<ast::Ident> node) override;
+    void visit(Ref<ast::ParenExpr> node) override;
+    void visit(Ref<ast::BinaryOp> node) override;
+    void visit(Ref<ast::UnaryOp> node) override;
+    void visit(Ref<ast::Cast> node) override;
+    void visit(Ref<ast::BoolLit> node) override;
+    void visit(Ref<ast::NumLit> node) override;
+    void visit(Ref<ast::FunCall> node) override;
+
+private:
+    using reg_t = FunCode::reg_t;
+    using idx_t = FunCode::idx_t;
+    using Opcode = FunCode::Opcode;
+
+    struct Unsupported {
+        const char* reason;
+    };
+
+    // jumps to patch at the end of loop body
+    struct Loop {
+        std::vector<idx_t> breaks;
+        std::vector<idx_t> continues;
+    };
+
+    void stmt(Ref<ast::Stmt> node);
+
+    // compiles expression, returns result register
+    reg_t expr(Ref<ast::Expr> node);
+
+    // compiles expression evaluated for its side effects
+    void effect(Ref<ast::Expr> node);
+
+    void cond(Ref<ast::Cond> node, std::vector<idx_t>& jumps);
+
+    reg_t local(Ref<ast::Ident> node);
+    reg_t tmp();
+
+    reg_t constant(TypedValue&& tv);
+
+    idx_t emit(
+        Opcode opcode,
+        reg_t a = FunCode::NoReg,
+        reg_t b = FunCode::NoReg,
+        reg_t c = FunCode::NoReg,
+        Op op = Op::None,
+        idx_t idx = 0);
+
+    idx_t jump(Opcode opcode, reg_t b = FunCode::NoReg);
+    void patch(idx_t idx);
+    void patch(const std::vector<idx_t>& jumps, idx_t target);
+
+    static void unsupported(const char* reason);
+
+    Ref<Fun> _fun{};
+    Ptr<FunCode> _code{};
+    // local types by slot, unknown until definition
+    std::vector<Ref<Type>> _locals;
+    // first free temporary register
+    reg_t _tmp{0};
+    reg_t _reg_num{0};
+    // expression result register
+    reg_t _reg{FunCode::NoReg};
+    // current expression or statement, stored in instructions for diagnostics
+    Ref<ast::Node> _node{};
+    bool _is_stmt_done{false};
+    std::vector<Loop> _loops;
+};
+
+} // namespace ulam::sema
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/sema/expr_res.hpp>
+
+namespace ulam::ast {
+class Return;
+}
+
+namespace ulam::sema {
+
+// Statement completion signal: set by `return`, `break` and `continue` and
+// consumed by enclosing function call, loop or `which`. Statement sequences
+// stop executing while a signal is pending.
+class EvalCtl {
+public:
+    enum Kind : std::uint8_t { None, Return, Break, Continue };
+
+    EvalCtl() {}
+
+    EvalCtl(EvalCtl&&) = default;
+    EvalCtl& operator=(EvalCtl&&) = default;
+
+    bool empty() const { return _kind == None; }
+    operator bool() const { return !empty(); }
+
+    Kind kind() const { return _kind; }
+    bool is(Kind kind) const { return _kind == kind; }
+
+    void set_return(Ref<ast::Return> node, ExprRes&& res);
+    void set_break();
+    void set_continue();
+
+    Ref<ast::Return> node() const { return _node; }
+
+    const ExprRes& res() const { return _res; }
+    ExprRes move_res(); // resets signal
+
+    void reset();
+
+private:
+    Kind _kind{None};
+    Ref<ast::Return> _node{};
+    ExprRes _res;
+};
+
+} // namespace ulam::sema
@@ -2,6 +2,7 @@
 #include <libulam/ast/nodes/type.hpp>
 #include <libulam/sema/eval/base.hpp>
 #include <libulam/sema/eval/cond_res.hpp>
+#include <libulam/sema/eval/ctl.hpp>
 #include <libulam/sema/eval/flags.hpp>
 #include <libulam/sema/eval/stack.hpp>
 #include <libulam/sema/expr_res.hpp>
@@ -102,7 +103,9 @@ public:
 
     virtual ExprRes eval(Ref<ast::Block> block);
 
-    virtual ExprRes eval_noexec(Ref<Fun> fun);
+    // evaluates function without side effects, default effective class
+    // is function class
+    virtual ExprRes eval_noexec(Ref<Fun> fun, Ref<Class> eff_cls = {});
 
     virtual void eval_stmt(Ref<ast::Stmt> stmt);
 
@@ -147,7 +150,7 @@ public:
     virtual ExprRes funcall(
         Ref<ast::Node> node, Ref<Fun> fun, ExprRes&& obj, ExprResList&& args);
 
-    StackRaii stack_raii(Ref<Fun> fun, LValue self);
+    StackRaii stack_raii(Ref<Fun> fun, LValue self, local_slot_t slot_num = 0);
 
     ScopeRaii scope_raii(scope_flags_t flags = scp::NoFlags);
     ScopeRaii scope_raii(Scope* parent, scope_flags_t flags = scp::NoFlags);
@@ -172,6 +175,9 @@ public:
     const EvalStack::Item& stack_top() const;
     std::size_t stack_size() const;
 
+    Ref<Var> local_var(local_slot_t slot);
+    Ref<Var> set_local_var(local_slot_t slot, Ptr<Var>&& var);
+
     Scope* scope();
     scope_lvl_t scope_lvl() const;
 
@@ -180,6 +186,9 @@ public:
 
     ExprRes move_var_default(Ref<Var> var);
 
+    EvalCtl& ctl() { return _ctl; }
+    const EvalCtl& ctl() const { return _ctl; }
+
 protected:
     virtual void do_eval_stmt(EvalVisitor& vis, Ref<ast::Stmt> stmt);
 
@@ -249,6 +258,7 @@ private:
     Scope* _scope_override{};
     utils::PathResolver _path_resolver;
     VarDefaults _var_defaults;
+    EvalCtl _ctl;
 };
 
 } // namespace ulam::sema
@@ -46,6 +46,11 @@ public:
 protected:
     virtual ExprRes check(Ref<ast::Expr> node, ExprRes&& res);
 
+    // constant folding (see sema::ConstFolder): `folded` returns cached
+    // result of marked expression if available, `fold` stores result
+    ExprRes folded(Ref<ast::Expr> node);
+    ExprRes fold(Ref<ast::Expr> node, ExprRes&& res);
+
     virtual bool check_is_assignable(Ref<ast::Expr> node, const Value& value);
     virtual bool check_is_object(
         Ref<ast::Expr> node, Ref<const Type> type, bool deref = false);
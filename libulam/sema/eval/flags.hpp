@@ -10,6 +10,9 @@ static constexpr eval_flags_t NoFlags = 0;
 static constexpr eval_flags_t NoExec = 1;
 static constexpr eval_flags_t Consteval = 1 << 1;
 static constexpr eval_flags_t NoDerefCast = 1 << 2;
+// only read evaluation caches of shared AST and functions, evaluate misses
+// without caching (e.g. in concurrent evaluation, see sim::Sim)
+static constexpr eval_flags_t ReadOnlyCaches = 1 << 3;
 static constexpr eval_flags_t Last = 1 << 9;
 } // namespace evl
 
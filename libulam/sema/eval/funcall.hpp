@@ -5,6 +5,7 @@
 #include <libulam/sema/expr_res.hpp>
 #include <libulam/semantic/fun.hpp>
 #include <libulam/semantic/scope.hpp>
+#include <libulam/semantic/scope/slot.hpp>
 #include <libulam/semantic/type/class.hpp>
 #include <libulam/semantic/typed_value.hpp>
 
@@ -16,7 +17,7 @@ class EvalFuncall : public EvalHelper {
 public:
     using EvalHelper::EvalHelper;
 
-    virtual ExprRes eval_noexec(Ref<Fun> fun);
+    virtual ExprRes eval_noexec(Ref<Fun> fun, Ref<Class> eff_cls = {});
 
     virtual ExprRes
     construct(Ref<ast::Node> node, Ref<Class> cls, ExprResList&& args);
@@ -55,16 +56,29 @@ protected:
     virtual ExprRes do_funcall_native(
         Ref<ast::Node> node, Ref<Fun> fun, LValue self, ExprResList&& args);
 
+    // resolves function locals on first call, returns call frame size
+    local_slot_t local_slot_num(Ref<Fun> fun);
+
+    // marks constant subexpressions on first call
+    void fold_consts(Ref<Fun> fun);
+
     virtual ExprResList make_args_ph(Ref<Fun> fun);
 
     virtual ExprRes empty_ret_val(Ref<ast::Node> node, Ref<Fun> fun);
 
-    virtual std::pair<FunSet::Matches, ExprError> find_match(
+    // uses call site cache if `node` is a function call
+    virtual std::pair<Ref<Fun>, ExprError> find_fun(
         Ref<ast::Node> node,
         Ref<FunSet> fset,
         Ref<Class> dyn_cls,
         const TypedValueRefList& args);
 
+    // dispatches matching functions
+    virtual std::pair<FunSet::Matches, ExprError> find_match(
+        Ref<ast::Node> node,
+        const FunSet::Matches& matches,
+        Ref<Class> dyn_cls);
+
     virtual ExprResList
     cast_args(Ref<ast::Node>, Ref<Fun> fun, ExprResList&& args);
 
@@ -0,0 +1,101 @@
+#pragma once
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/value.hpp>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace ulam {
+class Fun;
+}
+
+namespace ulam::ast {
+class Node;
+}
+
+namespace ulam::sema {
+
+class EvalEnv;
+class ExprRes;
+class ExprResList;
+
+// Native function call: arguments (already cast to parameter types) and
+// `self' are passed by reference, implementation may move from them
+class NativeCall {
+public:
+    NativeCall(
+        EvalEnv& env,
+        Ref<ast::Node> node,
+        Ref<Fun> fun,
+        LValue& self,
+        ExprResList& args,
+        void* data):
+        _env{env},
+        _node{node},
+        _fun{fun},
+        _self{self},
+        _args{args},
+        _data{data} {}
+
+    EvalEnv& env() { return _env; }
+    Ref<ast::Node> node() const { return _node; }
+    Ref<Fun> fun() const { return _fun; }
+
+    LValue& self() { return _self; }
+    ExprResList& args() { return _args; }
+
+    // user data passed to NativeRegistry::add
+    void* data() const { return _data; }
+
+private:
+    EvalEnv& _env;
+    Ref<ast::Node> _node;
+    Ref<Fun> _fun;
+    LValue& _self;
+    ExprResList& _args;
+    void* _data;
+};
+
+using native_fun_t = ExprRes (*)(NativeCall& call);
+
+struct NativeFun {
+    native_fun_t fun;
+    void* data;
+};
+
+// Host implementations of `native' functions, keyed by mangled class and
+// function names, e.g. {"System", "print@13i"}. A function is looked up on
+// its first call and the result is stored in Fun, so bindings must be added
+// before evaluation. Each binding is added once per program, adding the same
+// names twice is an error.
+class NativeRegistry {
+public:
+    NativeRegistry() {}
+
+    NativeRegistry(const NativeRegistry&) = delete;
+    NativeRegistry& operator=(const NativeRegistry&) = delete;
+
+    void add(
+        const std::string_view cls_name,
+        const std::string_view fun_name,
+        native_fun_t fun,
+        void* data = nullptr);
+
+    bool empty() const { return _map.empty(); }
+
+    bool has(
+        const std::string_view cls_name, const std::string_view fun_name) const;
+
+    Ref<const NativeFun> find(Ref<Fun> fun) const;
+
+    // finds binding on first call, then returns one stored in `fun'
+    Ref<const NativeFun> bind(Ref<Fun> fun) const;
+
+private:
+    static std::string key(
+        const std::string_view cls_name, const std::string_view fun_name);
+
+    std::map<std::string, NativeFun, std::less<>> _map;
+};
+
+} // namespace ulam::sema
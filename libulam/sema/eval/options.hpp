@@ -17,6 +17,21 @@ struct EvalOptions {
     int max_loop_iterations{150}; // -1 for no limit
 
     bool implicit_class_negation_op{true};
+
+    // resolve function locals to call frame slots (see sema::LocalResolver)
+    bool local_slots{true};
+
+    // cache results of constant subexpressions in function bodies
+    // (see sema::ConstFolder)
+    bool fold_consts{true};
+
+    // reuse types resolved by local variable and type definitions
+    bool cache_local_types{true};
+
+    // compile supported functions to bytecode on first call with each
+    // effective class (e.g. template instance or derived class) and run them
+    // in a VM, falling back to tree-walking evaluation (see sema::EvalVm)
+    bool bytecode{false};
 };
 
 constexpr EvalOptions DefaultEvalOptions{};
@@ -1,9 +1,11 @@
 #pragma once
 #include <libulam/memory/ptr.hpp>
 #include <libulam/semantic/fun.hpp>
+#include <libulam/semantic/scope/slot.hpp>
 #include <libulam/semantic/value.hpp>
 #include <libulam/semantic/var.hpp>
 #include <stack>
+#include <vector>
 
 namespace ulam::sema {
 
@@ -11,21 +13,30 @@ class EvalStack {
 public:
     class Item {
     public:
-        Item(Ref<Fun> fun, LValue self): _fun{fun}, _self{self} {}
+        Item(Ref<Fun> fun, LValue self, std::size_t frame_off):
+            _fun{fun}, _self{self}, _frame_off{frame_off} {}
 
         Ref<Fun> fun() const { return _fun; }
         LValue self() const { return _self; }
 
+        // offset of call frame in stack local slots
+        std::size_t frame_off() const { return _frame_off; }
+
     private:
         Ref<Fun> _fun;
         LValue _self;
+        std::size_t _frame_off;
     };
 
     class Raii {
         friend EvalStack;
 
     private:
-        Raii(EvalStack& stack, Ref<Fun> fun, LValue self);
+        Raii(
+            EvalStack& stack,
+            Ref<Fun> fun,
+            LValue self,
+            local_slot_t slot_num);
 
     public:
         ~Raii();
@@ -48,13 +59,18 @@ public:
     Item& top() { return _stack.top(); }
     const Item& top() const { return _stack.top(); }
 
-    Raii raii(Ref<Fun> fun, LValue self);
+    Raii raii(Ref<Fun> fun, LValue self, local_slot_t slot_num = 0);
 
-    void push(Ref<Fun> fun, LValue self);
+    void push(Ref<Fun> fun, LValue self, local_slot_t slot_num = 0);
     void pop();
 
+    // local variable in current call frame
+    Ref<Var> local(local_slot_t slot);
+    Ref<Var> set_local(local_slot_t slot, Ptr<Var>&& var);
+
 private:
     std::stack<Item> _stack;
+    std::vector<Ptr<Var>> _locals;
 };
 
 } // namespace ulam::sema
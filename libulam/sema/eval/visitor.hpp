@@ -53,7 +53,13 @@ protected:
     virtual Ptr<Var> make_var(
         Ref<ast::TypeName> type_name, Ref<ast::VarDef> node, bool is_const);
 
+    // re-initializes variable kept in frame slot
+    virtual Ref<Var> reset_var(Ref<Var> var);
+
     virtual ExprRes ret_res(Ref<ast::Return> node);
+
+    // consumes pending `break`/`continue`, returns true if loop is done
+    bool loop_ctl();
 };
 
 } // namespace ulam::sema
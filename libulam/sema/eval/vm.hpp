@@ -0,0 +1,82 @@
+#pragma once
+#include <libulam/memory/ptr.hpp>
+#include <libulam/sema/eval/helper.hpp>
+#include <libulam/sema/expr_res.hpp>
+#include <libulam/semantic/fun.hpp>
+#include <libulam/semantic/fun/code.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/semantic/type/ops.hpp>
+#include <libulam/semantic/typed_value.hpp>
+#include <libulam/semantic/value.hpp>
+#include <vector>
+
+namespace ulam::sema {
+
+// Runs function bytecode (see sema::EvalCompiler). Registers hold rvalues,
+// operations use the same type rules as the tree-walking evaluator, calls go
+// through the environment, so callees are compiled or evaluated as usual.
+// Code is compiled separately for each effective class.
+//
+// Until the first call is made, a failed operation emits no diagnostics and
+// the function is re-evaluated by the tree-walking evaluator, which reports
+// the error. After a call the VM reports errors itself and returns them.
+class EvalVm : public EvalHelper {
+public:
+    using EvalHelper::EvalHelper;
+
+    // compiles function on first call; returns nil result if function
+    // is not supported or has to be re-evaluated by tree-walking evaluator,
+    // `args` are left intact in this case
+    ExprRes
+    call(Ref<Fun> fun, LValue self, Ref<Class> eff_cls, ExprResList& args);
+
+    // compiles function for effective class unless already compiled,
+    // with read-only caches returns null if not compiled
+    Ref<FunCode> compile(Ref<Fun> fun, Ref<Class> eff_cls);
+
+private:
+    using reg_t = FunCode::reg_t;
+    using Instr = FunCode::Instr;
+    using Opcode = FunCode::Opcode;
+
+    Ref<FunCode> compile(Ref<Fun> fun, LValue self, Ref<Class> eff_cls);
+
+    ExprRes run();
+
+    ExprError binary_op(const Instr& instr);
+    ExprError unary_op(const Instr& instr);
+    ExprError inc_dec(const Instr& instr);
+    ExprError assign(const Instr& instr, reg_t to, TypedValue&& from);
+    ExprError init(const Instr& instr);
+    ExprError cast(const Instr& instr);
+    ExprError jump_if(const Instr& instr, bool& truth);
+    ExprError call(const Instr& instr);
+    ExprRes ret(const Instr& instr);
+
+    // moves temporary, copies local
+    TypedValue take(reg_t reg);
+
+    // stores non-constant value to local
+    void store(reg_t reg, Ref<Type> type, Value&& val);
+
+    ExprRes
+    cast(Ref<ast::Node> node, Ref<Type> type, TypedValue&& tv, bool expl);
+    ExprRes cast(
+        Ref<ast::Node> node,
+        BuiltinTypeId bi_type_id,
+        TypedValue&& tv,
+        bool expl = false);
+
+    // reports operand type error if fallback is not possible
+    ExprError type_error(Ref<ast::Node> node, TypeError error, Ref<Type> type);
+
+    Ref<Fun> _fun{};
+    Ref<FunCode> _code{};
+    LValue _self{};
+    std::vector<TypedValue> _regs;
+    std::vector<int> _loops;
+    // set once a call is made, fallback is not possible after that
+    bool _has_calls{false};
+};
+
+} // namespace ulam::sema
@@ -1,5 +1,4 @@
 #pragma once
-#include <any>
 #include <cstdint>
 #include <libulam/memory/ptr.hpp>
 #include <libulam/sema/expr_error.hpp>
@@ -22,7 +21,13 @@ public:
     static constexpr flags_t Super = 1 << 1;
     static constexpr flags_t Last = 1 << 2;
 
-    using Data = std::any;
+    // Typed extension slot for additional data attached to results by
+    // evaluator subclasses, empty by default
+    class Data {
+    public:
+        virtual ~Data() {}
+        virtual Ptr<Data> copy() const = 0;
+    };
 
     ExprRes(TypedValue&& tv):
         _typed_value{std::move(tv)}, _error{ExprError::Ok}, _flags{0} {}
@@ -66,34 +71,44 @@ public:
     flags_t flags() const { return _flags; }
     void set_flags(flags_t flags) { _flags = flags; };
 
-    bool has_data() const { return _data.has_value(); }
+    bool has_data() const { return (bool)_data; }
 
-    template <typename T> T data() const {
+    template <typename T> const T& data() const {
         ulam_assert(has_data());
-        return std::any_cast<T>(_data);
+        ulam_assert(dynamic_cast<const DataOf<T>*>(_data.get()));
+        return static_cast<const DataOf<T>&>(*_data).value;
     }
 
     template <typename T, typename V> T data(V&& def) const {
         if (has_data())
-            return std::any_cast<T>(_data);
+            return data<T>();
         return T{std::forward<V>(def)};
     }
 
-    template <typename T> void set_data(T data) { _data = std::move(data); }
-
-    Data move_data() {
-        Data data;
-        std::swap(_data, data);
-        return data;
+    template <typename T> void set_data(T data) {
+        _data = make<DataOf<T>>(std::move(data));
     }
 
+    Ptr<Data> move_data() { return std::move(_data); }
+
     void uns_data() { _data.reset(); }
 
 private:
+    template <typename T> class DataOf : public Data {
+    public:
+        explicit DataOf(T value_): value{std::move(value_)} {}
+
+        Ptr<Data> copy() const override { return make<DataOf>(value); }
+
+        T value;
+    };
+
+    Ptr<Data> copy_data() const { return _data ? _data->copy() : Ptr<Data>{}; }
+
     TypedValue _typed_value;
     ExprError _error;
     flags_t _flags;
-    Data _data;
+    Ptr<Data> _data;
 };
 
 class ExprResList {
@@ -0,0 +1,54 @@
+#pragma once
+#include <libulam/ast/nodes.hpp>
+#include <libulam/ast/visitor.hpp>
+#include <libulam/memory/ptr.hpp>
+
+namespace ulam::sema {
+
+// Marks operator expressions in a function body that can only produce
+// constant values, i.e. consist of literals, named constants and type
+// operations, by attaching fold caches to them. The evaluator stores the
+// first consteval result of a marked expression and returns its copy
+// instead of re-evaluating the subtree (see EvalExprVisitor::fold).
+// Names cannot be resolved to constants at this point, expressions
+// referring to anything other than a constant are unmarked by the
+// evaluator when they produce a non-consteval result.
+class ConstFolder : public ast::RecVisitor {
+public:
+    using ast::RecVisitor::visit;
+
+    void mark(Ref<ast::FunDef> node);
+
+    void visit(Ref<ast::TypeOpExpr> node) override;
+    void visit(Ref<ast::Ident> node) override;
+    void visit(Ref<ast::ParenExpr> node) override;
+    void visit(Ref<ast::BinaryOp> node) override;
+    void visit(Ref<ast::UnaryOp> node) override;
+    void visit(Ref<ast::Cast> node) override;
+    void visit(Ref<ast::Ternary> node) override;
+    void visit(Ref<ast::BoolLit> node) override;
+    void visit(Ref<ast::NumLit> node) override;
+    void visit(Ref<ast::StrLit> node) override;
+    void visit(Ref<ast::ClassConstAccess> node) override;
+
+private:
+    enum class Shape {
+        None,    // not constant
+        CtxFree, // literals only
+        Named    // refers to names or types, depends on class context
+    };
+
+    // visits node, returns its shape
+    Shape shape(Ref<ast::Expr> node);
+
+    void set_shape(Ref<ast::Expr> node, Shape shape);
+    void mark(Ref<ast::Expr> node, Shape shape);
+
+    static Shape combine(Shape shape1, Shape shape2);
+
+    // last expression shape was set for
+    Ref<ast::Expr> _node{};
+    Shape _shape{Shape::None};
+};
+
+} // namespace ulam::sema
@@ -0,0 +1,54 @@
+#pragma once
+#include <libulam/ast/nodes.hpp>
+#include <libulam/ast/visitor.hpp>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/scope/slot.hpp>
+#include <libulam/str_pool.hpp>
+#include <utility>
+#include <vector>
+
+namespace ulam::sema {
+
+// Assigns call frame slots to function parameters and local variables and
+// binds identifiers to slots of variables they refer to, so the evaluator
+// can load locals by index instead of searching scopes by name.
+// Slots are unique within a function. Names that can be resolved to
+// something other than a slotted variable (local constants, `as` condition
+// variables) remain unbound and are looked up in scope. Loops that define
+// nothing in scope are marked so that iterations can skip creating one.
+class LocalResolver : public ast::RecVisitor {
+public:
+    using ast::RecVisitor::visit;
+
+    void resolve(Ref<ast::FunDef> node);
+
+    void visit(Ref<ast::FunDefBody> node) override;
+    void visit(Ref<ast::Block> node) override;
+    void visit(Ref<ast::TypeDef> node) override;
+    void visit(Ref<ast::If> node) override;
+    void visit(Ref<ast::For> node) override;
+    void visit(Ref<ast::While> node) override;
+    void visit(Ref<ast::WhichCase> node) override;
+    void visit(Ref<ast::VarDefList> node) override;
+    void visit(Ref<ast::Ident> node) override;
+    void visit(Ref<ast::MemberAccess> node) override;
+    void visit(Ref<ast::ClassConstAccess> node) override;
+
+private:
+    // {name ID, slot}, NoLocalSlot for unbound name
+    using Name = std::pair<str_id_t, local_slot_t>;
+
+    void visit_branch(Ref<ast::Stmt> node, Ref<ast::Cond> cond);
+
+    void add_var(Ref<ast::VarDefBase> node);
+    void add_unbound(str_id_t name_id);
+
+    std::size_t block_begin() const { return _names.size(); }
+    void block_end(std::size_t size) { _names.resize(size); }
+
+    std::vector<Name> _names;
+    local_slot_t _slot_num{0};
+    unsigned _scope_def_num{0}; // names defined in scope, see visit(For)
+};
+
+} // namespace ulam::sema
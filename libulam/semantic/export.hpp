@@ -29,6 +29,9 @@ public:
     // returns nullptr on success or conflicting export
     const Export* add(str_id_t name_id, Export exp);
 
+    // removes all symbols exported by module
+    void remove(Ref<const Module> module);
+
 private:
     std::unordered_map<str_id_t, Export> _table;
 };
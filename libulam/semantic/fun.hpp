@@ -6,6 +6,7 @@
 #include <libulam/semantic/ops.hpp>
 #include <libulam/semantic/type.hpp>
 #include <libulam/semantic/type/conv.hpp>
+#include <libulam/semantic/type/key.hpp>
 #include <libulam/semantic/typed_value.hpp>
 #include <libulam/str_pool.hpp>
 #include <list>
@@ -13,6 +14,7 @@
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace ulam::ast {
 class FunDef;
@@ -22,10 +24,15 @@ class Param;
 class ParamList;
 } // namespace ulam::ast
 
+namespace ulam::sema {
+struct NativeFun;
+}
+
 namespace ulam {
 
 class Class;
 class Diag;
+class FunCode;
 class FunSet;
 class Mangler;
 class PersScope;
@@ -34,15 +41,19 @@ class Type;
 class Var;
 
 class Fun : public Def {
+    friend Class;
     friend FunSet;
 
 public:
     using Params = std::list<Ref<Var>>;
+    using vslot_t = std::uint32_t;
+    static constexpr vslot_t NoVSlot = -1;
     enum MatchStatus { NoMatch, IsMatch, ExactMatch };
     using MatchRes = std::pair<MatchStatus, conv_cost_t>;
 
     Fun(UniqStrPool& str_pool,
         Mangler& mangler,
+        TypeKeyTable& type_keys,
         Scope* scope,
         Ref<ast::FunDef> node);
     ~Fun();
@@ -63,10 +74,21 @@ public:
 
     bool is_pure_virtual() const;
 
+    // virtual table slot, shared by overrides (see Class::init_vtable)
+    bool has_vslot() const { return _vslot != NoVSlot; }
+    vslot_t vslot() const { return _vslot; }
+    // function that added the slot
+    Ref<const Fun> vslot_fun() const { return _vslot_fun; }
+
     bool is_marked_virtual() const;
 
     bool is_native() const;
 
+    // host implementation, looked up once (see sema::NativeRegistry::bind)
+    bool is_native_bound() const { return _is_native_bound; }
+    Ref<const sema::NativeFun> native() const { return _native; }
+    void set_native(Ref<const sema::NativeFun> native);
+
     bool has_ellipsis() const;
 
     Ref<Type> ret_type() { return _ret_type; }
@@ -86,6 +108,10 @@ public:
 
     Ref<Fun> find_override(Ref<const Class> cls);
 
+    // function to call on object of dynamic class `dyn_cls':
+    // looks up virtual table of the class
+    Ref<Fun> dispatch(Ref<const Class> dyn_cls);
+
     Ref<PersScope> scope();
     Ref<PersScope> param_scope() { return ref(_param_scope); }
 
@@ -94,6 +120,11 @@ public:
     Ref<ast::ParamList> params_node() const;
     Ref<ast::FunDefBody> body_node() const;
 
+    // bytecode compiled on first call with effective class
+    // (see sema::EvalCompiler), null if not compiled yet
+    Ref<FunCode> code(Ref<const Class> eff_cls);
+    Ref<FunCode> add_code(Ptr<FunCode>&& code);
+
 private:
     void add_override(Ref<Fun> fun, Ref<Class> cls);
 
@@ -103,16 +134,26 @@ private:
 
     std::string mangled_param_types() const;
 
+    // interned key of parameter types, computed once params are resolved
+    type_key_id_t param_types_key() const;
+
     UniqStrPool& _str_pool;
     Mangler& _mangler;
+    TypeKeyTable& _type_keys;
     Ptr<PersScope> _param_scope;
     Ref<ast::FunDef> _node;
     Ref<Type> _ret_type{};
     Params _params{};
     bool _is_virtual{false};
+    vslot_t _vslot{NoVSlot};
+    Ref<const Fun> _vslot_fun{};
     Ref<Fun> _overridden{};
     std::map<type_id_t, Ref<Fun>> _overrides;
     mutable std::string _mangled_name;
+    mutable type_key_id_t _param_types_key{NoTypeKeyId};
+    std::vector<Ptr<FunCode>> _codes; // by effective class
+    Ref<const sema::NativeFun> _native{};
+    bool _is_native_bound{false};
 };
 
 class FunSet : public Def {
@@ -133,6 +174,9 @@ public:
     Matches find_match(Ref<const Class> dyn_cls, const TypedValueRefList& args);
     Matches find_match(const TypedValueRefList& args);
 
+    // final overrides of matching functions
+    static Matches dispatch(const Matches& matches, Ref<const Class> dyn_cls);
+
     void add(Ptr<Fun>&& fun);
     void add(Ref<Fun> fun);
 
@@ -147,7 +191,7 @@ public:
     void merge(Ref<FunSet> other, Ref<Class> cls, Ref<Class> from_cls = {});
 
 private:
-    using ParamTypeMap = std::unordered_map<std::string, Ref<Fun>>;
+    using ParamTypeMap = std::unordered_map<type_key_id_t, Ref<Fun>>;
 
     str_id_t _name_id;
     FunList _funs;
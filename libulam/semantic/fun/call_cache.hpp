@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/type.hpp>
+#include <libulam/semantic/typed_value.hpp>
+#include <vector>
+
+namespace ulam {
+
+class Fun;
+class FunSet;
+
+// Call site cache of overload resolution results, maps function set and
+// argument types to matching function; result does not depend on dynamic
+// class, virtual calls are dispatched separately (see Fun::dispatch)
+class FunCallCache {
+public:
+    static constexpr std::size_t MaxSize = 4;
+
+    struct Stats {
+        std::atomic<std::size_t> hits{0};
+        std::atomic<std::size_t> misses{0};
+        std::atomic<std::size_t> uncacheable{0};
+    };
+
+    FunCallCache() {}
+
+    FunCallCache(const FunCallCache&) = delete;
+    FunCallCache& operator=(const FunCallCache&) = delete;
+
+    // arguments with consteval values are not cacheable: conversion cost
+    // of a constant depends on its value
+    static bool is_cacheable(const TypedValueRefList& args);
+
+    Ref<Fun> get(Ref<FunSet> fset, const TypedValueRefList& args);
+
+    void add(Ref<FunSet> fset, const TypedValueRefList& args, Ref<Fun> fun);
+
+    std::size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+    static const Stats& stats() { return _stats; }
+
+private:
+    // {type ID, is tmp value}
+    using ArgKey = std::pair<type_id_t, bool>;
+
+    struct Entry {
+        Ref<FunSet> fset;
+        std::vector<ArgKey> args;
+        Ref<Fun> fun;
+    };
+
+    static ArgKey arg_key(const TypedValue& arg);
+
+    std::vector<Entry> _entries;
+
+    static Stats _stats;
+};
+
+} // namespace ulam
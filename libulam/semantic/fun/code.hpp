@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/ops.hpp>
+#include <libulam/semantic/type.hpp>
+#include <libulam/semantic/typed_value.hpp>
+#include <vector>
+
+namespace ulam::ast {
+class FunCall;
+class Node;
+} // namespace ulam::ast
+
+namespace ulam {
+
+class Class;
+class FunSet;
+class Type;
+
+// Function body compiled to register bytecode (see sema::EvalCompiler,
+// sema::EvalVm). Registers hold typed values, first registers are function
+// locals indexed by local slot, followed by temporaries.
+class FunCode {
+public:
+    using reg_t = std::uint16_t;
+    using idx_t = std::uint32_t;
+
+    static constexpr reg_t NoReg = -1;
+
+    // code is disabled after this many fallbacks to tree-walking evaluator
+    static constexpr unsigned MaxDeopts = 8;
+
+    enum class Opcode : std::uint8_t {
+        Const,       // a = consts[idx]
+        Move,        // a = b
+        InitDefault, // local a = default value of types[idx]
+        Init,        // local a = b, cast to types[idx]
+        Assign,      // local a = b
+        BinaryOp,    // a = b op c
+        UnaryOp,     // a = op b
+        IncDec,      // op local b
+        Cast,        // a = (types[idx]) b
+        Jump,        // goto idx
+        JumpIfFalse, // if (!b) goto idx
+        JumpIfTrue,  // if (b) goto idx
+        LoopInit,    // reset loop counter a
+        LoopCheck,   // increment loop counter a, throw if over limit
+        Call,        // a = calls[idx]
+        Return,      // return b
+        ReturnVoid,  // return
+        End          // end of function body
+    };
+
+    struct Instr {
+        Opcode opcode;
+        Op op{Op::None};
+        reg_t a{NoReg};
+        reg_t b{NoReg};
+        reg_t c{NoReg};
+        idx_t idx{0};
+        Ref<ast::Node> node{}; // for diagnostics
+    };
+
+    struct Call {
+        Ref<ast::FunCall> node;
+        Ref<FunSet> fset;
+        std::vector<reg_t> args;
+    };
+
+    struct Stats {
+        std::atomic<std::size_t> compiled{0};
+        std::atomic<std::size_t> unsupported{0};
+        std::atomic<std::size_t> runs{0};
+        std::atomic<std::size_t> deopts{0};
+    };
+
+    explicit FunCode(Ref<Class> eff_cls);
+    ~FunCode();
+
+    FunCode(const FunCode&) = delete;
+    FunCode& operator=(const FunCode&) = delete;
+
+    Ref<Class> eff_cls() const { return _eff_cls; }
+
+    // compares type IDs: after program update (see sema::update) a different
+    // class can be allocated at the same address
+    bool is_for(Ref<const Class> eff_cls) const;
+
+    bool is_disabled() const {
+        return _is_disabled.load(std::memory_order_relaxed);
+    }
+
+    void set_compiled();
+    void set_unsupported();
+
+    // registers a fallback, disables code after MaxDeopts
+    void add_deopt();
+
+    void add_run();
+
+    // registers below are locals
+    reg_t local_num() const { return _local_num; }
+    void set_local_num(reg_t local_num) { _local_num = local_num; }
+
+    reg_t reg_num() const { return _reg_num; }
+    void set_reg_num(reg_t reg_num) { _reg_num = reg_num; }
+
+    unsigned loop_num() const { return _loop_num; }
+    unsigned add_loop() { return _loop_num++; }
+
+    const std::vector<Instr>& instrs() const { return _instrs; }
+    Instr& instr(idx_t idx) { return _instrs[idx]; }
+    idx_t add(Instr instr);
+    idx_t next_idx() const { return _instrs.size(); }
+
+    const TypedValue& constant(idx_t idx) const { return _consts[idx]; }
+    idx_t add_const(TypedValue&& tv);
+
+    Ref<Type> type(idx_t idx) const { return _types[idx]; }
+    idx_t add_type(Ref<Type> type);
+
+    const Call& call(idx_t idx) const { return _calls[idx]; }
+    idx_t add_call(Call&& call);
+
+    static const Stats& stats() { return _stats; }
+
+private:
+    Ref<Class> _eff_cls;
+    type_id_t _eff_cls_id;
+    // updated by concurrent callers, see sim::Sim
+    std::atomic<bool> _is_disabled{false};
+    std::atomic<unsigned> _deopt_num{0};
+    reg_t _local_num{0};
+    reg_t _reg_num{0};
+    unsigned _loop_num{0};
+    std::vector<Instr> _instrs;
+    std::vector<TypedValue> _consts;
+    std::vector<Ref<Type>> _types;
+    std::vector<Call> _calls;
+
+    static Stats _stats;
+};
+
+} // namespace ulam
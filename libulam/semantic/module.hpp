@@ -88,6 +88,13 @@ public:
     // TODO: get name_id from symbol def
     void add_import(str_id_t name_id, const Export& exp);
 
+    // names of modules this module imports symbols from
+    const std::set<str_id_t>& deps() const { return _deps; }
+    // names of modules this module imports class templates from
+    const std::set<str_id_t>& tpl_deps() const { return _tpl_deps; }
+
+    void add_dep(Ref<Module> module, bool is_tpl = false);
+
 private:
     template <typename T> Symbol* set(str_id_t name_id, Ref<T> value) {
         return _symbols.set(name_id, value);
@@ -101,6 +108,7 @@ private:
     Ptr<ModuleScope> _scope;
     SymbolTable _symbols;
     std::set<str_id_t> _deps;
+    std::set<str_id_t> _tpl_deps;
     ClassList _classes;
     ClassTplList _class_tpls;
 };
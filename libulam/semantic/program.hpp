@@ -3,8 +3,10 @@
 #include <libulam/diag.hpp>
 #include <libulam/memory/ptr.hpp>
 #include <libulam/options.hpp>
+#include <libulam/sema/eval/native.hpp>
 #include <libulam/sema/eval/options.hpp>
 #include <libulam/semantic/export.hpp>
+#include <libulam/semantic/fun.hpp>
 #include <libulam/semantic/mangler.hpp>
 #include <libulam/semantic/module.hpp>
 #include <libulam/semantic/scope/options.hpp>
@@ -13,6 +15,7 @@
 #include <libulam/semantic/type/class/options.hpp>
 #include <libulam/semantic/type/class/registry.hpp>
 #include <libulam/semantic/type/element.hpp>
+#include <libulam/semantic/type/key.hpp>
 #include <libulam/src_man.hpp>
 #include <libulam/str_pool.hpp>
 #include <libulam/types.hpp>
@@ -54,6 +57,13 @@ public:
 
     Mangler& mangler() { return _mangler; }
 
+    TypeKeyTable& type_keys() { return _type_keys; }
+
+    // host implementations of native functions
+    sema::NativeRegistry& natives() { return _natives; }
+
+    cls_idx_t next_class_idx() { return _class_idx_num++; }
+
     const PathList& include_paths() const;
     const ClassOptions& class_options() const;
     const ScopeOptions& scope_options() const;
@@ -64,6 +74,11 @@ public:
     Ref<Module> module(str_id_t name_id);
     Ref<Module> add_module(Ref<ast::ModuleDef> node);
 
+    // destroys module, its classes and template instances, removes
+    // its exports and registry entries; modules depending on it must
+    // be removed as well (see sema::update)
+    void remove_module(Ref<Module> module);
+
     const ExportTable& exports() { return _exports; }
     const Export* add_export(str_id_t name_id, Export exp);
 
@@ -81,6 +96,9 @@ private:
     ElementRegistry _elements;
     Builtins _builtins;
     Mangler _mangler;
+    TypeKeyTable _type_keys;
+    sema::NativeRegistry _natives;
+    cls_idx_t _class_idx_num{0};
 
     std::list<Ptr<Module>> _module_ptrs;
     std::list<Ref<Module>> _modules;
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+namespace ulam {
+
+// index of local variable in function call frame
+using local_slot_t = std::uint16_t;
+constexpr local_slot_t NoLocalSlot = -1;
+
+} // namespace ulam
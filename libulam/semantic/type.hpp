@@ -12,6 +12,7 @@
 #include <libulam/str_pool.hpp>
 #include <list>
 #include <set>
+#include <unordered_map>
 
 namespace ulam::ast {
 class TypeDef;
@@ -11,6 +11,7 @@
 #include <list>
 #include <map>
 #include <string_view>
+#include <vector>
 
 namespace ulam::ast {
 class ClassDef;
@@ -58,6 +59,9 @@ public:
     cls_id_t class_id() const;
     elt_id_t element_id() const;
 
+    // dense index assigned once ancestors are resolved
+    cls_idx_t index() const { return _idx; }
+
     Ref<Var> add_param(Ptr<Var>&& var) override;
     Ref<AliasType> add_type_def(Ref<ast::TypeDef> node) override;
     Ref<Fun> add_fun(Ref<ast::FunDef> node) override;
@@ -76,6 +80,16 @@ public:
 
     bitsize_t base_off(Ref<const Class> base) const;
 
+    // final override of virtual function, null if function is not in
+    // virtual table of class
+    Ref<Fun> vfun(Ref<const Fun> fun) const {
+        auto vslot = fun->vslot();
+        if (vslot < _vtable.size() &&
+            _vtable[vslot].slot_fun == fun->vslot_fun())
+            return _vtable[vslot].fun;
+        return moved_vfun(fun);
+    }
+
     const auto& parents() const { return _ancestry.parents(); }
     const auto& ancestors() const { return _ancestry.ancestors(); }
 
@@ -154,8 +168,11 @@ private:
     elt_id_t read_element_id(const BitsView data, bitsize_t off = 0);
 
     void add_ancestor(Ref<Class> cls, Ref<ast::TypeName> node);
+    void init_ancestry();
 
     void merge_fsets();
+    void init_vtable();
+    Ref<Fun> moved_vfun(Ref<const Fun> fun) const;
     void init_layout();
     void set_init_bits(Bits&& bits);
 
@@ -166,6 +183,7 @@ private:
 
     cls_id_t _cls_id{NoClassId};
     elt_id_t _elt_id{NoEltId};
+    cls_idx_t _idx{NoClassIdx};
     Ref<ClassTpl> _tpl;
     cls::Ancestry _ancestry;
     std::list<Ref<AliasType>> _type_defs;
@@ -174,6 +192,15 @@ private:
     std::list<Ref<Prop>> _all_props;
     std::map<type_id_t, Ref<Fun>> _convs;
     std::map<str_id_t, Ref<FunSet>> _fsets;
+    // slots of first parent's table are followed by slots added in class
+    // or moved from other parents
+    struct VTableEntry {
+        Ref<const Fun> slot_fun;
+        Ref<Fun> fun;
+    };
+    std::vector<VTableEntry> _vtable;
+    // slots taken by other functions, see init_vtable
+    std::map<Ref<const Fun>, Fun::vslot_t> _vslots_moved;
     Bits _init_bits;
     mutable std::string _full_name;
     mutable std::string _mangled_name;
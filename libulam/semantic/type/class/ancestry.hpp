@@ -1,8 +1,10 @@
 #pragma once
 #include <libulam/memory/ptr.hpp>
 #include <libulam/semantic/type.hpp>
+#include <cstdint>
 #include <libulam/semantic/value/types.hpp>
 #include <map>
+#include <vector>
 
 namespace ulam {
 class Class;
@@ -59,7 +61,7 @@ class Ancestry {
 public:
     bool add(Ref<Class> cls, Ref<ast::TypeName> node);
     bool add_implicit(Ref<Class> cls); // implicit base (UrSelf)
-    void init();
+    void init(); // ancestors must have class indices assigned
 
     bool is_base(Ref<const Class> cls) const;
 
@@ -74,14 +76,34 @@ public:
     const auto& ancestors() const { return _ancestors; }
 
 private:
+    using word_t = std::uint64_t;
+    static constexpr unsigned WordSize = sizeof(word_t) * 8;
+
     std::pair<Ref<Ancestor>, bool>
     do_add(Ref<Class> cls, Ref<ast::TypeName> node);
 
+    void init_bits();
+
+    // position of ancestor in `_offs'
+    unsigned rank(cls_idx_t idx) const {
+        auto bit = idx % WordSize;
+        auto mask = (word_t{1} << bit) - 1;
+        return _ranks[idx / WordSize] +
+               __builtin_popcountll(_bits[idx / WordSize] & mask);
+    }
+
     std::map<type_id_t, Ref<Ancestor>> _map;
     std::map<str_id_t, Ref<Ancestor>> _name_id_map;
     std::vector<Ref<Ancestor>> _parents;
     std::vector<Ref<Ancestor>> _ancestors;
     std::vector<Ptr<Ancestor>> _ancestor_ptrs;
+    // set of ancestor class indices (see Class::index), built by init;
+    // `_ranks[n]' is number of ancestors in preceding words, data offsets
+    // are stored in class index order
+    bool _has_bits{false};
+    std::vector<word_t> _bits;
+    std::vector<unsigned> _ranks;
+    std::vector<bitsize_t> _offs;
 };
 
 } // namespace ulam::cls
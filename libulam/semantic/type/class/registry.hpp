@@ -9,14 +9,19 @@ class Class;
 
 class ClassRegistry {
 public:
+    // returns NoClassId if all IDs are taken
     cls_id_t add(Ref<Class> cls);
 
     Ref<Class> get(cls_id_t id) const;
 
+    // slot of removed class is empty until its ID is reused
+    void remove(Ref<Class> cls);
+
     const auto& list() const { return _classes; }
 
 private:
     std::vector<Ref<Class>> _classes;
+    std::vector<cls_id_t> _free_ids;
 };
 
 } // namespace ulam
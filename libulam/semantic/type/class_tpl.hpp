@@ -4,6 +4,7 @@
 #include <libulam/semantic/def.hpp>
 #include <libulam/semantic/type.hpp>
 #include <libulam/semantic/type/class/base.hpp>
+#include <libulam/semantic/type/key.hpp>
 #include <libulam/semantic/type_tpl.hpp>
 #include <libulam/str_pool.hpp>
 #include <list>
@@ -72,13 +73,11 @@ protected:
 private:
     Ptr<Class> inst(TypedValueList&& args);
 
-    std::string type_args_str(const TypedValueList& args);
-
     Ref<Program> program();
 
     Ref<ast::ClassDef> _node;
     std::list<Ref<Class>> _classes;
-    std::unordered_map<std::string, Ptr<Class>> _class_map;
+    std::unordered_map<type_key_id_t, Ptr<Class>> _class_map;
     std::list<Member> _ordered_members;
 
     std::string_view _name;
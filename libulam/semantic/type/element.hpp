@@ -12,13 +12,18 @@ class ElementRegistry {
 public:
     ElementRegistry(const ClassOptions& class_options);
 
+    // returns NoEltId for non-Empty element if all IDs are taken
     elt_id_t add(Ref<Class> cls);
 
     Ref<Class> get(elt_id_t id) const;
 
+    // slot of removed element is empty until its ID is reused
+    void remove(Ref<Class> cls);
+
 private:
     const ClassOptions& _class_options;
     std::vector<Ref<Class>> _elements;
+    std::vector<elt_id_t> _free_ids;
 };
 
 } // namespace ulam
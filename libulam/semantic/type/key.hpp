@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <libulam/semantic/type.hpp>
+#include <libulam/semantic/typed_value.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace ulam {
+
+class RValue;
+
+using type_key_id_t = std::uint32_t;
+constexpr type_key_id_t NoTypeKeyId = -1;
+
+// Structural key of type list or template argument list: canonical type IDs
+// and bits of consteval values. Unlike mangled string (see Mangler), key is
+// built without formatting and is unique only within program.
+class TypeKey {
+public:
+    using word_t = std::uint64_t;
+
+    TypeKey() {}
+    explicit TypeKey(const TypeList& types);
+    explicit TypeKey(const TypedValueList& values);
+
+    TypeKey(TypeKey&&) = default;
+    TypeKey& operator=(TypeKey&&) = default;
+
+    void add(Ref<const Type> type);
+    void add(const TypedValue& tv);
+    void add(const RValue& rval);
+
+    void add_ellipsis();
+
+    bool operator==(const TypeKey& other) const {
+        return _words == other._words;
+    }
+    bool operator!=(const TypeKey& other) const { return !operator==(other); }
+
+    std::size_t hash() const;
+
+private:
+    void add_word(word_t word) { _words.push_back(word); }
+
+    std::vector<word_t> _words;
+};
+
+// Hash-consing table of type keys, equal keys get the same ID
+class TypeKeyTable {
+public:
+    TypeKeyTable() {}
+
+    TypeKeyTable(const TypeKeyTable&) = delete;
+    TypeKeyTable& operator=(const TypeKeyTable&) = delete;
+
+    type_key_id_t id(TypeKey&& key);
+
+    std::size_t size() const { return _ids.size(); }
+
+private:
+    struct Hash {
+        std::size_t operator()(const TypeKey& key) const { return key.hash(); }
+    };
+
+    std::unordered_map<TypeKey, type_key_id_t, Hash> _ids;
+};
+
+} // namespace ulam
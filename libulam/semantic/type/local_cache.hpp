@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <libulam/memory/ptr.hpp>
+#include <utility>
+#include <vector>
+
+namespace ulam {
+
+class Class;
+class Type;
+class UserType;
+
+// Cache of types resolved by local variable and type definitions in
+// function bodies. Function AST is shared by class template instances,
+// so entries are keyed by {self class, effective class}.
+// Local alias types are owned by the cache, which makes them usable as
+// cached variable types.
+class LocalTypeCache {
+public:
+    static constexpr std::size_t MaxSize = 8;
+
+    struct Stats {
+        std::atomic<std::size_t> hits{0};
+        std::atomic<std::size_t> misses{0};
+    };
+
+    LocalTypeCache();
+    ~LocalTypeCache();
+
+    LocalTypeCache(const LocalTypeCache&) = delete;
+    LocalTypeCache& operator=(const LocalTypeCache&) = delete;
+
+    Ref<Type> get(Ref<const Class> self_cls, Ref<const Class> eff_cls);
+
+    void add(Ref<const Class> self_cls, Ref<const Class> eff_cls, Ref<Type> type);
+
+    // stores local alias type, returns ref to it; not limited by MaxSize,
+    // so that types of variables referring to cached aliases stay valid
+    Ref<UserType> add(
+        Ref<const Class> self_cls,
+        Ref<const Class> eff_cls,
+        Ptr<UserType>&& type);
+
+    std::size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+    static const Stats& stats() { return _stats; }
+
+private:
+    // {self class, effective class}
+    using Key = std::pair<Ref<const Class>, Ref<const Class>>;
+
+    struct Entry {
+        Key key;
+        Ref<Type> type;
+    };
+
+    std::vector<Entry> _entries;
+    std::vector<Ptr<UserType>> _types;
+
+    static Stats _stats;
+};
+
+} // namespace ulam
@@ -1,5 +1,6 @@
 #pragma once
-#include <functional>
+#include <atomic>
+#include <cstddef>
 #include <libulam/semantic/value/types.hpp>
 #include <ostream>
 
@@ -68,9 +69,7 @@ public:
     std::string hex() const;
 
 private:
-    using UnitBinOp = std::function<unit_t(unit_t, unit_t)>;
-
-    void bin_op(const BitsView& other, UnitBinOp op);
+    template <typename Op> void bin_op(const BitsView& other, Op op);
 
     Bits& data();
     const Bits& data() const;
@@ -81,7 +80,16 @@ private:
 };
 
 class Bits : public _Bits {
+    friend BitsView;
+
 public:
+    // dynamic storage copying, inline storage is not counted
+    struct Stats {
+        std::atomic<std::size_t> copies{0};
+        std::atomic<std::size_t> shares{0};   // copies avoided by sharing
+        std::atomic<std::size_t> unshares{0}; // shared storage copied on write
+    };
+
     explicit Bits(size_t len = 0);
     ~Bits();
 
@@ -105,6 +113,10 @@ public:
 
     Bits copy() const;
 
+    // copy-on-write copy, dynamic storage is shared until one of the
+    // copies is modified
+    Bits share() const;
+
     bool read_bit(size_t idx) const;
     void write_bit(size_t idx, bool bit);
 
@@ -146,7 +158,11 @@ public:
     void write_hex(std::ostream& out) const;
     std::string hex() const;
 
+    static const Stats& stats() { return _stats; }
+
 private:
+    using ref_num_t = std::atomic<unsigned>;
+
     unit_t read(unit_idx_t unit_idx, size_t start, size_t len) const;
     void write(unit_idx_t unit_idx, size_t start, size_t len, unit_t value);
 
@@ -158,15 +174,27 @@ private:
     bool is_storage_dynamic() const;
     unit_idx_t storage_size() const;
 
+    // dynamic storage is preceded by reference counter
+    static unit_t* alloc_storage(unit_idx_t size);
+    ref_num_t& ref_num() const;
+    void unshare();
+
+    // non-const access copies shared storage
     unit_t* storage();
     const unit_t* storage() const;
 
+    // large enough to store an atom without allocation
+    static constexpr unit_idx_t InlineUnitNum =
+        (AtomSize + UnitSize - 1) / UnitSize;
+
     size_t _len;
 
     union {
-        unit_t array[1];
+        unit_t array[InlineUnitNum];
         unit_t* ptr;
     } _storage;
+
+    static Stats _stats;
 };
 
 } // namespace ulam
@@ -23,6 +23,7 @@ public:
     Data(Data&&) = delete;
     Data& operator=(Data&&) = delete;
 
+    // shares bits storage until modified (copy-on-write)
     DataPtr copy() const;
 
     DataView view();
@@ -101,11 +102,9 @@ private:
     DataPtr _storage{};
     Ref<Type> _type{};
     Ref<Type> _view_type{};
+    Ref<Type> _atom_type{};
     bitsize_t _off{};
-    struct {
-        bitsize_t off{NoBitsize};
-        Ref<Type> type{};
-    } _atom;
+    bitsize_t _atom_off{NoBitsize};
 };
 
 } // namespace ulam
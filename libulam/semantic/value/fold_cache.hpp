@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/typed_value.hpp>
+#include <utility>
+#include <vector>
+
+namespace ulam {
+
+class Class;
+
+// Cache of constant-folded expression results (see sema::ConstFolder).
+// Expressions referring to named constants or types may evaluate
+// differently in different class template instances sharing the same AST,
+// their results are keyed by {self class, effective class}; results of
+// context-free expressions (literals only) are stored under empty key.
+class FoldCache {
+public:
+    static constexpr std::size_t MaxSize = 8;
+
+    struct Stats {
+        std::atomic<std::size_t> hits{0};
+        std::atomic<std::size_t> misses{0};
+        std::atomic<std::size_t> disabled{0};
+    };
+
+    explicit FoldCache(bool is_ctx_free): _is_ctx_free{is_ctx_free} {}
+
+    FoldCache(const FoldCache&) = delete;
+    FoldCache& operator=(const FoldCache&) = delete;
+
+    bool is_ctx_free() const { return _is_ctx_free; }
+
+    // expression turned out to be non-consteval, e.g. an identifier resolved
+    // to a variable, stop caching
+    bool is_disabled() const { return _is_disabled; }
+    void disable();
+
+    // returns copy of cached result, empty if not found
+    TypedValue get(Ref<const Class> self_cls, Ref<const Class> eff_cls);
+
+    // only consteval rvalues are stored
+    void add(
+        Ref<const Class> self_cls,
+        Ref<const Class> eff_cls,
+        const TypedValue& tv);
+
+    std::size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+    static const Stats& stats() { return _stats; }
+
+private:
+    // {self class, effective class}
+    using Key = std::pair<Ref<const Class>, Ref<const Class>>;
+
+    struct Entry {
+        Key key;
+        TypedValue tv;
+    };
+
+    Key key(Ref<const Class> self_cls, Ref<const Class> eff_cls) const {
+        return _is_ctx_free ? Key{} : Key{self_cls, eff_cls};
+    }
+
+    std::vector<Entry> _entries;
+    bool _is_ctx_free;
+    bool _is_disabled{false};
+
+    static Stats _stats;
+};
+
+} // namespace ulam
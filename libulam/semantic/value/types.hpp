@@ -25,6 +25,10 @@ constexpr str_len_t NoStrLen = -1;
 using cls_id_t = std::uint16_t;
 constexpr cls_id_t NoClassId = 0;
 
+// dense index of resolved class, see cls::Ancestry
+using cls_idx_t = std::uint32_t;
+constexpr cls_idx_t NoClassIdx = -1;
+
 using elt_id_t = std::uint16_t;
 constexpr elt_id_t NoEltId = 0;
 
@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/value/types.hpp>
+#include <libulam/sim/event_window.hpp>
+#include <libulam/sim/grid.hpp>
+#include <libulam/sim/options.hpp>
+#include <mutex>
+#include <vector>
+
+namespace ulam {
+class Fun;
+class Program;
+} // namespace ulam
+
+namespace ulam::sim {
+
+struct SimStats {
+    std::size_t events{0};
+    std::size_t failed{0}; // evaluation errors, window is not stored
+    std::chrono::steady_clock::duration duration{};
+
+    double events_per_sec() const;
+};
+
+// Runs `behave()' of elements on grid as a Movable Feast Machine. Events
+// happen at random sites of tiles, each worker thread owns a subset of
+// tiles. An event locks tiles its window overlaps, so events with
+// non-overlapping windows run concurrently. Binds `EventWindow.aref(Int)'
+// native unless already bound.
+//
+// Evaluator fills caches (function locals, constant subexpressions, call
+// sites, derived types) on first use, so with multiple threads all
+// class functions are evaluated without execution before workers start,
+// and workers only read the caches (see sema::evl::ReadOnlyCaches).
+class Sim {
+public:
+    Sim(Ref<Program> program,
+        Grid& grid,
+        const SimOptions& options = DefaultSimOptions);
+    ~Sim();
+
+    Sim(const Sim&) = delete;
+    Sim& operator=(const Sim&) = delete;
+
+    Grid& grid() { return _grid; }
+
+    SimStats run(std::size_t event_num);
+
+private:
+    struct Tile {
+        unsigned x;
+        unsigned y;
+        unsigned width;
+        unsigned height;
+        std::mutex mutex;
+    };
+
+    void init_tiles();
+    void init_behave();
+    void prepare();
+
+    void run_worker(
+        unsigned worker,
+        unsigned worker_num,
+        std::size_t event_num,
+        SimStats& stats);
+
+    Ref<Fun> behave(elt_id_t elt_id) const {
+        return elt_id < _behave.size() ? _behave[elt_id] : Ref<Fun>{};
+    }
+
+    Ref<Program> _program;
+    Grid& _grid;
+    SimOptions _options;
+    unsigned _tiles_x{0};
+    std::vector<Ptr<Tile>> _tiles;
+    std::vector<Ref<Fun>> _behave; // by element ID
+    bool _prepared{false};
+};
+
+} // namespace ulam::sim
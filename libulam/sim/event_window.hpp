@@ -0,0 +1,48 @@
+#pragma once
+#include <bitset>
+#include <libulam/semantic/value.hpp>
+#include <libulam/semantic/value/types.hpp>
+
+namespace ulam {
+class Builtins;
+}
+
+namespace ulam::sim {
+
+class Grid;
+
+// MFM event window: active site (0) and sites within Manhattan distance 4,
+// numbered by distance, then by x and y (MFM::MDist orders sites of same
+// distance differently). Atoms are copied from grid into Atom[41] value on
+// load and back on store, sites outside of grid are Empty and not stored.
+class EventWindow {
+public:
+    static constexpr int Radius = 4;
+    static constexpr array_size_t Size = 41;
+
+    struct Offset {
+        int x;
+        int y;
+    };
+
+    static Offset offset(array_idx_t site);
+
+    // array type must already exist if called in worker thread
+    explicit EventWindow(Builtins& builtins);
+
+    int x() const { return _x; }
+    int y() const { return _y; }
+
+    void load(const Grid& grid, int x, int y);
+    void store(Grid& grid);
+
+    LValue atom(array_idx_t site);
+
+private:
+    RValue _atoms;
+    std::bitset<Size> _live{};
+    int _x{0};
+    int _y{0};
+};
+
+} // namespace ulam::sim
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <libulam/assert.hpp>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/semantic/value/bits.hpp>
+#include <libulam/semantic/value/types.hpp>
+#include <vector>
+
+namespace ulam {
+class Class;
+}
+
+namespace ulam::sim {
+
+// Grid of atoms, each site is stored in its own (inline) Bits, so events
+// in different tiles never write to shared storage units. New grid is
+// filled with Empty atoms (zero bits).
+class Grid {
+public:
+    Grid(unsigned width, unsigned height);
+
+    unsigned width() const { return _width; }
+    unsigned height() const { return _height; }
+    std::size_t size() const { return _sites.size(); }
+
+    bool has(int x, int y) const {
+        return x >= 0 && y >= 0 && (unsigned)x < _width &&
+               (unsigned)y < _height;
+    }
+
+    Bits& site(unsigned x, unsigned y) { return _sites[idx(x, y)]; }
+    const Bits& site(unsigned x, unsigned y) const {
+        return _sites[idx(x, y)];
+    }
+
+    elt_id_t element_id(unsigned x, unsigned y) const;
+
+    // places default atom of element
+    void set(unsigned x, unsigned y, Ref<Class> elt);
+    void clear(unsigned x, unsigned y);
+
+    std::size_t count(elt_id_t elt_id) const;
+
+private:
+    std::size_t idx(unsigned x, unsigned y) const {
+        ulam_assert(x < _width && y < _height);
+        return (std::size_t)y * _width + x;
+    }
+
+    unsigned _width;
+    unsigned _height;
+    std::vector<Bits> _sites;
+};
+
+} // namespace ulam::sim
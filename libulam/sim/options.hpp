@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+namespace ulam::sim {
+
+struct SimOptions {
+    // worker threads, tiles are distributed between workers
+    unsigned threads{1};
+    // grid is split into square tiles of this size (in sites)
+    unsigned tile_size{32};
+    // seed of per-worker random number generators
+    std::uint64_t seed{0};
+};
+
+constexpr SimOptions DefaultSimOptions{};
+
+} // namespace ulam::sim
@@ -22,25 +22,46 @@ public:
 
     const mem::BufRef line(linum_t linum);
 
+    // number of line containing character at offset
+    linum_t linum_at(std::size_t off);
+
     const src_id_t id() const { return _id; }
     const std::filesystem::path& path() const { return _path; }
 
 private:
+    // indexes lines up to `linum`, all lines if `linum` is 0
+    void index_lines(linum_t linum);
+
     src_id_t _id;
     std::filesystem::path _path;
     std::vector<std::size_t> _line_off; // line offsets, starting from 2nd line
+    bool _is_indexed{false};
 };
 
+// File contents are memory-mapped where supported; trailing \0 is then
+// provided by zero-filled remainder of last page, so files of size that
+// is a multiple of page size are read into buffer instead.
 class FileSrc : public Src {
 public:
     FileSrc(src_id_t id, std::filesystem::path path):
         Src{id, path}, _path{path} {}
+    ~FileSrc();
+
+    FileSrc(const FileSrc&) = delete;
+    FileSrc& operator=(const FileSrc&) = delete;
 
     const mem::BufRef content() override;
 
+    bool is_mapped() const { return _map; }
+
 private:
+    bool map();
+    void unmap();
+
     std::filesystem::path _path;
     std::optional<mem::Buf> _buf;
+    void* _map{};
+    std::size_t _map_size{0};
 };
 
 class StrSrc : public Src {
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace ulam {
@@ -10,19 +11,21 @@ using chr_t = std::uint32_t;
 
 constexpr loc_id_t NoLocId = -1;
 
+// NOTE: location IDs are offsets in location space shared by all sources,
+// see SrcMan::loc_id
 class SrcLoc {
 public:
-    SrcLoc(src_id_t src_id, const char* ptr, linum_t linum, chr_t chr):
-        _src_id{src_id}, _ptr{ptr}, _linum{linum}, _chr{chr} {}
+    SrcLoc(src_id_t src_id, std::size_t off, linum_t linum, chr_t chr):
+        _src_id{src_id}, _off{off}, _linum{linum}, _chr{chr} {}
 
     src_id_t src_id() const { return _src_id; }
-    const char* ptr() const { return _ptr; } // TMP
+    std::size_t off() const { return _off; }
     linum_t linum() const { return _linum; }
     chr_t chr() const { return _chr; }
 
 private:
     src_id_t _src_id;
-    const char* _ptr;
+    std::size_t _off;
     linum_t _linum;
     chr_t _chr;
 };
@@ -4,7 +4,9 @@
 #include <libulam/src_loc.hpp>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace ulam {
@@ -15,7 +17,7 @@ class SrcMan {
 public:
     using Path = std::filesystem::path;
 
-    SrcMan() {}
+    SrcMan(): _mutex{std::make_unique<std::recursive_mutex>()} {}
 
     SrcMan(SrcMan&&) = default;
     SrcMan& operator=(SrcMan&&) = default;
@@ -26,7 +28,10 @@ public:
     Src* src(src_id_t src_id);
     Src* src(const Path& path);
 
-    loc_id_t loc_id(src_id_t src_id, const char* ptr, linum_t linum, chr_t chr);
+    // Each source is assigned a range in location space when first location
+    // in it is requested, location ID is range start + offset in source.
+    // Line and column are computed from location ID on demand.
+    loc_id_t loc_id(src_id_t src_id, const char* ptr);
     SrcLoc loc(loc_id_t loc_id);
 
     std::string_view str_at(const SrcLoc& loc, std::size_t size, int off = 0);
@@ -35,10 +40,25 @@ public:
     std::string_view line_at(const SrcLoc& loc);
     std::string_view line_at(loc_id_t loc_id);
 
+    // finds source and offset in it by location ID
+    std::pair<Src*, std::size_t> src_off(loc_id_t loc_id);
+
+    // sources and locations are accessed under lock while enabled, e.g.
+    // when preprocessor runs in a separate thread (see Parser)
+    void set_locking(bool locking) { _locking = locking; }
+
 private:
+    std::unique_lock<std::recursive_mutex> lock();
+
+    Src* add(std::unique_ptr<Src>&& src);
+
     std::vector<std::unique_ptr<Src>> _srcs;
     std::map<Path, Src*> _src_map;
-    std::vector<SrcLoc> _locs;
+    std::vector<loc_id_t> _loc_starts; // location range starts by source ID
+    std::vector<std::pair<loc_id_t, src_id_t>> _loc_srcs; // ordered by start
+    loc_id_t _loc_end{0};
+    std::unique_ptr<std::recursive_mutex> _mutex;
+    bool _locking{false};
 };
 
 } // namespace ulam
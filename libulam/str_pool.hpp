@@ -1,13 +1,29 @@
 #pragma once
+#include <cstdint>
 #include <libulam/memory/notepad.hpp>
-#include <unordered_map>
-#include <vector>
+#include <libulam/str_pool/id_map.hpp>
+#include <libulam/str_pool/index.hpp>
+#include <mutex>
+#include <string_view>
+
+// 16-bit string ids limit pools to 65535 strings; String values are
+// stored in 18-bit data (as in ULAM), so ids of strings used at runtime
+// are limited to 2^18 - 1 (see StringType::to_datum)
+#ifndef ULAM_STR_ID_32
+#    define ULAM_STR_ID_32 1
+#endif
 
 namespace ulam {
 
+#if ULAM_STR_ID_32
+using str_id_t = std::uint32_t;
+#else
 using str_id_t = std::uint16_t;
+#endif
 constexpr str_id_t NoStrId = -1;
 
+// Strings can be read and looked up while pool is written to;
+// writes are serialized
 class StrPoolBase {
 public:
     StrPoolBase() {}
@@ -26,8 +42,9 @@ protected:
 
     PairT store(const std::string_view str, bool copy);
 
+    std::mutex _store_mutex;
     mem::Notepad _notepad;
-    std::vector<std::string_view> _index;
+    StrIndex _index;
 };
 
 class UniqStrPool : public StrPoolBase {
@@ -41,10 +58,14 @@ public:
     const std::string_view get(str_id_t id) const override;
 
 private:
+    using hash_t = StrIdMap::hash_t;
+
+    str_id_t id(const std::string_view str, hash_t hash) const;
+
     UniqStrPool* _parent;
     str_id_t _offset{0};
     bool _is_locked{false}; // marks parent pool as locked (assert check only)
-    std::unordered_map<std::string_view, str_id_t> _map;
+    StrIdMap _map;
 };
 
 class StrPool : public StrPoolBase {
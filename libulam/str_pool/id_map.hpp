@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <libulam/memory/ptr.hpp>
+#include <libulam/str_pool/index.hpp>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace ulam {
+
+// Open addressing map of strings to their indices in StrIndex. Slots keep
+// string hashes, so strings are only compared on hash match and tables are
+// grown without rehashing. Split into shards with separate write locks,
+// lookups do not lock: grown tables are kept until the map is destroyed.
+class StrIdMap {
+public:
+    using hash_t = std::uint32_t;
+    using idx_t = std::uint32_t;
+
+    static constexpr idx_t NoIdx = -1;
+
+    explicit StrIdMap(const StrIndex& index);
+
+    StrIdMap(const StrIdMap&) = delete;
+    StrIdMap& operator=(const StrIdMap&) = delete;
+
+    static hash_t hash(std::string_view str);
+
+    idx_t find(std::string_view str, hash_t hash) const;
+
+    // locks shard for writing
+    std::unique_lock<std::mutex> lock(hash_t hash);
+
+    // shard must be locked, string must not be in map
+    void add(hash_t hash, idx_t idx);
+
+private:
+    static constexpr unsigned ShardBits = 4;
+    static constexpr unsigned ShardNum = 1 << ShardBits;
+    static constexpr std::size_t FirstTableSize = 16;
+
+    class Table {
+    public:
+        explicit Table(std::size_t size);
+
+        std::size_t capacity() const { return _mask + 1; }
+
+        std::size_t size() const { return _size; }
+
+        // slot value: hash << 32 | (idx + 1), 0 for empty slot
+        std::uint64_t slot(std::size_t pos) const {
+            return _slots[pos & _mask].load(std::memory_order_acquire);
+        }
+
+        void add(std::uint64_t value);
+
+    private:
+        std::size_t _mask;
+        std::size_t _size{0};
+        std::unique_ptr<std::atomic<std::uint64_t>[]> _slots;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::atomic<Table*> table{};
+        std::vector<Ptr<Table>> tables; // current table is last
+    };
+
+    static unsigned shard_idx(hash_t hash) {
+        return hash >> (sizeof(hash_t) * 8 - ShardBits);
+    }
+
+    const StrIndex& _index;
+    std::array<Shard, ShardNum> _shards;
+};
+
+} // namespace ulam
@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+
+namespace ulam {
+
+// Append-only list of strings that can be read while appended to:
+// chunk sizes double, so stored items never move
+class StrIndex {
+public:
+    StrIndex();
+    ~StrIndex();
+
+    StrIndex(const StrIndex&) = delete;
+    StrIndex& operator=(const StrIndex&) = delete;
+
+    std::size_t size() const { return _size.load(std::memory_order_acquire); }
+
+    std::string_view get(std::size_t idx) const;
+
+    // appends are not synchronized, returns index
+    std::size_t push_back(std::string_view str);
+
+private:
+    static constexpr unsigned FirstChunkBits = 8;
+    static constexpr unsigned ChunkNum = sizeof(std::size_t) * 8 - FirstChunkBits;
+
+    // returns chunk number and offset in chunk
+    static std::pair<unsigned, std::size_t> locate(std::size_t idx);
+
+    static constexpr std::size_t chunk_size(unsigned chunk) {
+        return std::size_t{1} << (FirstChunkBits + chunk);
+    }
+
+    std::array<std::atomic<std::string_view*>, ChunkNum> _chunks;
+    std::atomic<std::size_t> _size{0};
+};
+
+} // namespace ulam
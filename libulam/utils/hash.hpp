@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace ulam::utils {
+
+constexpr std::uint64_t HashSeed = 0xcbf29ce484222325ULL;
+
+// 64-bit FNV-1a, not suitable for untrusted input
+inline std::uint64_t
+hash(const std::string_view str, std::uint64_t seed = HashSeed) {
+    std::uint64_t hash = seed;
+    for (unsigned char ch : str) {
+        hash ^= ch;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} // namespace ulam::utils
@@ -1,9 +1,34 @@
+#include <cstddef>
 #include <libulam/ast/node.hpp>
+#include <new>
 
 namespace ulam::ast {
 
+namespace {
+// keeps arena node is allocated in
+constexpr std::size_t HeaderSize = alignof(std::max_align_t);
+static_assert(sizeof(Ref<mem::Arena>) <= HeaderSize);
+} // namespace
+
 Node::~Node() {}
 
+void* Node::operator new(std::size_t size) {
+    auto arena = mem::Arena::current();
+    auto data = static_cast<char*>(
+        arena ? arena->alloc(HeaderSize + size)
+              : ::operator new(HeaderSize + size));
+    new (data) Ref<mem::Arena>{arena};
+    return data + HeaderSize;
+}
+
+void Node::operator delete(void* ptr) {
+    if (!ptr)
+        return;
+    auto data = static_cast<char*>(ptr) - HeaderSize;
+    if (!*reinterpret_cast<Ref<mem::Arena>*>(data))
+        ::operator delete(data);
+}
+
 void Node::accept(Visitor& v) { v.visit(this); }
 
 } // namespace ulam::ast
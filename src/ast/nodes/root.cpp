@@ -6,8 +6,13 @@ namespace ulam::ast {
 
 // Root
 
-Root::Root() {}
-Root::~Root() {} // for Program destructor
+Root::Root(bool use_arena): _ctx{use_arena} {}
+
+Root::~Root() {
+    // destroy program and modules before arena
+    set_program({});
+    clear();
+}
 
 bool Root::has_module(str_id_t name_id) const { return _name_id_map.has(name_id); }
 
@@ -17,4 +22,17 @@ void Root::add_module(Ptr<ModuleDef>&& mod) {
     add(std::move(mod));
 }
 
+Ptr<ModuleDef> Root::replace_module(Ptr<ModuleDef>&& mod) {
+    auto name_id = mod->name_id();
+    for (unsigned n = 0; n < child_num(); ++n) {
+        if (get(n)->name_id() != name_id)
+            continue;
+        if (_name_id_map.has(name_id))
+            _name_id_map.replace(name_id, ref(mod));
+        return replace(n, std::move(mod));
+    }
+    add_module(std::move(mod));
+    return {};
+}
+
 } // namespace ulam::ast
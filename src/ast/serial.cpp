@@ -0,0 +1,1289 @@
+#include <cstdint>
+#include <filesystem>
+#include <libulam/ast/nodes.hpp>
+#include <libulam/ast/serial.hpp>
+#include <libulam/ast/visitor.hpp>
+#include <libulam/src.hpp>
+#include <libulam/utils/hash.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ulam::ast {
+namespace {
+
+constexpr std::string_view Magic{"ULAMAST", 8}; // including \0
+
+enum Tag : std::uint8_t {
+    NullTag,
+#define NODE(str, cls) cls##Tag,
+#include <libulam/ast/nodes.inc.hpp>
+#undef NODE
+    // not in visitor
+    ClassNameTag,
+    AsCondTag
+};
+
+std::uint64_t content_hash(Src* src) {
+    auto buf = src->content();
+    ulam_assert(buf.size() > 0);
+    return utils::hash({buf.start(), buf.size() - 1}); // without \0
+}
+
+// Output
+
+class Out {
+public:
+    void u8(std::uint8_t val) { _data.push_back((char)val); }
+
+    void uint(std::uint64_t val) {
+        while (val >= 0x80) {
+            u8((val & 0x7f) | 0x80);
+            val >>= 7;
+        }
+        u8(val);
+    }
+
+    void sint(std::int64_t val) {
+        uint(((std::uint64_t)val << 1) ^ (std::uint64_t)(val >> 63));
+    }
+
+    void bytes(std::string_view str) {
+        uint(str.size());
+        _data.append(str);
+    }
+
+    void raw(std::string_view str) { _data.append(str); }
+
+    std::string& data() { return _data; }
+
+private:
+    std::string _data;
+};
+
+template <typename... Ts> std::uint8_t flags(Ts... vals) {
+    std::uint8_t flags = 0;
+    unsigned n = 0;
+    ((flags |= (vals ? 1 : 0) << n++), ...);
+    return flags;
+}
+
+// Writer
+
+class Writer : public Visitor {
+public:
+    Writer(
+        SrcMan& src_man,
+        const UniqStrPool& str_pool,
+        const UniqStrPool& text_pool):
+        _src_man{src_man}, _str_pool{str_pool}, _text_pool{text_pool} {}
+
+    std::string write_module(Ref<const ModuleDef> module);
+
+    void visit(Ref<Root> node) override { fail(); }
+
+    void visit(Ref<ModuleDef> node) override;
+    void visit(Ref<ClassDef> node) override;
+    void visit(Ref<ClassDefBody> node) override;
+    void visit(Ref<TypeDef> node) override;
+    void visit(Ref<VarDefList> node) override;
+    void visit(Ref<VarDef> node) override;
+    void visit(Ref<FunDef> node) override;
+    void visit(Ref<FunRetType> node) override;
+    void visit(Ref<FunDefBody> node) override;
+    void visit(Ref<Param> node) override;
+    void visit(Ref<ParamList> node) override;
+    void visit(Ref<ArgList> node) override;
+    void visit(Ref<EmptyStmt> node) override;
+    void visit(Ref<Block> node) override;
+    void visit(Ref<Cond> node) override;
+    void visit(Ref<If> node) override;
+    void visit(Ref<For> node) override;
+    void visit(Ref<While> node) override;
+    void visit(Ref<Which> node) override;
+    void visit(Ref<WhichCase> node) override;
+    void visit(Ref<WhichCaseCondList> node) override;
+    void visit(Ref<WhichCaseCond> node) override;
+    void visit(Ref<Return> node) override;
+    void visit(Ref<Break> node) override;
+    void visit(Ref<Continue> node) override;
+    void visit(Ref<ExprStmt> node) override;
+    void visit(Ref<Expr> node) override;
+    void visit(Ref<ExprList> node) override;
+    void visit(Ref<InitValue> node) override;
+    void visit(Ref<InitList> node) override;
+    void visit(Ref<InitMap> node) override;
+    void visit(Ref<FunCall> node) override;
+    void visit(Ref<MemberAccess> node) override;
+    void visit(Ref<ClassConstAccess> node) override;
+    void visit(Ref<ArrayAccess> node) override;
+    void visit(Ref<TypeIdent> node) override;
+    void visit(Ref<TypeSpec> node) override;
+    void visit(Ref<TypeExpr> node) override;
+    void visit(Ref<TypeName> node) override;
+    void visit(Ref<TypeNameList> node) override;
+    void visit(Ref<BaseTypeSelect> node) override;
+    void visit(Ref<FullTypeName> node) override;
+    void visit(Ref<TypeOpExpr> node) override;
+    void visit(Ref<Ident> node) override;
+    void visit(Ref<ParenExpr> node) override;
+    void visit(Ref<BinaryOp> node) override;
+    void visit(Ref<UnaryOp> node) override;
+    void visit(Ref<Cast> node) override;
+    void visit(Ref<Ternary> node) override;
+    void visit(Ref<BoolLit> node) override;
+    void visit(Ref<NumLit> node) override;
+    void visit(Ref<StrLit> node) override;
+
+private:
+    void write(Ref<const Node> node);
+    void write_children(Ref<Node> node, unsigned first = 0);
+    void write_var_def(Ref<VarDefBase> node);
+
+    void head(Tag tag, Ref<const Node> node);
+    void loc(loc_id_t loc_id);
+    void str(str_id_t str_id);
+    void text(str_id_t text_id);
+    void name(Str name);
+
+    void fail() { _ok = false; }
+
+    SrcMan& _src_man;
+    const UniqStrPool& _str_pool;
+    const UniqStrPool& _text_pool;
+    Out _out;
+    std::vector<Src*> _srcs;
+    std::unordered_map<src_id_t, unsigned> _src_idxs;
+    std::vector<str_id_t> _strs;
+    std::unordered_map<str_id_t, unsigned> _str_idxs;
+    std::vector<str_id_t> _texts;
+    std::unordered_map<str_id_t, unsigned> _text_idxs;
+    bool _ok{true};
+};
+
+std::string Writer::write_module(Ref<const ModuleDef> module) {
+    write(module);
+    if (!_ok)
+        return {};
+
+    Out out;
+    out.raw(Magic);
+    out.uint(SerialFormatVersion);
+    out.uint(_srcs.size());
+    for (auto src : _srcs) {
+        out.bytes(src->path().string());
+        out.uint(content_hash(src));
+    }
+    out.uint(_strs.size());
+    for (auto str_id : _strs)
+        out.bytes(_str_pool.get(str_id));
+    out.uint(_texts.size());
+    for (auto text_id : _texts)
+        out.bytes(_text_pool.get(text_id));
+    out.raw(_out.data());
+    return std::move(out.data());
+}
+
+void Writer::visit(Ref<ModuleDef> node) {
+    head(ModuleDefTag, node);
+    _out.uint(node->ulam_version());
+    str(node->name_id());
+    write_children(node);
+}
+
+void Writer::visit(Ref<ClassDef> node) {
+    head(ClassDefTag, node);
+    _out.u8((std::uint8_t)node->kind());
+    name(node->name());
+    _out.u8(flags(node->is_in_tpl()));
+    write(node->params());
+    write(node->parents());
+    write(node->body());
+}
+
+void Writer::visit(Ref<ClassDefBody> node) {
+    head(ClassDefBodyTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<TypeDef> node) {
+    head(TypeDefTag, node);
+    _out.u8(flags(node->is_in_tpl()));
+    write(node->type_name());
+    write(node->type_expr());
+}
+
+void Writer::visit(Ref<VarDefList> node) {
+    head(VarDefListTag, node);
+    _out.u8(flags(node->is_const(), node->is_parameter()));
+    write(node->type_name());
+    write_children(node, 1);
+}
+
+void Writer::visit(Ref<VarDef> node) {
+    head(VarDefTag, node);
+    write_var_def(node);
+}
+
+void Writer::visit(Ref<FunDef> node) {
+    head(FunDefTag, node);
+    name(node->name());
+    _out.u8(flags(
+        node->is_in_tpl(), node->is_constructor(), node->is_op_alias(),
+        node->is_marked_virtual(), node->is_marked_override(),
+        node->is_native()));
+    _out.uint((unsigned)node->op());
+    write(node->ret_type());
+    write(node->params());
+    write(node->body());
+}
+
+void Writer::visit(Ref<FunRetType> node) {
+    head(FunRetTypeTag, node);
+    _out.u8(flags(node->is_ref()));
+    write(node->type_name());
+    write(node->array_dims());
+}
+
+void Writer::visit(Ref<FunDefBody> node) {
+    head(FunDefBodyTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<Param> node) {
+    head(ParamTag, node);
+    write(node->type_name());
+    write_var_def(node);
+}
+
+void Writer::visit(Ref<ParamList> node) {
+    head(ParamListTag, node);
+    loc(node->ellipsis_loc_id());
+    write_children(node);
+}
+
+void Writer::visit(Ref<ArgList> node) {
+    head(ArgListTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<EmptyStmt> node) { head(EmptyStmtTag, node); }
+
+void Writer::visit(Ref<Block> node) {
+    head(BlockTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<Cond> node) {
+    head(CondTag, node);
+    // as-cond is condition expression itself
+    if (node->is_as_cond() && node->as_cond() != node->expr())
+        fail();
+    _out.u8(flags(node->is_as_cond()));
+    write(node->expr());
+}
+
+void Writer::visit(Ref<If> node) {
+    head(IfTag, node);
+    write(node->cond());
+    write(node->if_branch());
+    write(node->else_branch());
+}
+
+void Writer::visit(Ref<For> node) {
+    head(ForTag, node);
+    write(node->init());
+    write(node->cond());
+    write(node->upd());
+    write(node->body());
+}
+
+void Writer::visit(Ref<While> node) {
+    head(WhileTag, node);
+    write(node->cond());
+    write(node->body());
+}
+
+void Writer::visit(Ref<Which> node) {
+    head(WhichTag, node);
+    write(node->expr());
+    write_children(node, 1);
+}
+
+void Writer::visit(Ref<WhichCase> node) {
+    head(WhichCaseTag, node);
+    write(node->conds());
+    write(node->branch());
+}
+
+void Writer::visit(Ref<WhichCaseCondList> node) {
+    head(WhichCaseCondListTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<WhichCaseCond> node) {
+    head(WhichCaseCondTag, node);
+    if (node->is_as_cond() && node->as_cond() != node->expr())
+        fail();
+    _out.u8(flags(node->is_as_cond()));
+    write(node->expr());
+}
+
+void Writer::visit(Ref<Return> node) {
+    head(ReturnTag, node);
+    write(node->expr());
+}
+
+void Writer::visit(Ref<Break> node) { head(BreakTag, node); }
+
+void Writer::visit(Ref<Continue> node) { head(ContinueTag, node); }
+
+void Writer::visit(Ref<ExprStmt> node) {
+    head(ExprStmtTag, node);
+    write(node->expr());
+}
+
+void Writer::visit(Ref<Expr> node) {
+    // class name expressions are visited as Expr
+    auto class_name = dynamic_cast<Ref<ClassName>>(node);
+    if (!class_name) {
+        fail();
+        return;
+    }
+    head(ClassNameTag, node);
+    _out.u8(class_name->kind());
+}
+
+void Writer::visit(Ref<ExprList> node) {
+    head(ExprListTag, node);
+    _out.u8(flags(node->has_empty()));
+    write_children(node);
+}
+
+void Writer::visit(Ref<InitValue> node) {
+    head(InitValueTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<InitList> node) {
+    head(InitListTag, node);
+    _out.u8(flags(node->is_constr_call()));
+    write_children(node);
+}
+
+void Writer::visit(Ref<InitMap> node) {
+    head(InitMapTag, node);
+    _out.u8(flags(node->is_constr_call()));
+    const auto keys = node->keys();
+    _out.uint(keys.size());
+    for (auto key : keys) {
+        str(key);
+        write(node->child_by_key(key));
+    }
+}
+
+void Writer::visit(Ref<FunCall> node) {
+    head(FunCallTag, node);
+    _out.uint((unsigned)node->fun_op());
+    write(node->callable());
+    write(node->args());
+}
+
+void Writer::visit(Ref<MemberAccess> node) {
+    head(MemberAccessTag, node);
+    _out.uint((unsigned)node->op());
+    write(node->obj());
+    write(node->ident());
+    write(node->base_type());
+}
+
+void Writer::visit(Ref<ClassConstAccess> node) {
+    head(ClassConstAccessTag, node);
+    write(node->type_name());
+    write(node->ident());
+}
+
+void Writer::visit(Ref<ArrayAccess> node) {
+    head(ArrayAccessTag, node);
+    write(node->array());
+    write(node->index());
+}
+
+void Writer::visit(Ref<TypeIdent> node) {
+    head(TypeIdentTag, node);
+    name(node->name());
+    _out.u8(flags(node->is_self(), node->is_super(), node->is_local()));
+}
+
+void Writer::visit(Ref<TypeSpec> node) {
+    head(TypeSpecTag, node);
+    _out.uint(node->builtin_type_id());
+    write(node->ident());
+    write(node->args());
+}
+
+void Writer::visit(Ref<TypeExpr> node) {
+    head(TypeExprTag, node);
+    _out.u8(flags(node->is_ref()));
+    loc(node->amp_loc_id());
+    write(node->ident());
+    write(node->array_dims());
+}
+
+void Writer::visit(Ref<TypeName> node) {
+    head(TypeNameTag, node);
+    write(node->first());
+    write_children(node, 1);
+}
+
+void Writer::visit(Ref<TypeNameList> node) {
+    head(TypeNameListTag, node);
+    write_children(node);
+}
+
+void Writer::visit(Ref<BaseTypeSelect> node) {
+    head(BaseTypeSelectTag, node);
+    _out.uint(node->type_spec_num());
+    for (unsigned n = 0; n < node->type_spec_num(); ++n)
+        write(node->type_spec(n));
+    write(node->classid());
+}
+
+void Writer::visit(Ref<FullTypeName> node) {
+    head(FullTypeNameTag, node);
+    _out.u8(flags(node->is_ref()));
+    write(node->type_name());
+    write(node->array_dims());
+}
+
+void Writer::visit(Ref<TypeOpExpr> node) {
+    head(TypeOpExprTag, node);
+    _out.uint((unsigned)node->op());
+    write(node->type_name());
+    write(node->expr());
+    write(node->base_type());
+    write(node->args());
+}
+
+void Writer::visit(Ref<Ident> node) {
+    head(IdentTag, node);
+    name(node->name());
+    _out.u8(flags(node->is_self(), node->is_super(), node->is_local()));
+}
+
+void Writer::visit(Ref<ParenExpr> node) {
+    head(ParenExprTag, node);
+    write(node->inner());
+}
+
+void Writer::visit(Ref<BinaryOp> node) {
+    head(BinaryOpTag, node);
+    _out.uint((unsigned)node->op());
+    write(node->lhs());
+    write(node->rhs());
+}
+
+void Writer::visit(Ref<UnaryOp> node) {
+    auto as_cond = dynamic_cast<Ref<AsCond>>(node);
+    if (as_cond) {
+        // ident is argument itself
+        if (as_cond->ident() != as_cond->arg()) {
+            fail();
+            return;
+        }
+        head(AsCondTag, node);
+    } else {
+        head(UnaryOpTag, node);
+        _out.uint((unsigned)node->op());
+    }
+    write(node->arg());
+    write(node->type_name());
+}
+
+void Writer::visit(Ref<Cast> node) {
+    head(CastTag, node);
+    write(node->full_type_name());
+    write(node->expr());
+}
+
+void Writer::visit(Ref<Ternary> node) {
+    head(TernaryTag, node);
+    write(node->cond());
+    write(node->if_true());
+    write(node->if_false());
+}
+
+void Writer::visit(Ref<BoolLit> node) {
+    head(BoolLitTag, node);
+    _out.u8(node->value());
+}
+
+void Writer::visit(Ref<NumLit> node) {
+    head(NumLitTag, node);
+    const auto& number = node->value();
+    _out.u8((std::uint8_t)number.radix());
+    _out.u8(flags(number.is_signed()));
+    if (number.is_signed()) {
+        _out.sint(number.value<Integer>());
+    } else {
+        _out.uint(number.value<Unsigned>());
+    }
+    _out.u8(number.bitsize());
+}
+
+void Writer::visit(Ref<StrLit> node) {
+    head(StrLitTag, node);
+    text(node->value().id);
+}
+
+void Writer::write(Ref<const Node> node) {
+    if (!_ok)
+        return;
+    if (!node) {
+        _out.u8(NullTag);
+        return;
+    }
+    const_cast<Ref<Node>>(node)->accept(*this);
+}
+
+void Writer::write_children(Ref<Node> node, unsigned first) {
+    _out.uint(node->child_num() - first);
+    for (unsigned n = first; n < node->child_num(); ++n)
+        write(node->child(n));
+}
+
+void Writer::write_var_def(Ref<VarDefBase> node) {
+    name(node->name());
+    _out.u8(flags(
+        node->is_in_tpl(), node->is_const(), node->is_parameter(),
+        node->is_ref()));
+    write(node->array_dims());
+    write(node->init());
+}
+
+void Writer::head(Tag tag, Ref<const Node> node) {
+    _out.u8(tag);
+    loc(node->loc_id());
+}
+
+void Writer::loc(loc_id_t loc_id) {
+    if (loc_id == NoLocId) {
+        _out.uint(0);
+        return;
+    }
+    auto [src, off] = _src_man.src_off(loc_id);
+    auto [it, inserted] = _src_idxs.emplace(src->id(), _srcs.size());
+    if (inserted)
+        _srcs.push_back(src);
+    _out.uint(it->second + 1);
+    _out.uint(off);
+}
+
+void Writer::str(str_id_t str_id) {
+    if (str_id == NoStrId) {
+        _out.uint(0);
+        return;
+    }
+    auto [it, inserted] = _str_idxs.emplace(str_id, _strs.size());
+    if (inserted)
+        _strs.push_back(str_id);
+    _out.uint(it->second + 1);
+}
+
+void Writer::text(str_id_t text_id) {
+    if (text_id == NoStrId) {
+        _out.uint(0);
+        return;
+    }
+    auto [it, inserted] = _text_idxs.emplace(text_id, _texts.size());
+    if (inserted)
+        _texts.push_back(text_id);
+    _out.uint(it->second + 1);
+}
+
+void Writer::name(Str name) {
+    str(name.str_id());
+    loc(name.loc_id());
+}
+
+// Input
+
+struct ReadError {};
+
+class In {
+public:
+    explicit In(std::string_view data):
+        _cur{data.data()}, _end{data.data() + data.size()} {}
+
+    std::uint8_t u8() {
+        check(1);
+        return (std::uint8_t)*_cur++;
+    }
+
+    std::uint64_t uint() {
+        std::uint64_t val = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            auto byte = u8();
+            val |= (std::uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return val;
+        }
+        throw ReadError{};
+    }
+
+    std::int64_t sint() {
+        auto val = uint();
+        return (std::int64_t)(val >> 1) ^ -(std::int64_t)(val & 1);
+    }
+
+    std::string_view bytes() {
+        auto size = uint();
+        check(size);
+        std::string_view str{_cur, size};
+        _cur += size;
+        return str;
+    }
+
+    std::string_view raw(std::size_t size) {
+        check(size);
+        std::string_view str{_cur, size};
+        _cur += size;
+        return str;
+    }
+
+    bool at_end() const { return _cur == _end; }
+
+private:
+    void check(std::uint64_t size) {
+        if (size > (std::uint64_t)(_end - _cur))
+            throw ReadError{};
+    }
+
+    const char* _cur;
+    const char* _end;
+};
+
+// Reader
+
+class Reader {
+public:
+    Reader(
+        SrcMan& src_man,
+        UniqStrPool& str_pool,
+        UniqStrPool& text_pool,
+        std::string_view data):
+        _src_man{src_man},
+        _str_pool{str_pool},
+        _text_pool{text_pool},
+        _in{data} {}
+
+    // throws ReadError
+    Ptr<ModuleDef> read();
+
+private:
+    bool read_srcs();
+    void read_strs();
+
+    Ptr<Node> node();
+    template <typename N> Ptr<N> node_as();
+    template <typename N> Ptr<N> node_as_not_null();
+
+    // items of ListOf nodes
+    template <typename L, typename... Ns> void list_of_items(Ref<L> list);
+    template <typename L, typename N, typename... Ns>
+    void add_list_of_item(Ref<L> list, Ptr<Node>&& item);
+
+    template <typename N> void list_items(Ref<N> list);
+    template <typename N> void var_def(Ref<N> node, std::uint8_t flags);
+
+    Ptr<Node> read(Tag tag, loc_id_t loc_id);
+
+    loc_id_t loc();
+    str_id_t str();
+    str_id_t text();
+    Str name();
+
+    SrcMan& _src_man;
+    UniqStrPool& _str_pool;
+    UniqStrPool& _text_pool;
+    In _in;
+    std::vector<std::pair<loc_id_t, std::size_t>> _src_locs; // {start, size}
+    std::vector<str_id_t> _strs;
+    std::vector<str_id_t> _texts;
+};
+
+Ptr<ModuleDef> Reader::read() {
+    if (_in.raw(Magic.size()) != Magic || _in.uint() != SerialFormatVersion)
+        return {};
+    if (!read_srcs())
+        return {};
+    read_strs();
+    auto module = node_as_not_null<ModuleDef>();
+    if (!_in.at_end())
+        throw ReadError{};
+    return module;
+}
+
+bool Reader::read_srcs() {
+    auto src_num = _in.uint();
+    for (std::uint64_t n = 0; n < src_num; ++n) {
+        const std::filesystem::path path{_in.bytes()};
+        auto hash = _in.uint();
+        auto src = _src_man.src(path);
+        if (!src) {
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec))
+                return false;
+            src = _src_man.file(path);
+        }
+        if (content_hash(src) != hash)
+            return false;
+        auto buf = src->content();
+        _src_locs.emplace_back(
+            _src_man.loc_id(src->id(), buf.start()), buf.size());
+    }
+    return true;
+}
+
+void Reader::read_strs() {
+    auto str_num = _in.uint();
+    for (std::uint64_t n = 0; n < str_num; ++n)
+        _strs.push_back(_str_pool.put(_in.bytes()));
+    auto text_num = _in.uint();
+    for (std::uint64_t n = 0; n < text_num; ++n)
+        _texts.push_back(_text_pool.put(_in.bytes()));
+}
+
+Ptr<Node> Reader::node() {
+    auto tag = _in.u8();
+    if (tag == NullTag)
+        return {};
+    auto loc_id = loc();
+    auto node = read((Tag)tag, loc_id);
+    node->set_loc_id(loc_id);
+    return node;
+}
+
+template <typename N> Ptr<N> Reader::node_as() {
+    auto node = this->node();
+    if (!node)
+        return {};
+    auto node_as = dynamic_cast<Ref<N>>(ref(node));
+    if (!node_as)
+        throw ReadError{};
+    node.release();
+    return Ptr<N>{node_as};
+}
+
+template <typename N> Ptr<N> Reader::node_as_not_null() {
+    auto node = node_as<N>();
+    if (!node)
+        throw ReadError{};
+    return node;
+}
+
+template <typename L, typename... Ns> void Reader::list_of_items(Ref<L> list) {
+    auto num = _in.uint();
+    for (std::uint64_t n = 0; n < num; ++n)
+        add_list_of_item<L, Ns...>(list, node());
+}
+
+template <typename L, typename N, typename... Ns>
+void Reader::add_list_of_item(Ref<L> list, Ptr<Node>&& item) {
+    auto item_as = dynamic_cast<Ref<N>>(ref(item));
+    if (item_as) {
+        item.release();
+        list->add(Ptr<N>{item_as});
+        return;
+    }
+    if constexpr (sizeof...(Ns) > 0) {
+        add_list_of_item<L, Ns...>(list, std::move(item));
+    } else {
+        throw ReadError{};
+    }
+}
+
+template <typename N> void Reader::list_items(Ref<N> list) {
+    using ItemT = typename std::remove_reference_t<
+        decltype(*list->get(0))>; // list item type
+    auto num = _in.uint();
+    for (std::uint64_t n = 0; n < num; ++n)
+        list->add(node_as<ItemT>());
+}
+
+template <typename N> void Reader::var_def(Ref<N> node, std::uint8_t flags) {
+    node->set_is_in_tpl(flags & 1);
+    node->set_is_const(flags & 2);
+    node->set_is_parameter(flags & 4);
+    node->set_is_ref(flags & 8);
+}
+
+Ptr<Node> Reader::read(Tag tag, loc_id_t loc_id) {
+    switch (tag) {
+    case ModuleDefTag: {
+        auto node = make<ModuleDef>();
+        node->set_ulam_version(_in.uint());
+        node->set_name_id(str());
+        list_of_items<ModuleDef, TypeDef, VarDefList, ClassDef>(ref(node));
+        return node;
+    }
+    case ClassDefTag: {
+        auto kind = _in.u8();
+        if (kind > (std::uint8_t)ClassKind::Union)
+            throw ReadError{};
+        auto name = this->name();
+        auto flags = _in.u8();
+        auto params = node_as<ParamList>();
+        auto parents = node_as<TypeNameList>();
+        auto node = make<ClassDef>(
+            (ClassKind)kind, name, std::move(params), std::move(parents));
+        node->set_is_in_tpl(flags & 1);
+        node->replace_body(node_as_not_null<ClassDefBody>());
+        return node;
+    }
+    case ClassDefBodyTag: {
+        auto node = make<ClassDefBody>();
+        list_of_items<ClassDefBody, TypeDef, FunDef, VarDefList>(ref(node));
+        return node;
+    }
+    case TypeDefTag: {
+        auto flags = _in.u8();
+        auto type_name = node_as_not_null<TypeName>();
+        auto type_expr = node_as_not_null<TypeExpr>();
+        auto node =
+            make<TypeDef>(std::move(type_name), std::move(type_expr));
+        node->set_is_in_tpl(flags & 1);
+        return node;
+    }
+    case VarDefListTag: {
+        auto flags = _in.u8();
+        auto node = make<VarDefList>(node_as<TypeName>());
+        node->set_is_const(flags & 1);
+        node->set_is_parameter(flags & 2);
+        auto num = _in.uint();
+        for (std::uint64_t n = 0; n < num; ++n)
+            node->add(node_as_not_null<VarDef>());
+        return node;
+    }
+    case VarDefTag: {
+        auto name = this->name();
+        auto flags = _in.u8();
+        auto array_dims = node_as<ExprList>();
+        auto init = node_as<InitValue>();
+        auto node = make<VarDef>(name, std::move(array_dims), std::move(init));
+        var_def(ref(node), flags);
+        return node;
+    }
+    case FunDefTag: {
+        auto name = this->name();
+        auto flags = _in.u8();
+        auto op = (Op)_in.uint();
+        auto ret_type = node_as<FunRetType>();
+        auto params = node_as<ParamList>();
+        auto body = node_as<FunDefBody>();
+        auto node = make<FunDef>(
+            name, std::move(ret_type), std::move(params), std::move(body));
+        node->set_is_in_tpl(flags & 1);
+        node->set_is_constructor(flags & 2);
+        node->set_is_op_alias(flags & 4);
+        node->set_is_marked_virtual(flags & 8);
+        node->set_is_marked_override(flags & 16);
+        node->set_is_native(flags & 32);
+        node->set_op(op);
+        return node;
+    }
+    case FunRetTypeTag: {
+        auto flags = _in.u8();
+        auto type_name = node_as_not_null<TypeName>();
+        auto array_dims = node_as<ExprList>();
+        auto node =
+            make<FunRetType>(std::move(type_name), std::move(array_dims));
+        node->set_is_ref(flags & 1);
+        return node;
+    }
+    case FunDefBodyTag: {
+        auto node = make<FunDefBody>();
+        list_items(ref(node));
+        return node;
+    }
+    case ParamTag: {
+        auto type_name = node_as<TypeName>();
+        auto name = this->name();
+        auto flags = _in.u8();
+        auto array_dims = node_as<ExprList>();
+        auto init = node_as<InitValue>();
+        auto node = make<Param>(
+            name, std::move(type_name), std::move(array_dims),
+            std::move(init));
+        var_def(ref(node), flags);
+        return node;
+    }
+    case ParamListTag: {
+        auto node = make<ParamList>();
+        node->set_ellipsis_loc_id(loc());
+        list_items(ref(node));
+        return node;
+    }
+    case ArgListTag: {
+        auto node = make<ArgList>();
+        list_items(ref(node));
+        return node;
+    }
+    case EmptyStmtTag:
+        return make<EmptyStmt>();
+    case BlockTag: {
+        auto node = make<Block>();
+        list_items(ref(node));
+        return node;
+    }
+    case CondTag:
+    case WhichCaseCondTag: {
+        bool is_as_cond = _in.u8() & 1;
+        auto expr = node_as<Expr>();
+        Ref<AsCond> as_cond{};
+        if (is_as_cond) {
+            as_cond = dynamic_cast<Ref<AsCond>>(ref(expr));
+            if (!as_cond)
+                throw ReadError{};
+        }
+        if (tag == CondTag)
+            return make<Cond>(std::move(expr), as_cond);
+        return make<WhichCaseCond>(std::move(expr), as_cond);
+    }
+    case IfTag: {
+        auto cond = node_as_not_null<Cond>();
+        auto if_branch = node_as<Stmt>();
+        auto else_branch = node_as<Stmt>();
+        return make<If>(
+            std::move(cond), std::move(if_branch), std::move(else_branch));
+    }
+    case ForTag: {
+        auto init = node_as<Stmt>();
+        auto cond = node_as<Cond>();
+        auto upd = node_as<Expr>();
+        auto body = node_as<Stmt>();
+        return make<For>(
+            std::move(init), std::move(cond), std::move(upd),
+            std::move(body));
+    }
+    case WhileTag: {
+        auto cond = node_as_not_null<Cond>();
+        auto body = node_as<Stmt>();
+        return make<While>(std::move(cond), std::move(body));
+    }
+    case WhichTag: {
+        auto node = make<Which>(node_as<Expr>());
+        auto num = _in.uint();
+        for (std::uint64_t n = 0; n < num; ++n)
+            node->add(node_as_not_null<WhichCase>());
+        return node;
+    }
+    case WhichCaseTag: {
+        auto conds = node_as_not_null<WhichCaseCondList>();
+        auto branch = node_as<Block>();
+        return make<WhichCase>(std::move(conds), std::move(branch));
+    }
+    case WhichCaseCondListTag: {
+        auto node = make<WhichCaseCondList>();
+        list_items(ref(node));
+        return node;
+    }
+    case ReturnTag:
+        return make<Return>(node_as<Expr>());
+    case BreakTag:
+        return make<Break>();
+    case ContinueTag:
+        return make<Continue>();
+    case ExprStmtTag:
+        return make<ExprStmt>(node_as<Expr>());
+    case ExprListTag: {
+        auto node = make<ExprList>();
+        node->set_has_empty(_in.u8() & 1);
+        list_items(ref(node));
+        return node;
+    }
+    case InitValueTag: {
+        if (_in.uint() != 1)
+            throw ReadError{};
+        auto item = node();
+        if (auto map = dynamic_cast<Ref<InitMap>>(ref(item))) {
+            item.release();
+            return make<InitValue>(Ptr<InitMap>{map});
+        }
+        if (auto list = dynamic_cast<Ref<InitList>>(ref(item))) {
+            item.release();
+            return make<InitValue>(Ptr<InitList>{list});
+        }
+        if (auto expr = dynamic_cast<Ref<Expr>>(ref(item))) {
+            item.release();
+            return make<InitValue>(Ptr<Expr>{expr});
+        }
+        throw ReadError{};
+    }
+    case InitListTag: {
+        auto node = make<InitList>();
+        node->set_is_constr_call(_in.u8() & 1);
+        // NOTE: InitMap is an InitList, checked first
+        list_of_items<InitList, InitMap, InitList, Expr>(ref(node));
+        return node;
+    }
+    case InitMapTag: {
+        auto node = make<InitMap>();
+        node->set_is_constr_call(_in.u8() & 1);
+        auto num = _in.uint();
+        for (std::uint64_t n = 0; n < num; ++n) {
+            auto key = str();
+            if (key == NoStrId || node->has(key))
+                throw ReadError{};
+            auto item = this->node();
+            if (auto map = dynamic_cast<Ref<InitMap>>(ref(item))) {
+                item.release();
+                node->add(key, Ptr<InitMap>{map});
+            } else if (auto list = dynamic_cast<Ref<InitList>>(ref(item))) {
+                item.release();
+                node->add(key, Ptr<InitList>{list});
+            } else if (auto expr = dynamic_cast<Ref<Expr>>(ref(item))) {
+                item.release();
+                node->add(key, Ptr<Expr>{expr});
+            } else {
+                throw ReadError{};
+            }
+        }
+        return node;
+    }
+    case FunCallTag: {
+        auto fun_op = (Op)_in.uint();
+        auto callable = node_as<Expr>();
+        auto args = node_as<ArgList>();
+        auto node = make<FunCall>(std::move(callable), std::move(args));
+        node->set_fun_op(fun_op);
+        return node;
+    }
+    case MemberAccessTag: {
+        auto op = (Op)_in.uint();
+        auto obj = node_as<Expr>();
+        auto ident = node_as<Ident>();
+        auto base_type = node_as<BaseTypeSelect>();
+        auto node = make<MemberAccess>(
+            std::move(obj), std::move(ident), std::move(base_type));
+        node->set_op(op);
+        return node;
+    }
+    case ClassConstAccessTag: {
+        auto type_name = node_as<TypeName>();
+        auto ident = node_as<Ident>();
+        return make<ClassConstAccess>(std::move(type_name), std::move(ident));
+    }
+    case ArrayAccessTag: {
+        auto array = node_as<Expr>();
+        auto index = node_as<Expr>();
+        return make<ArrayAccess>(std::move(array), std::move(index));
+    }
+    case TypeIdentTag: {
+        auto node = make<TypeIdent>(name());
+        auto flags = _in.u8();
+        node->set_is_self(flags & 1);
+        node->set_is_super(flags & 2);
+        node->set_is_local(flags & 4);
+        return node;
+    }
+    case TypeSpecTag: {
+        auto builtin_type_id = (BuiltinTypeId)_in.uint();
+        auto ident = node_as<TypeIdent>();
+        auto args = node_as<ArgList>();
+        if (builtin_type_id != NoBuiltinTypeId) {
+            if (ident)
+                throw ReadError{};
+            return make<TypeSpec>(builtin_type_id, std::move(args));
+        }
+        return make<TypeSpec>(std::move(ident), std::move(args));
+    }
+    case TypeExprTag: {
+        auto flags = _in.u8();
+        auto amp_loc_id = loc();
+        auto ident = node_as<TypeIdent>();
+        auto array_dims = node_as<ExprList>();
+        auto node = make<TypeExpr>(std::move(ident), std::move(array_dims));
+        node->set_is_ref(flags & 1);
+        node->set_amp_loc_id(amp_loc_id);
+        return node;
+    }
+    case TypeNameTag: {
+        auto node = make<TypeName>(node_as_not_null<TypeSpec>());
+        auto num = _in.uint();
+        for (std::uint64_t n = 0; n < num; ++n)
+            node->add(node_as_not_null<TypeIdent>());
+        return node;
+    }
+    case TypeNameListTag: {
+        auto node = make<TypeNameList>();
+        list_items(ref(node));
+        return node;
+    }
+    case BaseTypeSelectTag: {
+        std::vector<Ptr<TypeSpec>> type_specs;
+        auto num = _in.uint();
+        for (std::uint64_t n = 0; n < num; ++n)
+            type_specs.push_back(node_as_not_null<TypeSpec>());
+        auto node = make<BaseTypeSelect>(node_as<Expr>());
+        for (auto& type_spec : type_specs)
+            node->add(std::move(type_spec));
+        return node;
+    }
+    case FullTypeNameTag: {
+        auto flags = _in.u8();
+        auto type_name = node_as_not_null<TypeName>();
+        auto array_dims = node_as<ExprList>();
+        auto node =
+            make<FullTypeName>(std::move(type_name), std::move(array_dims));
+        node->set_is_ref(flags & 1);
+        return node;
+    }
+    case TypeOpExprTag: {
+        auto op = (TypeOp)_in.uint();
+        auto type_name = node_as<TypeName>();
+        auto expr = node_as<Expr>();
+        auto base_type = node_as<BaseTypeSelect>();
+        auto args = node_as<ArgList>();
+        if (op == TypeOp::None || (bool)type_name == (bool)expr ||
+            (base_type && !expr))
+            throw ReadError{};
+        return make<TypeOpExpr>(
+            op, std::move(type_name), std::move(expr), std::move(base_type),
+            std::move(args));
+    }
+    case IdentTag: {
+        auto node = make<Ident>(name());
+        auto flags = _in.u8();
+        node->set_is_self(flags & 1);
+        node->set_is_super(flags & 2);
+        node->set_is_local(flags & 4);
+        return node;
+    }
+    case ParenExprTag:
+        return make<ParenExpr>(node_as<Expr>());
+    case BinaryOpTag: {
+        auto op = (Op)_in.uint();
+        auto lhs = node_as<Expr>();
+        auto rhs = node_as<Expr>();
+        if (op == Op::None)
+            throw ReadError{};
+        return make<BinaryOp>(op, std::move(lhs), std::move(rhs));
+    }
+    case UnaryOpTag: {
+        auto op = (Op)_in.uint();
+        auto arg = node_as<Expr>();
+        auto type_name = node_as<TypeName>();
+        if (op == Op::None)
+            throw ReadError{};
+        return make<UnaryOp>(op, std::move(arg), std::move(type_name));
+    }
+    case AsCondTag: {
+        auto arg = node_as_not_null<Ident>();
+        auto ident = ref(arg);
+        auto type_name = node_as_not_null<TypeName>();
+        return make<AsCond>(std::move(arg), std::move(type_name), ident);
+    }
+    case CastTag: {
+        auto full_type_name = node_as_not_null<FullTypeName>();
+        auto expr = node_as<Expr>();
+        return make<Cast>(std::move(full_type_name), std::move(expr));
+    }
+    case TernaryTag: {
+        auto cond = node_as<Expr>();
+        auto if_true = node_as<Expr>();
+        auto if_false = node_as<Expr>();
+        return make<Ternary>(
+            std::move(cond), std::move(if_true), std::move(if_false));
+    }
+    case BoolLitTag:
+        return make<BoolLit>(_in.u8() != 0);
+    case NumLitTag: {
+        auto radix = _in.u8();
+        if (radix > (std::uint8_t)Radix::Hexadecimal)
+            throw ReadError{};
+        bool is_signed = _in.u8() & 1;
+        Number number;
+        if (is_signed) {
+            Integer value = _in.sint();
+            number = {(Radix)radix, value, _in.u8()};
+        } else {
+            Unsigned value = _in.uint();
+            number = {(Radix)radix, value, _in.u8()};
+        }
+        return make<NumLit>(std::move(number));
+    }
+    case StrLitTag:
+        return make<StrLit>(String{text()});
+    case ClassNameTag: {
+        auto kind = _in.u8();
+        if (kind > ClassNameMangled)
+            throw ReadError{};
+        return make<ClassName>((ClassNameKind)kind);
+    }
+    default:
+        throw ReadError{};
+    }
+}
+
+loc_id_t Reader::loc() {
+    auto idx = _in.uint();
+    if (idx == 0)
+        return NoLocId;
+    if (idx > _src_locs.size())
+        throw ReadError{};
+    auto off = _in.uint();
+    auto [start, size] = _src_locs[idx - 1];
+    if (off >= size)
+        throw ReadError{};
+    return start + off;
+}
+
+str_id_t Reader::str() {
+    auto idx = _in.uint();
+    if (idx == 0)
+        return NoStrId;
+    if (idx > _strs.size())
+        throw ReadError{};
+    return _strs[idx - 1];
+}
+
+str_id_t Reader::text() {
+    auto idx = _in.uint();
+    if (idx == 0)
+        return NoStrId;
+    if (idx > _texts.size())
+        throw ReadError{};
+    return _texts[idx - 1];
+}
+
+Str Reader::name() {
+    auto str_id = str();
+    return {str_id, loc()};
+}
+
+} // namespace
+
+std::string write_module(
+    SrcMan& src_man,
+    const UniqStrPool& str_pool,
+    const UniqStrPool& text_pool,
+    Ref<const ModuleDef> module) {
+    Writer writer{src_man, str_pool, text_pool};
+    return writer.write_module(module);
+}
+
+Ptr<ModuleDef> read_module(
+    SrcMan& src_man,
+    UniqStrPool& str_pool,
+    UniqStrPool& text_pool,
+    std::string_view data) {
+    Reader reader{src_man, str_pool, text_pool, data};
+    try {
+        return reader.read();
+    } catch (const ReadError&) {
+        return {};
+    }
+}
+
+} // namespace ulam::ast
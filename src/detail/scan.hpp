@@ -0,0 +1,137 @@
+#pragma once
+#include "src/detail/string.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#    define ULAM_SCAN_SIMD 1
+#elif defined(__SSE2__)
+#    include <emmintrin.h>
+#    define ULAM_SCAN_SIMD 1
+#else
+#    define ULAM_SCAN_SIMD 0
+#endif
+
+// Scanning of character runs for lexer, uses AVX2 or SSE2 when available
+// (AVX2 has to be enabled at compile time, e.g. with -mavx2) with scalar
+// fallback. All functions scan [cur, end) and return pointer to first
+// character not in run or `end`.
+
+namespace ulam::detail {
+
+#if ULAM_SCAN_SIMD
+namespace scan {
+
+#    if defined(__AVX2__)
+struct Vec {
+    static constexpr std::size_t Size = 32;
+
+    static Vec load(const char* data) {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data))};
+    }
+    static Vec splat(char ch) { return {_mm256_set1_epi8(ch)}; }
+
+    Vec operator==(Vec other) const {
+        return {_mm256_cmpeq_epi8(v, other.v)};
+    }
+    // NOTE: signed comparison
+    Vec operator>(Vec other) const { return {_mm256_cmpgt_epi8(v, other.v)}; }
+    Vec operator|(Vec other) const { return {_mm256_or_si256(v, other.v)}; }
+    Vec operator&(Vec other) const { return {_mm256_and_si256(v, other.v)}; }
+
+    std::uint32_t mask() const {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+    }
+
+    __m256i v;
+};
+#    else
+struct Vec {
+    static constexpr std::size_t Size = 16;
+
+    static Vec load(const char* data) {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))};
+    }
+    static Vec splat(char ch) { return {_mm_set1_epi8(ch)}; }
+
+    Vec operator==(Vec other) const { return {_mm_cmpeq_epi8(v, other.v)}; }
+    // NOTE: signed comparison
+    Vec operator>(Vec other) const { return {_mm_cmpgt_epi8(v, other.v)}; }
+    Vec operator|(Vec other) const { return {_mm_or_si128(v, other.v)}; }
+    Vec operator&(Vec other) const { return {_mm_and_si128(v, other.v)}; }
+
+    std::uint32_t mask() const {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+    }
+
+    __m128i v;
+};
+#    endif
+
+constexpr std::uint32_t FullMask =
+    (Vec::Size == 32) ? ~std::uint32_t{0} : (std::uint32_t{1} << Vec::Size) - 1;
+
+// ASCII only, bytes >= 0x80 are negative and never in range
+inline Vec in_range(Vec vec, char first, char last) {
+    return (vec > Vec::splat(first - 1)) & (Vec::splat(last + 1) > vec);
+}
+
+// advances while `match` mask is set for all bytes in block
+template <typename F>
+const char* skip(const char* cur, const char* end, F match) {
+    for (; cur + Vec::Size <= end; cur += Vec::Size) {
+        std::uint32_t mask = ~match(Vec::load(cur)).mask() & FullMask;
+        if (mask != 0)
+            return cur + __builtin_ctz(mask);
+    }
+    return cur;
+}
+
+} // namespace scan
+#endif
+
+inline const char* skip_word(const char* cur, const char* end) {
+#if ULAM_SCAN_SIMD
+    using scan::Vec;
+    cur = scan::skip(cur, end, [](Vec vec) {
+        // lowercase letters, digits don't change with 0x20 bit set
+        auto lower = vec | Vec::splat(0x20);
+        return scan::in_range(lower, 'a', 'z') |
+               scan::in_range(vec, '0', '9') | (vec == Vec::splat('_'));
+    });
+#endif
+    while (cur < end && is_word(*cur))
+        ++cur;
+    return cur;
+}
+
+// skips spaces and tabs
+inline const char* skip_blank(const char* cur, const char* end) {
+#if ULAM_SCAN_SIMD
+    using scan::Vec;
+    cur = scan::skip(cur, end, [](Vec vec) {
+        return (vec == Vec::splat(' ')) | (vec == Vec::splat('\t'));
+    });
+#endif
+    while (cur < end && (*cur == ' ' || *cur == '\t'))
+        ++cur;
+    return cur;
+}
+
+// finds first of `Chs`
+template <char... Chs>
+inline const char* find_any(const char* cur, const char* end) {
+#if ULAM_SCAN_SIMD
+    using scan::Vec;
+    cur = scan::skip(cur, end, [](Vec vec) {
+        auto found = ((vec == Vec::splat(Chs)) | ...);
+        return found == Vec::splat(0);
+    });
+#endif
+    while (cur < end && ((*cur != Chs) && ...))
+        ++cur;
+    return cur;
+}
+
+} // namespace ulam::detail
@@ -4,12 +4,16 @@
 #include <iostream>
 #include <libulam/ast/node.hpp>
 #include <libulam/diag.hpp>
+#include <mutex>
 
 namespace ulam {
 namespace {
 
 constexpr unsigned MaxErrorNum = 10;
 
+// errors can be reported by preprocessor thread (see Parser)
+std::mutex emit_mutex;
+
 constexpr char FatalPrefix[] = "Fatal error ";
 constexpr char ErrorPrefix[] = "Error ";
 constexpr char WarnPrefix[] = "Warning ";
@@ -55,6 +59,13 @@ void Diag::emit(
     int off,
     std::size_t len,
     const std::string& text) {
+    std::lock_guard lock{emit_mutex};
+    if (_is_quiet) {
+        if (lvl < Diag::Warn)
+            ++_err_num;
+        return;
+    }
+
     const auto& loc = src_man().loc(loc_id);
     auto src = src_man().src(loc.src_id());
     std::cerr << level_prefix(lvl) << "in " << src->path() << ":" << loc.linum()
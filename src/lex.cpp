@@ -1,3 +1,4 @@
+#include "src/detail/scan.hpp"
 #include "src/detail/string.hpp"
 #include <libulam/lex.hpp>
 #include <libulam/preproc.hpp>
@@ -7,6 +8,12 @@
 
 namespace ulam {
 
+Lex::Lex(Preproc& pp, SrcMan& src_man, src_id_t src_id, const mem::BufRef buf):
+    _pp{pp},
+    _buf{buf},
+    _loc_id{src_man.loc_id(src_id, buf.start())},
+    _cur{buf.start()} {}
+
 void Lex::lex(Token& token) {
     skip_whitespace();
     start(token);
@@ -240,12 +247,17 @@ void Lex::advance(std::size_t len) {
     _cur += len;
 }
 
+void Lex::advance_to(const char* cur) {
+    ulam_assert(_cur <= cur && cur <= _buf.end());
+    _cur = cur;
+}
+
 void Lex::skip_whitespace() {
     while (true) {
         switch (_cur[0]) {
         case ' ':
         case '\t':
-            advance();
+            advance_to(detail::skip_blank(_cur + 1, _buf.end()));
             break;
         case '\r':
             if (_cur[1] == '\n')
@@ -260,7 +272,10 @@ void Lex::skip_whitespace() {
     }
 }
 
-loc_id_t Lex::loc_id() { return _src_man.loc_id(_src_id, _cur, _linum, chr()); }
+loc_id_t Lex::loc_id() {
+    // see SrcMan::loc_id
+    return _loc_id + (_cur - _buf.start());
+}
 
 void Lex::start(Token& token) {
     _tok_start = _cur;
@@ -277,8 +292,6 @@ void Lex::complete(tok::Type type) {
 void Lex::newline(std::size_t size) {
     ulam_assert(size < 3);
     advance(size);
-    ++_linum;
-    _line = _cur;
 }
 
 void Lex::lex_str(char closing) {
@@ -362,7 +375,8 @@ void Lex::lex_comment() {
             }
             break;
         default:
-            advance();
+            advance_to(detail::find_any<'\0', '\r', '\n', '\\'>(
+                _cur + 1, _buf.end()));
         }
         esc = false;
     }
@@ -393,7 +407,8 @@ void Lex::lex_ml_comment() {
             }
             break;
         default:
-            advance();
+            advance_to(
+                detail::find_any<'\0', '\r', '\n', '*'>(_cur + 1, _buf.end()));
         }
     }
 }
@@ -476,8 +491,7 @@ void Lex::lex_number() {
 void Lex::lex_word() {
     ulam_assert(_tok_start);
     ulam_assert(_cur[-1] == '@' || detail::is_word(_cur[-1]));
-    while (detail::is_word(_cur[0]))
-        advance();
+    advance_to(detail::skip_word(_cur, _buf.end()));
     auto type = tok::type_by_keyword(
         {_tok_start, static_cast<std::size_t>(_cur - _tok_start)});
     complete(type);
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <libulam/assert.hpp>
+#include <libulam/memory/arena.hpp>
+#include <new>
+
+namespace ulam::mem {
+
+namespace {
+constexpr std::size_t Align = alignof(std::max_align_t);
+
+constexpr std::size_t align(std::size_t size) {
+    return (size + Align - 1) & ~(Align - 1);
+}
+
+thread_local Ref<Arena> current_arena{};
+} // namespace
+
+// Arena::Scope
+
+Arena::Scope::Scope(Ref<Arena> arena): _prev{current_arena} {
+    current_arena = arena;
+}
+
+Arena::Scope::~Scope() { current_arena = _prev; }
+
+// Arena
+
+Arena::Arena(std::size_t pagesize): _pagesize{align(pagesize)} {
+    ulam_assert(pagesize > 0);
+}
+
+Arena::~Arena() {
+    auto cur = _pages;
+    while (cur) {
+        auto next = cur->next;
+        delete[] reinterpret_cast<char*>(cur);
+        cur = next;
+    }
+}
+
+void* Arena::alloc(std::size_t size) {
+    size = align(std::max<std::size_t>(size, 1));
+    if ((std::size_t)(_end - _cur) < size) {
+        // large allocations get their own page, current page is kept
+        if (size > _pagesize / 4) {
+            auto cur = _cur;
+            auto end = _end;
+            alloc_page(size);
+            auto data = _cur;
+            _cur = cur;
+            _end = end;
+            return data;
+        }
+        alloc_page(_pagesize);
+    }
+    auto data = _cur;
+    _cur += size;
+    return data;
+}
+
+Ref<Arena> Arena::current() { return current_arena; }
+
+void Arena::alloc_page(std::size_t size) {
+    const std::size_t HeaderSize = align(sizeof(Page));
+    char* data = new char[HeaderSize + size];
+    _pages = new (data) Page{_pages};
+    _cur = data + HeaderSize;
+    _end = _cur + size;
+    _size += HeaderSize + size;
+}
+
+} // namespace ulam::mem
@@ -2,11 +2,13 @@
 #include <libulam/context.hpp>
 #include <libulam/diag.hpp>
 #include <libulam/parser.hpp>
+#include <libulam/parser/cache.hpp>
 #include <libulam/src_loc.hpp>
 #include <libulam/token.hpp>
 #include <src/parser/number.hpp>
 #include <src/parser/string.hpp>
 #include <string>
+#include <thread>
 
 #ifdef DEBUG_PARSER
 #    define ULAM_DEBUG
@@ -17,16 +19,26 @@
 namespace ulam {
 
 Ptr<ast::ModuleDef> Parser::parse_module_file(const Path& path) {
+    ParseCache cache{_ctx, _str_pool, _text_pool};
+    if (cache.enabled()) {
+        mem::Arena::Scope arena_scope{_arena};
+        auto module = cache.load(path);
+        if (module)
+            return module;
+    }
+
+    auto err_num = _ctx.diag().err_num();
     _pp.main_file(path);
-    consume();
-    return parse_module(path.stem().string());
+    auto module = parse_main_module(path.stem().string());
+    if (cache.enabled() && _ctx.diag().err_num() == err_num)
+        cache.store(path, ref(module));
+    return module;
 }
 
 Ptr<ast::ModuleDef>
 Parser::parse_module_str(const std::string& text, const Path& path) {
     _pp.main_string(text, path);
-    consume();
-    return parse_module(path.stem().string());
+    return parse_main_module(path.stem().string());
 }
 
 void Parser::add_str_src(const std::string& text, const Path& path) {
@@ -35,6 +47,7 @@ void Parser::add_str_src(const std::string& text, const Path& path) {
 
 Ptr<ast::Block> Parser::parse_stmts(std::string text) {
     _pp.main_string(text, ""); // TODO: stream source
+    _ring.reset(TokenRing::MinSize);
     consume();
     auto block = tree<ast::Block>();
     parse_as_block(ref(block), true /* implicit braces */);
@@ -42,17 +55,18 @@ Ptr<ast::Block> Parser::parse_stmts(std::string text) {
 }
 
 void Parser::consume() {
-    if (_back.empty()) {
-        _pp >> _tok;
-    } else {
-        _tok = _back.top();
-        _back.pop();
+    if (!_pp_async && !_ring.has_next()) {
+        Token token;
+        _pp >> token;
+        _ring.push(token);
     }
+    _tok = _ring.next();
 }
 
 void Parser::putback(Token token) {
-    _back.push(_tok);
-    _tok = token;
+    // only previously consumed tokens can be put back
+    _tok = _ring.back();
+    ulam_assert(_tok.loc_id == token.loc_id);
 }
 
 void Parser::consume_if(tok::Type type) {
@@ -115,7 +129,38 @@ void Parser::diag(loc_id_t loc_id, std::size_t size, std::string text) {
     _ctx.diag().emit(Diag::Error, loc_id, size, text);
 }
 
+Ptr<ast::ModuleDef> Parser::parse_main_module(const std::string_view name) {
+    if (!_ctx.options.parser_options.preproc_thread) {
+        _ring.reset(TokenRing::MinSize);
+        consume();
+        return parse_module(name);
+    }
+
+    // preprocessor runs ahead filling the ring,
+    // sources are shared by both threads
+    auto& src_man = _ctx.src_man();
+    src_man.set_locking(true);
+    _ring.reset(TokenRing::DefaultSize);
+    _pp_async = true;
+    std::thread pp_thread{[&]() {
+        Token token;
+        do {
+            _pp >> token;
+        } while (_ring.push(token) && !token.is(tok::Eof));
+    }};
+
+    consume();
+    auto module = parse_module(name);
+
+    _ring.close();
+    pp_thread.join();
+    _pp_async = false;
+    src_man.set_locking(false);
+    return module;
+}
+
 Ptr<ast::ModuleDef> Parser::parse_module(const std::string_view name) {
+    mem::Arena::Scope arena_scope{_arena};
     auto node = tree_at<ast::ModuleDef>(_tok.loc_id);
     node->set_ulam_version(_pp.version());
     node->set_name_id(_str_pool.put(name));
@@ -2181,9 +2226,9 @@ std::string Parser::str_lit_text() {
     case tok::String:
         return detail::parse_str(_ctx.diag(), _tok.loc_id, tok_str());
     case tok::__File:
-        return _pp.current_path().filename();
+        return tok_src_path().filename();
     case tok::__FilePath:
-        return _pp.current_path();
+        return tok_src_path();
     case tok::__Func:
         if (!_cur_fun_def) {
             diag("__FUN__ macro outside of function body");
@@ -2212,6 +2257,11 @@ const std::string_view Parser::tok_str() {
     return _ctx.src_man().str_at(_tok.loc_id, _tok.size);
 }
 
+const Parser::Path& Parser::tok_src_path() {
+    // preprocessor may be ahead of parser in another source
+    return _ctx.src_man().src_off(_tok.loc_id).first->path();
+}
+
 ast::Str Parser::tok_ast_str() {
     ulam_assert(_tok.in(tok::Ident, tok::TypeIdent));
     return {tok_str_id(), _tok.loc_id};
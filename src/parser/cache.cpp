@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <fstream>
+#include <libulam/ast/serial.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser/cache.hpp>
+#include <libulam/src.hpp>
+#include <libulam/utils/hash.hpp>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+#ifdef DEBUG_PARSE_CACHE
+#    define ULAM_DEBUG
+#    define ULAM_DEBUG_PREFIX "[ulam::ParseCache] "
+#endif
+#include "src/debug.hpp"
+
+namespace ulam {
+
+ParseCache::Stats ParseCache::_stats;
+
+ParseCache::ParseCache(
+    Context& ctx, UniqStrPool& str_pool, UniqStrPool& text_pool):
+    _ctx{ctx},
+    _str_pool{str_pool},
+    _text_pool{text_pool},
+    _dir{ctx.options.parser_options.cache_dir} {}
+
+Ptr<ast::ModuleDef> ParseCache::load(const Path& path) {
+    ulam_assert(enabled());
+    std::ifstream file{cache_path(path), std::ios::binary};
+    if (!file) {
+        _stats.misses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    auto module =
+        ast::read_module(_ctx.src_man(), _str_pool, _text_pool, ss.str());
+    if (!module) {
+        debug() << "stale or invalid cache entry for " << path << "\n";
+        _stats.misses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    _stats.hits.fetch_add(1, std::memory_order_relaxed);
+    return module;
+}
+
+void ParseCache::store(const Path& path, Ref<const ast::ModuleDef> module) {
+    ulam_assert(enabled());
+    auto data =
+        ast::write_module(_ctx.src_man(), _str_pool, _text_pool, module);
+    if (data.empty())
+        return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(_dir, ec);
+    if (ec)
+        return;
+
+    // write to temporary file first, concurrent readers never see
+    // partially written entries
+    const auto cache_path = this->cache_path(path);
+    auto tmp_path = cache_path;
+    tmp_path += "." + std::to_string(getpid()) + "." +
+                std::to_string(
+                    std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+                ".tmp";
+    {
+        std::ofstream file{tmp_path, std::ios::binary};
+        file.write(data.data(), data.size());
+        if (!file) {
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp_path, cache_path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return;
+    }
+    _stats.stores.fetch_add(1, std::memory_order_relaxed);
+}
+
+Path ParseCache::cache_path(const Path& path) {
+    auto& src_man = _ctx.src_man();
+    auto src = src_man.src(path);
+    if (!src)
+        src = src_man.file(path);
+    auto buf = src->content();
+
+    auto hash = utils::hash(
+        std::to_string(ast::SerialFormatVersion) + ':' + path.string() +
+        std::string(1, '\0'));
+    hash = utils::hash({buf.start(), buf.size()}, hash);
+    const auto& options = _ctx.options.parser_options;
+    hash = utils::hash(options.allow_assign_in_ternary ? "1" : "0", hash);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.ast", (unsigned long long)hash);
+    return _dir / name;
+}
+
+} // namespace ulam
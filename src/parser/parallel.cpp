@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <atomic>
+#include <libulam/ast/serial.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <libulam/parser/parallel.hpp>
+#include <thread>
+
+#ifdef DEBUG_PARALLEL_PARSER
+#    define ULAM_DEBUG
+#    define ULAM_DEBUG_PREFIX "[ulam::ParallelParser] "
+#endif
+#include "src/debug.hpp"
+
+namespace ulam {
+
+void ParallelParser::add_module_file(const Path& path) {
+    _jobs.push_back({path, {}, false, {}});
+}
+
+void ParallelParser::add_module_str(const std::string& text, const Path& path) {
+    ulam_assert(!path.empty());
+    _jobs.push_back({path, text, true, {}});
+}
+
+void ParallelParser::add_str_src(const std::string& text, const Path& path) {
+    _str_srcs.emplace_back(path, text);
+}
+
+std::vector<Ptr<ast::ModuleDef>> ParallelParser::parse(unsigned jobs) {
+    auto& src_man = _ctx.src_man();
+    for (const auto& [path, text] : _str_srcs) {
+        if (!src_man.src(path))
+            src_man.string(text, path);
+    }
+
+    jobs = std::min<std::size_t>(jobs, _jobs.size());
+    if (jobs > 1) {
+        std::atomic<std::size_t> next{0};
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < jobs; ++i) {
+            workers.emplace_back([&]() {
+                std::size_t n;
+                while ((n = next.fetch_add(1)) < _jobs.size())
+                    run(_jobs[n]);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    std::vector<Ptr<ast::ModuleDef>> modules;
+    for (auto& job : _jobs)
+        modules.push_back(merge(job));
+    _jobs.clear();
+    _str_srcs.clear();
+    return modules;
+}
+
+void ParallelParser::run(Job& job) {
+    Context ctx;
+    ctx.options = _ctx.options;
+    ctx.diag().set_quiet(true);
+    UniqStrPool str_pool;
+    UniqStrPool text_pool;
+    Parser parser{ctx, str_pool, text_pool};
+    for (const auto& [path, text] : _str_srcs)
+        parser.add_str_src(text, path);
+
+    auto module = job.is_str ? parser.parse_module_str(job.text, job.path)
+                             : parser.parse_module_file(job.path);
+    if (!module || ctx.diag().err_num() > 0)
+        return;
+    job.data =
+        ast::write_module(ctx.src_man(), str_pool, text_pool, ref(module));
+}
+
+Ptr<ast::ModuleDef> ParallelParser::merge(Job& job) {
+    auto& src_man = _ctx.src_man();
+    if (!job.data.empty()) {
+        if (job.is_str)
+            src_man.string(job.text, job.path);
+        mem::Arena::Scope arena_scope{_arena};
+        auto module =
+            ast::read_module(src_man, _str_pool, _text_pool, job.data);
+        if (module)
+            return module;
+        // e.g. loaded file has changed, re-parse
+        debug() << "failed to merge " << job.path << "\n";
+    }
+
+    Parser parser{_ctx, _str_pool, _text_pool, _arena};
+    return job.is_str ? parser.parse_module_str(job.text, job.path)
+                      : parser.parse_module_file(job.path);
+}
+
+} // namespace ulam
@@ -0,0 +1,38 @@
+#include <libulam/parser/token_ring.hpp>
+#include <thread>
+
+namespace ulam {
+
+void TokenRing::reset(std::size_t size) {
+    ulam_assert(size >= MinSize && (size & (size - 1)) == 0);
+    if (_tokens.size() != size)
+        _tokens.resize(size);
+    _mask = size - 1;
+    _write.store(0, std::memory_order_relaxed);
+    _released.store(0, std::memory_order_relaxed);
+    _closed.store(false, std::memory_order_relaxed);
+    _eof.store(false, std::memory_order_relaxed);
+    _read = 0;
+    _released_local = 0;
+}
+
+bool TokenRing::wait_free(std::size_t write) {
+    while (write - _released.load(std::memory_order_acquire) == _mask + 1) {
+        if (_closed.load(std::memory_order_acquire))
+            return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+bool TokenRing::wait_next() {
+    while (!has_next()) {
+        // `Eof' is the last token written
+        if (_eof.load(std::memory_order_acquire))
+            return has_next();
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+} // namespace ulam
@@ -24,13 +24,25 @@ Preproc::Preproc(Context& ctx):
 
 void Preproc::main_file(Path path) {
     ulam_assert(_stack.empty());
-    auto src = _ctx.src_man().file(std::move(path));
+    // may be already registered by parse cache or parallel parser
+    auto& src_man = _ctx.src_man();
+    auto src = src_man.src(path);
+    if (!src)
+        src = src_man.file(std::move(path));
     push(src);
 }
 
 void Preproc::main_string(std::string text, Path path) {
     ulam_assert(_stack.empty());
-    auto src = _ctx.src_man().string(std::move(text), std::move(path));
+    // may be already registered by parallel parser
+    auto& src_man = _ctx.src_man();
+    auto src = src_man.src(path);
+    if (src) {
+        ulam_assert(dynamic_cast<StrSrc*>(src));
+        ulam_assert(src->content().size() == text.size() + 1);
+    } else {
+        src = src_man.string(std::move(text), std::move(path));
+    }
     push(src);
 }
 
@@ -39,7 +51,10 @@ void Preproc::add_string(std::string text, Path path) {
 }
 
 Preproc& Preproc::operator>>(Token& token) {
-    ulam_assert(!_stack.empty());
+    if (_stack.empty()) {
+        token = _eof;
+        return *this;
+    }
     while (true) {
         lex(token);
         token.orig_type = token.type;
@@ -91,8 +106,10 @@ Preproc& Preproc::operator>>(Token& token) {
             return *this;
         case tok::Eof:
             _stack.pop();
-            if (_stack.empty())
+            if (_stack.empty()) {
+                _eof = token;
                 return *this;
+            }
             break;
         default:
             return *this;
@@ -1,13 +1,89 @@
 #include <libulam/assert.hpp>
+#include <libulam/ast/nodes/access.hpp>
+#include <libulam/ast/nodes/expr.hpp>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/ast/serial.hpp>
+#include <libulam/memory/arena.hpp>
 #include <libulam/sema.hpp>
 #include <libulam/sema/init.hpp>
 #include <libulam/sema/resolver.hpp>
 #include <libulam/semantic/program.hpp>
+#include <set>
+#include <vector>
 
 namespace ulam::sema {
+namespace {
+
+using NameIdSet = std::set<str_id_t>;
+
+// changed module, modules depending on affected modules and modules
+// providing class templates to affected modules (template instances
+// may have types from affected modules as arguments)
+NameIdSet affected_modules(Ref<Program> program, str_id_t name_id) {
+    NameIdSet affected{name_id};
+    bool added = true;
+    while (added) {
+        added = false;
+        for (auto module : program->modules()) {
+            bool is_affected = affected.count(module->name_id()) > 0;
+            const auto& deps = is_affected ? module->tpl_deps() : module->deps();
+            for (auto dep_id : deps) {
+                if (is_affected) {
+                    added = affected.insert(dep_id).second || added;
+                } else if (affected.count(dep_id) > 0) {
+                    affected.insert(module->name_id());
+                    added = true;
+                    break;
+                }
+            }
+        }
+    }
+    return affected;
+}
+
+// call site, constant folding and local type caches can be keyed by
+// classes of removed modules
+void clear_caches(Ref<ast::Node> node) {
+    if (auto expr = dynamic_cast<Ref<ast::Expr>>(node))
+        expr->set_fold_cache({});
+    if (auto funcall = dynamic_cast<Ref<ast::FunCall>>(node))
+        funcall->set_call_cache({});
+    if (auto var_def = dynamic_cast<Ref<ast::VarDef>>(node))
+        var_def->set_type_cache({});
+    if (auto type_def = dynamic_cast<Ref<ast::TypeDef>>(node))
+        type_def->set_type_cache({});
+    for (unsigned n = 0; n < node->child_num(); ++n) {
+        auto child = node->child(n);
+        if (child)
+            clear_caches(child);
+    }
+}
+
+// AST without semantic attributes
+Ptr<ast::ModuleDef>
+copy_module(Context& ctx, Ref<ast::Root> ast, Ref<ast::ModuleDef> module_def) {
+    auto& src_man = ctx.src_man();
+    auto& str_pool = ast->ctx().str_pool();
+    auto& text_pool = ast->ctx().text_pool();
+    auto data = ast::write_module(src_man, str_pool, text_pool, module_def);
+    if (data.empty())
+        return {};
+    mem::Arena::Scope arena_scope{ast->ctx().arena()};
+    return ast::read_module(src_man, str_pool, text_pool, data);
+}
+
+} // namespace
 
 Ref<Program> init(Context& ctx, Ref<ast::Root> ast) {
-    ulam_assert(!ast->program());
+    if (ast->program()) {
+        // extending existing program, init modules added since
+        for (unsigned n = 0; n < ast->child_num(); ++n) {
+            auto module_def = ast->get(n);
+            if (!module_def->module())
+                init(ctx, ast, module_def);
+        }
+        return ast->program();
+    }
     ast->set_program(
         make<Program>(ctx, ast->ctx().str_pool(), ast->ctx().text_pool()));
     sema::Init init{ctx, ast};
@@ -21,6 +97,51 @@ Ref<Module> init(Context& ctx, Ref<ast::Root> ast, Ref<ast::ModuleDef> module_de
     return module_def->module();
 }
 
+Ref<Module>
+update(Context& ctx, Ref<ast::Root> ast, Ptr<ast::ModuleDef>&& module_def) {
+    auto module_def_ref = ref(module_def);
+    auto program = ast->program();
+    if (!program) {
+        ast->replace_module(std::move(module_def));
+        init(ctx, ast);
+        return module_def_ref->module();
+    }
+
+    // replaced ASTs are kept until modules are removed
+    std::vector<Ptr<ast::ModuleDef>> replaced;
+    auto affected = affected_modules(program, module_def->name_id());
+    for (unsigned n = 0; n < ast->child_num(); ++n) {
+        auto def = ast->get(n);
+        if (!def->module())
+            continue;
+        if (affected.count(def->name_id()) == 0) {
+            clear_caches(def);
+            continue;
+        }
+        if (def->name_id() == module_def->name_id())
+            continue;
+        auto copy = copy_module(ctx, ast, def);
+        if (!copy) {
+            ctx.diag().fatal(def, "failed to re-create module");
+            return {};
+        }
+        replaced.push_back(ast->replace_module(std::move(copy)));
+    }
+    auto prev = ast->replace_module(std::move(module_def));
+    if (prev)
+        replaced.push_back(std::move(prev));
+
+    for (auto name_id : affected) {
+        auto module = program->module(name_id);
+        if (module)
+            program->remove_module(module);
+    }
+    replaced.clear();
+
+    init(ctx, ast);
+    return module_def_ref->module();
+}
+
 bool resolve(EvalEnv& env) {
     env.resolver(false).resolve(env.program());
     return true; // TMP
@@ -50,8 +50,11 @@ void Out::print_class_registry() {
     hr();
     _os << "# class registry (" << list.size() << "):\n";
     hr();
-    for (const auto cls : list)
+    for (const auto cls : list) {
+        if (!cls)
+            continue;
         _os << std::setw(5) << cls->class_id() << " " << cls->name() << "\n";
+    }
     hr2();
 }
 
@@ -0,0 +1,532 @@
+#include <algorithm>
+#include <libulam/sema/eval/compiler.hpp>
+#include <libulam/sema/eval/env.hpp>
+#include <libulam/sema/resolver.hpp>
+#include <libulam/sema/resolver/local.hpp>
+#include <libulam/semantic/ops.hpp>
+#include <libulam/semantic/type/builtin/bool.hpp>
+#include <libulam/semantic/type/builtin/int.hpp>
+#include <libulam/semantic/type/builtin/unsigned.hpp>
+#include <libulam/semantic/type/builtin_type_id.hpp>
+#include <libulam/semantic/type/ops.hpp>
+#include <libulam/semantic/var.hpp>
+
+#ifdef DEBUG_EVAL
+#    define ULAM_DEBUG
+#    define ULAM_DEBUG_PREFIX "[ulam::sema::EvalCompiler] "
+#endif
+#include "src/debug.hpp"
+
+namespace ulam::sema {
+
+namespace {
+
+bool is_prim_value_type(Ref<Type> type) {
+    return type && !type->is_ref() && type->actual()->is_prim();
+}
+
+} // namespace
+
+Ptr<FunCode> EvalCompiler::compile(Ref<Fun> fun, Ref<Class> eff_cls) {
+    ulam_assert(fun->node()->has_body());
+    _fun = fun;
+    _code = make<FunCode>(eff_cls);
+    _loops.clear();
+
+    auto body = fun->body_node();
+    if (body->local_slot_num() == NoLocalSlot)
+        LocalResolver{}.resolve(fun->node());
+    auto slot_num = body->local_slot_num();
+
+    try {
+        if (slot_num == NoLocalSlot || slot_num >= FunCode::NoReg)
+            unsupported("too many locals");
+        _locals.assign(slot_num, {});
+        _tmp = slot_num;
+        _reg_num = slot_num;
+
+        auto ret_type = fun->ret_type();
+        if (!ret_type->is(VoidId) && !is_prim_value_type(ret_type))
+            unsupported("return type");
+        if (fun->has_ellipsis())
+            unsupported("ellipsis");
+
+        // params
+        for (auto param : fun->params()) {
+            if (param->is_const())
+                unsupported("const parameter");
+            if (!is_prim_value_type(param->type()))
+                unsupported("parameter type");
+            auto slot = param->node()->local_slot();
+            ulam_assert(slot < slot_num);
+            _locals[slot] = param->type();
+        }
+
+        stmt(body);
+        emit(Opcode::End);
+
+        _code->set_local_num(slot_num);
+        _code->set_reg_num(_reg_num);
+        _code->set_compiled();
+
+    } catch (const Unsupported& u) {
+        debug() << "cannot compile `" << fun->name() << "`: " << u.reason
+                << "\n";
+        _code = make<FunCode>(eff_cls);
+        _code->set_unsupported();
+    }
+    return std::move(_code);
+}
+
+void EvalCompiler::visit(Ref<ast::FunDefBody> node) {
+    for (unsigned n = 0; n < node->child_num(); ++n)
+        stmt(node->get(n));
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::Block> node) {
+    for (unsigned n = 0; n < node->child_num(); ++n)
+        stmt(node->get(n));
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::EmptyStmt> node) { _is_stmt_done = true; }
+
+void EvalCompiler::visit(Ref<ast::ExprStmt> node) {
+    if (node->has_expr())
+        effect(node->expr());
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::VarDefList> node) {
+    if (node->is_const())
+        unsupported("local constant");
+
+    auto type = env().resolver(false).resolve_type_name(node->type_name(), true);
+    if (!is_prim_value_type(type))
+        unsupported("variable type");
+    auto type_idx = _code->add_type(type);
+
+    for (unsigned n = 0; n < node->def_num(); ++n) {
+        auto def = node->def(n);
+        if (def->has_array_dims() || def->is_ref())
+            unsupported("variable type");
+        auto slot = def->local_slot();
+        if (slot == NoLocalSlot)
+            unsupported("unbound variable");
+
+        if (def->has_init()) {
+            auto& init = def->init()->get();
+            if (!init.is<Ptr<ast::Expr>>())
+                unsupported("variable initializer");
+            auto mark = _tmp;
+            auto init_expr = ref(init.get<Ptr<ast::Expr>>());
+            auto reg = expr(init_expr);
+            _node = init_expr;
+            emit(Opcode::Init, slot, reg, FunCode::NoReg, Op::None, type_idx);
+            _node = {};
+            _tmp = mark;
+        } else {
+            emit(
+                Opcode::InitDefault, slot, FunCode::NoReg, FunCode::NoReg,
+                Op::None, type_idx);
+        }
+        // variable is visible after its initializer
+        _locals[slot] = type;
+    }
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::If> node) {
+    std::vector<idx_t> else_jumps;
+    cond(node->cond(), else_jumps);
+    stmt(node->if_branch());
+    if (node->has_else_branch()) {
+        auto end_jump = jump(Opcode::Jump);
+        patch(else_jumps, _code->next_idx());
+        stmt(node->else_branch());
+        patch(end_jump);
+    } else {
+        patch(else_jumps, _code->next_idx());
+    }
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::For> node) {
+    if (node->has_init())
+        stmt(node->init());
+
+    auto loop = _code->add_loop();
+    emit(Opcode::LoopInit, loop);
+    auto start = _code->next_idx();
+    emit(Opcode::LoopCheck, loop);
+
+    std::vector<idx_t> end_jumps;
+    if (node->has_cond())
+        cond(node->cond(), end_jumps);
+
+    _loops.emplace_back();
+    if (node->has_body())
+        stmt(node->body());
+    auto loop_ = std::move(_loops.back());
+    _loops.pop_back();
+
+    // `continue` jumps to update expression
+    patch(loop_.continues, _code->next_idx());
+    if (node->has_upd())
+        effect(node->upd());
+    emit(Opcode::Jump, FunCode::NoReg, FunCode::NoReg, FunCode::NoReg,
+         Op::None, start);
+
+    patch(end_jumps, _code->next_idx());
+    patch(loop_.breaks, _code->next_idx());
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::While> node) {
+    auto loop = _code->add_loop();
+    emit(Opcode::LoopInit, loop);
+    auto start = _code->next_idx();
+    emit(Opcode::LoopCheck, loop);
+
+    std::vector<idx_t> end_jumps;
+    cond(node->cond(), end_jumps);
+
+    _loops.emplace_back();
+    if (node->has_body())
+        stmt(node->body());
+    auto loop_ = std::move(_loops.back());
+    _loops.pop_back();
+
+    patch(loop_.continues, start);
+    emit(Opcode::Jump, FunCode::NoReg, FunCode::NoReg, FunCode::NoReg,
+         Op::None, start);
+
+    patch(end_jumps, _code->next_idx());
+    patch(loop_.breaks, _code->next_idx());
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::Return> node) {
+    bool is_void = _fun->ret_type()->is(VoidId);
+    if (node->has_expr()) {
+        if (is_void)
+            unsupported("return value in Void function");
+        auto mark = _tmp;
+        auto reg = expr(node->expr());
+        _node = node;
+        emit(Opcode::Return, FunCode::NoReg, reg);
+        _node = {};
+        _tmp = mark;
+    } else {
+        if (!is_void)
+            unsupported("no return value");
+        emit(Opcode::ReturnVoid);
+    }
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::Break> node) {
+    if (_loops.empty())
+        unsupported("break outside of loop");
+    _loops.back().breaks.push_back(jump(Opcode::Jump));
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::Continue> node) {
+    if (_loops.empty())
+        unsupported("continue outside of loop");
+    _loops.back().continues.push_back(jump(Opcode::Jump));
+    _is_stmt_done = true;
+}
+
+void EvalCompiler::visit(Ref<ast::TypeOpExpr> node) {
+    // type operator of primitive type, e.g. `Int(8).maxof`
+    if (!node->has_type_name() || node->has_args() || node->has_base_type())
+        unsupported("type operator");
+    auto type = env().resolver(true).resolve_type_name(node->type_name(), true);
+    if (!type || !type->actual()->is_prim())
+        unsupported("type operator");
+    auto res = env().eval_expr(node);
+    if (!res || !res.value().is_consteval() || !is_prim_value_type(res.type()))
+        unsupported("type operator");
+    auto res_type = res.type();
+    _reg = constant({res_type, Value{res.move_value().move_rvalue()}});
+}
+
+void EvalCompiler::visit(Ref<ast::Ident> node) {
+    if (node->is_self() || node->is_super())
+        unsupported("self");
+
+    if (node->local_slot() != NoLocalSlot) {
+        _reg = local(node);
+        return;
+    }
+
+    // named constant
+    if (node->is_local())
+        unsupported("module local");
+    auto sym = scope()->get(node->name().str_id());
+    if (!sym || !sym->is<Var>())
+        unsupported("not a constant");
+    auto var = sym->get<Var>();
+    if (!var->is_const())
+        unsupported("not a constant");
+    if (!var->has_type() && !env().resolver(true).resolve(var))
+        unsupported("unresolved constant");
+    if (!is_prim_value_type(var->type()) || !var->has_value())
+        unsupported("constant type");
+    _reg = constant({var->type(), Value{var->rvalue()}});
+}
+
+void EvalCompiler::visit(Ref<ast::ParenExpr> node) {
+    _reg = expr(node->inner());
+}
+
+void EvalCompiler::visit(Ref<ast::BinaryOp> node) {
+    auto op = node->op();
+    if (ops::is_assign(op))
+        unsupported("assignment in expression");
+
+    auto mark = _tmp;
+    if (op == Op::And || op == Op::Or) {
+        // short-circuit, result is left operand
+        auto dst = tmp();
+        auto left = expr(node->lhs());
+        if (left != dst)
+            emit(Opcode::Move, dst, left);
+        auto end_jump =
+            jump((op == Op::Or) ? Opcode::JumpIfTrue : Opcode::JumpIfFalse, dst);
+        auto right = expr(node->rhs());
+        emit(Opcode::BinaryOp, dst, dst, right, op);
+        patch(end_jump);
+        _tmp = mark + 1;
+        _reg = dst;
+        return;
+    }
+
+    auto left = expr(node->lhs());
+    auto right = expr(node->rhs());
+    _tmp = mark;
+    auto dst = tmp();
+    emit(Opcode::BinaryOp, dst, left, right, op);
+    _reg = dst;
+}
+
+void EvalCompiler::visit(Ref<ast::UnaryOp> node) {
+    auto op = node->op();
+    if (node->has_type_name())
+        unsupported("`is` operator");
+    if (ops::is_inc_dec(op))
+        unsupported("increment in expression");
+
+    auto mark = _tmp;
+    auto arg = expr(node->arg());
+    _tmp = mark;
+    auto dst = tmp();
+    emit(Opcode::UnaryOp, dst, arg, FunCode::NoReg, op);
+    _reg = dst;
+}
+
+void EvalCompiler::visit(Ref<ast::Cast> node) {
+    auto type = env().resolver(true).resolve_full_type_name(
+        node->full_type_name(), true);
+    if (!is_prim_value_type(type))
+        unsupported("cast type");
+
+    auto mark = _tmp;
+    auto arg = expr(node->expr());
+    _tmp = mark;
+    auto dst = tmp();
+    emit(
+        Opcode::Cast, dst, arg, FunCode::NoReg, Op::None,
+        _code->add_type(type));
+    _reg = dst;
+}
+
+void EvalCompiler::visit(Ref<ast::BoolLit> node) {
+    // Bool(1)
+    auto type = builtins().boolean();
+    auto rval = type->construct(node->value());
+    rval.set_is_consteval(true);
+    _reg = constant({type, Value{std::move(rval)}});
+}
+
+void EvalCompiler::visit(Ref<ast::NumLit> node) {
+    const auto& number = node->value();
+    if (number.is_signed()) {
+        // Int(n)
+        auto type = builtins().int_type(number.bitsize());
+        auto rval = type->construct(number.value<Integer>(), value::IsConsteval);
+        _reg = constant({type, Value{std::move(rval)}});
+    } else {
+        // Unsigned(n)
+        auto type = builtins().unsigned_type(number.bitsize());
+        auto rval =
+            type->construct(number.value<Unsigned>(), value::IsConsteval);
+        _reg = constant({type, Value{std::move(rval)}});
+    }
+}
+
+void EvalCompiler::visit(Ref<ast::FunCall> node) {
+    // member function called by name, e.g. `foo(1, 2)`
+    if (!node->has_callable() || node->is_op_call())
+        unsupported("function call");
+    auto ident = dynamic_cast<Ref<ast::Ident>>(node->callable());
+    if (!ident || ident->is_self() || ident->is_super() || ident->is_local() ||
+        ident->local_slot() != NoLocalSlot)
+        unsupported("function call");
+
+    auto sym = scope()->get(ident->name().str_id());
+    if (!sym || !sym->is<FunSet>())
+        unsupported("function call");
+    auto fset = sym->get<FunSet>();
+    for (auto fun : *fset) {
+        // reference params can bind to lvalues only
+        for (auto param : fun->params()) {
+            if (!param->type() || param->type()->is_ref())
+                unsupported("reference parameter");
+        }
+        auto ret_type = fun->ret_type();
+        if (!ret_type || (!ret_type->is(VoidId) && !is_prim_value_type(ret_type)))
+            unsupported("callee return type");
+    }
+
+    auto mark = _tmp;
+    FunCode::Call call{node, fset, {}};
+    auto args = node->args();
+    for (unsigned n = 0; n < args->child_num(); ++n)
+        call.args.push_back(expr(args->get(n)));
+    _tmp = mark;
+    auto dst = tmp();
+    emit(
+        Opcode::Call, dst, FunCode::NoReg, FunCode::NoReg, Op::None,
+        _code->add_call(std::move(call)));
+    _reg = dst;
+}
+
+void EvalCompiler::stmt(Ref<ast::Stmt> node) {
+    if (auto expr_node = dynamic_cast<Ref<ast::Expr>>(node)) {
+        effect(expr_node);
+        return;
+    }
+    _is_stmt_done = false;
+    node->accept(*this);
+    if (!_is_stmt_done)
+        unsupported("statement");
+    _is_stmt_done = false;
+}
+
+EvalCompiler::reg_t EvalCompiler::expr(Ref<ast::Expr> node) {
+    auto prev_node = _node;
+    _node = node;
+    _reg = FunCode::NoReg;
+    node->accept(static_cast<ast::Visitor&>(*this));
+    if (_reg == FunCode::NoReg)
+        unsupported("expression");
+    auto reg = _reg;
+    _reg = FunCode::NoReg;
+    _node = prev_node;
+    return reg;
+}
+
+void EvalCompiler::effect(Ref<ast::Expr> node) {
+    auto mark = _tmp;
+    auto prev_node = _node;
+    _node = node;
+
+    // local variable assignment
+    auto binary_op = dynamic_cast<Ref<ast::BinaryOp>>(node);
+    if (binary_op && ops::is_assign(binary_op->op())) {
+        auto ident = dynamic_cast<Ref<ast::Ident>>(binary_op->lhs());
+        if (!ident || ident->local_slot() == NoLocalSlot)
+            unsupported("assignment");
+        auto to = local(ident);
+        auto from = expr(binary_op->rhs());
+        auto res = tmp();
+        _node = node;
+        emit(Opcode::BinaryOp, res, to, from, binary_op->op());
+        emit(Opcode::Assign, to, res);
+        _node = prev_node;
+        _tmp = mark;
+        return;
+    }
+
+    // local variable increment/decrement
+    auto unary_op = dynamic_cast<Ref<ast::UnaryOp>>(node);
+    if (unary_op && ops::is_inc_dec(unary_op->op())) {
+        auto ident = dynamic_cast<Ref<ast::Ident>>(unary_op->arg());
+        if (!ident || ident->local_slot() == NoLocalSlot)
+            unsupported("increment");
+        auto reg = local(ident);
+        auto error = unary_op_type_check(unary_op->op(), _locals[reg]);
+        if (error.status != TypeError::Ok)
+            unsupported("increment");
+        emit(Opcode::IncDec, FunCode::NoReg, reg, FunCode::NoReg,
+             unary_op->op());
+        _node = prev_node;
+        return;
+    }
+
+    expr(node);
+    _node = prev_node;
+    _tmp = mark;
+}
+
+void EvalCompiler::cond(Ref<ast::Cond> node, std::vector<idx_t>& jumps) {
+    if (node->is_as_cond())
+        unsupported("`as` condition");
+    auto mark = _tmp;
+    auto reg = expr(node->expr());
+    _node = node->expr();
+    jumps.push_back(jump(Opcode::JumpIfFalse, reg));
+    _node = {};
+    _tmp = mark;
+}
+
+EvalCompiler::reg_t EvalCompiler::local(Ref<ast::Ident> node) {
+    auto slot = node->local_slot();
+    if (slot >= _locals.size() || !_locals[slot])
+        unsupported("unbound local");
+    return slot;
+}
+
+EvalCompiler::reg_t EvalCompiler::tmp() {
+    if (_tmp + 1 >= FunCode::NoReg)
+        unsupported("too many registers");
+    auto reg = _tmp++;
+    _reg_num = std::max(_reg_num, _tmp);
+    return reg;
+}
+
+EvalCompiler::reg_t EvalCompiler::constant(TypedValue&& tv) {
+    auto reg = tmp();
+    emit(
+        Opcode::Const, reg, FunCode::NoReg, FunCode::NoReg, Op::None,
+        _code->add_const(std::move(tv)));
+    return reg;
+}
+
+EvalCompiler::idx_t EvalCompiler::emit(
+    Opcode opcode, reg_t a, reg_t b, reg_t c, Op op, idx_t idx) {
+    return _code->add({opcode, op, a, b, c, idx, _node});
+}
+
+EvalCompiler::idx_t EvalCompiler::jump(Opcode opcode, reg_t b) {
+    return emit(opcode, FunCode::NoReg, b);
+}
+
+void EvalCompiler::patch(idx_t idx) {
+    _code->instr(idx).idx = _code->next_idx();
+}
+
+void EvalCompiler::patch(const std::vector<idx_t>& jumps, idx_t target) {
+    for (auto idx : jumps)
+        _code->instr(idx).idx = target;
+}
+
+void EvalCompiler::unsupported(const char* reason) {
+    throw Unsupported{reason};
+}
+
+} // namespace ulam::sema
@@ -0,0 +1,38 @@
+#include <libulam/assert.hpp>
+#include <libulam/sema/eval/ctl.hpp>
+#include <utility>
+
+namespace ulam::sema {
+
+void EvalCtl::set_return(Ref<ast::Return> node, ExprRes&& res) {
+    ulam_assert(empty());
+    _kind = Return;
+    _node = node;
+    _res = std::move(res);
+}
+
+void EvalCtl::set_break() {
+    ulam_assert(empty());
+    _kind = Break;
+}
+
+void EvalCtl::set_continue() {
+    ulam_assert(empty());
+    _kind = Continue;
+}
+
+ExprRes EvalCtl::move_res() {
+    ulam_assert(is(Return));
+    ExprRes res;
+    std::swap(res, _res);
+    reset();
+    return res;
+}
+
+void EvalCtl::reset() {
+    _kind = None;
+    _node = {};
+    _res = {};
+}
+
+} // namespace ulam::sema
@@ -146,10 +146,19 @@ ExprRes EvalEnv::eval(Ref<ast::Block> block) {
                 auto expr_stmt = dynamic_cast<Ref<ast::ExprStmt>>(stmt);
                 if (expr_stmt) {
                     auto res = eval_expr(expr_stmt->expr());
+                    if (!res)
+                        return res;
                     return {res.type()->deref(), res.move_value().deref()};
                 }
             }
             eval_stmt(block->get(n));
+            if (_ctl.is(EvalCtl::Return)) {
+                // top-level `return`
+                auto res = _ctl.move_res();
+                if (!res)
+                    return res;
+                return {res.type()->deref(), res.move_value().deref()};
+            }
         }
     } catch (EvalExceptError& e) {
         // TODO: return status
@@ -158,9 +167,9 @@ ExprRes EvalEnv::eval(Ref<ast::Block> block) {
     return {builtins().type(VoidId), Value{RValue{}}};
 }
 
-ExprRes EvalEnv::eval_noexec(Ref<Fun> fun) {
+ExprRes EvalEnv::eval_noexec(Ref<Fun> fun, Ref<Class> eff_cls) {
     EvalFuncall ef{*this};
-    return ef.eval_noexec(fun);
+    return ef.eval_noexec(fun, eff_cls);
 }
 
 void EvalEnv::eval_stmt(Ref<ast::Stmt> stmt) {
@@ -249,8 +258,9 @@ ExprRes EvalEnv::funcall(
     return do_funcall(ef, node, fun, std::move(obj), std::move(args));
 }
 
-EvalEnv::StackRaii EvalEnv::stack_raii(Ref<Fun> fun, LValue self) {
-    return _stack.raii(fun, self);
+EvalEnv::StackRaii
+EvalEnv::stack_raii(Ref<Fun> fun, LValue self, local_slot_t slot_num) {
+    return _stack.raii(fun, self, slot_num);
 }
 
 EvalEnv::ScopeRaii EvalEnv::scope_raii(scope_flags_t flags) {
@@ -315,6 +325,12 @@ const EvalStack::Item& EvalEnv::stack_top() const {
 
 std::size_t EvalEnv::stack_size() const { return _stack.size(); }
 
+Ref<Var> EvalEnv::local_var(local_slot_t slot) { return _stack.local(slot); }
+
+Ref<Var> EvalEnv::set_local_var(local_slot_t slot, Ptr<Var>&& var) {
+    return _stack.set_local(slot, std::move(var));
+}
+
 Scope* EvalEnv::scope() {
     return _scope_override ? _scope_override : _scope_stack.top();
 }
@@ -28,6 +28,8 @@ namespace ulam::sema {
 
 ExprRes EvalExprVisitor::visit(Ref<ast::TypeOpExpr> node) {
     debug() << __FUNCTION__ << " TypeOpExpr\n" << line_at(node);
+    if (auto res = folded(node))
+        return res;
     ExprRes res;
     if (node->has_type_name()) {
         auto resolver = env().resolver(true);
@@ -42,7 +44,7 @@ ExprRes EvalExprVisitor::visit(Ref<ast::TypeOpExpr> node) {
             return expr_res;
         res = type_op_expr(node, std::move(expr_res));
     }
-    return check(node, std::move(res));
+    return fold(node, check(node, std::move(res)));
 }
 
 ExprRes EvalExprVisitor::visit(Ref<ast::Ident> node) {
@@ -57,6 +59,13 @@ ExprRes EvalExprVisitor::visit(Ref<ast::Ident> node) {
     if (node->is_super())
         return check(node, ident_super(node));
 
+    // local variable
+    if (node->local_slot() != NoLocalSlot) {
+        auto var = env().local_var(node->local_slot());
+        if (var)
+            return check(node, ident_var(node, var));
+    }
+
     auto name_id = node->name().str_id();
     Scope::Symbol* sym{};
     {
@@ -86,6 +95,8 @@ ExprRes EvalExprVisitor::visit(Ref<ast::ParenExpr> node) {
 ExprRes EvalExprVisitor::visit(Ref<ast::BinaryOp> node) {
     debug() << __FUNCTION__ << " BinaryOp\n" << line_at(node);
     ulam_assert(node->has_lhs() && node->has_rhs());
+    if (auto res = folded(node))
+        return res;
 
     Op op = node->op();
 
@@ -107,22 +118,26 @@ ExprRes EvalExprVisitor::visit(Ref<ast::BinaryOp> node) {
 
     auto res = binary_op(
         node, op, node->lhs(), std::move(left), node->rhs(), std::move(right));
-    return check(node, std::move(res));
+    return fold(node, check(node, std::move(res)));
 }
 
 ExprRes EvalExprVisitor::visit(Ref<ast::UnaryOp> node) {
     debug() << __FUNCTION__ << " UnaryOp\n" << line_at(node);
+    if (auto res = folded(node))
+        return res;
     auto arg = node->arg()->accept(*this);
     if (!arg)
         return arg;
 
     auto res = unary_op(
         node, node->op(), node->arg(), std::move(arg), node->type_name());
-    return check(node, std::move(res));
+    return fold(node, check(node, std::move(res)));
 }
 
 ExprRes EvalExprVisitor::visit(Ref<ast::Cast> node) {
     debug() << __FUNCTION__ << " Cast\n" << line_at(node);
+    if (auto res = folded(node))
+        return res;
     // eval expr
     auto res = node->expr()->accept(*this);
     if (!res)
@@ -140,11 +155,13 @@ ExprRes EvalExprVisitor::visit(Ref<ast::Cast> node) {
         return {builtins().void_type(), Value{RValue{}}};
 
     res = env().cast(node, cast_type, std::move(res), true);
-    return check(node, std::move(res));
+    return fold(node, check(node, std::move(res)));
 }
 
 ExprRes EvalExprVisitor::visit(Ref<ast::Ternary> node) {
     debug() << __FUNCTION__ << " Ternary\n" << line_at(node);
+    if (auto res = folded(node))
+        return res;
 
     auto cond_res = ternary_eval_cond(node);
     if (!cond_res)
@@ -163,9 +180,10 @@ ExprRes EvalExprVisitor::visit(Ref<ast::Ternary> node) {
         return {ExprError::TernaryNonMatchingTypes};
     }
 
-    return ternary_eval(
-        node, std::move(cond_res), type, std::move(if_true_res),
-        std::move(if_false_res));
+    return fold(
+        node, ternary_eval(
+                  node, std::move(cond_res), type, std::move(if_true_res),
+                  std::move(if_false_res)));
 }
 
 Ref<Type>
@@ -369,6 +387,35 @@ ExprRes EvalExprVisitor::check(Ref<ast::Expr> node, ExprRes&& res) {
     return std::move(res);
 }
 
+ExprRes EvalExprVisitor::folded(Ref<ast::Expr> node) {
+    auto cache = node->fold_cache();
+    if (!cache || cache->is_disabled() ||
+        !program()->eval_options().fold_consts)
+        return {};
+    auto tv = cache->is_ctx_free()
+                  ? cache->get({}, {})
+                  : cache->get(scope()->self_cls(), scope()->eff_cls());
+    if (!tv.type())
+        return {};
+    return {std::move(tv)};
+}
+
+ExprRes EvalExprVisitor::fold(Ref<ast::Expr> node, ExprRes&& res) {
+    auto cache = node->fold_cache();
+    if (!cache || cache->is_disabled() || !res ||
+        !program()->eval_options().fold_consts ||
+        has_flag(evl::ReadOnlyCaches))
+        return std::move(res);
+    if (!res.value().is_consteval()) {
+        cache->disable();
+    } else if (cache->is_ctx_free()) {
+        cache->add({}, {}, res.typed_value());
+    } else {
+        cache->add(scope()->self_cls(), scope()->eff_cls(), res.typed_value());
+    }
+    return std::move(res);
+}
+
 bool EvalExprVisitor::check_is_assignable(
     Ref<ast::Expr> node, const Value& value) {
     if (value.is_rvalue()) {
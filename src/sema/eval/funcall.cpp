@@ -1,11 +1,17 @@
 #include "libulam/semantic/utils/strf.hpp"
 #include "libulam/semantic/value/flags.hpp"
+#include <libulam/ast/nodes/access.hpp>
 #include <libulam/ast/nodes/module.hpp>
 #include <libulam/sema/eval/cast.hpp>
+#include <libulam/sema/eval/ctl.hpp>
 #include <libulam/sema/eval/env.hpp>
-#include <libulam/sema/eval/except.hpp>
 #include <libulam/sema/eval/flags.hpp>
 #include <libulam/sema/eval/funcall.hpp>
+#include <libulam/sema/eval/native.hpp>
+#include <libulam/sema/eval/vm.hpp>
+#include <libulam/sema/resolver/fold.hpp>
+#include <libulam/sema/resolver/local.hpp>
+#include <libulam/semantic/fun/call_cache.hpp>
 #include <libulam/semantic/type/builtin/void.hpp>
 #include <libulam/semantic/value/bound_fun_set.hpp>
 
@@ -17,11 +23,13 @@
 
 namespace ulam::sema {
 
-ExprRes EvalFuncall::eval_noexec(Ref<Fun> fun) {
+ExprRes EvalFuncall::eval_noexec(Ref<Fun> fun, Ref<Class> eff_cls) {
+    if (!eff_cls)
+        eff_cls = fun->cls();
     auto fr = env().add_flags_raii(evl::NoExec);
     auto obj = LValue::make_ph(LValue::DefaultFlags & ~value::IsXvalue);
     auto args = make_args_ph(fun);
-    return do_funcall(fun->node(), fun, obj, std::move(args), fun->cls());
+    return do_funcall(fun->node(), fun, obj, std::move(args), eff_cls);
 }
 
 ExprRes EvalFuncall::construct(
@@ -30,11 +38,10 @@ ExprRes EvalFuncall::construct(
         return {ExprError::NoMatchingFunction};
 
     auto rval = cls->construct_default();
-    auto [match_res, error] =
-        find_match(node, cls->constructors(), cls, args.typed_value_refs());
+    auto [fun, error] =
+        find_fun(node, cls->constructors(), cls, args.typed_value_refs());
     if (error != ExprError::Ok)
         return {error};
-    auto fun = *match_res.begin();
 
     args = cast_args(node, fun, std::move(args));
     return construct_funcall(node, cls, fun, std::move(rval), std::move(args));
@@ -55,11 +62,10 @@ EvalFuncall::call(Ref<ast::Node> node, ExprRes&& callable, ExprResList&& args) {
     const auto& bfset = val.lvalue().get<BoundFunSet>();
 
     auto fset = bfset.fset();
-    auto [match_res, error] =
-        find_match(node, fset, bfset.dyn_cls(), args.typed_value_refs());
+    auto [fun, error] =
+        find_fun(node, fset, bfset.dyn_cls(), args.typed_value_refs());
     if (error != ExprError::Ok)
         return {error};
-    auto fun = *match_res.begin();
 
     args = cast_args(node, fun, std::move(args));
     return funcall_callable(
@@ -131,7 +137,18 @@ ExprRes EvalFuncall::do_funcall(
 
     if (self.has_auto_scope_lvl())
         self.set_scope_lvl(env().scope_lvl() + 1);
-    auto stack_raii = env().stack_raii(fun, self);
+
+    // compiled?
+    const auto& options = program()->eval_options();
+    if (options.bytecode && options.local_slots &&
+        (flags() & ~evl::ReadOnlyCaches) == evl::NoFlags) {
+        auto res = EvalVm{env()}.call(fun, self, eff_cls, args);
+        if (!res.is_nil())
+            return res;
+    }
+
+    auto stack_raii = env().stack_raii(fun, self, local_slot_num(fun));
+    fold_consts(fun);
     auto sr = env().fun_scope_raii(fun, self, eff_cls);
 
     // bind params
@@ -160,22 +177,27 @@ ExprRes EvalFuncall::do_funcall(
         auto var = make<Var>(
             param->type_node(), param->node(), param->type(), param->flags());
         var->set_value(arg.move_value());
-        scope()->set(var->name_id(), std::move(var));
+        auto slot = param->node()->local_slot();
+        if (slot != NoLocalSlot) {
+            env().set_local_var(slot, std::move(var));
+        } else {
+            scope()->set(var->name_id(), std::move(var));
+        }
     }
 
     // eval
-    try {
-        env().eval_stmt(fun->body_node());
-    } catch (EvalExceptReturn& ret) {
-        debug() << "}\n";
+    env().eval_stmt(fun->body_node());
+    debug() << "}\n";
+    auto& ctl = env().ctl();
+    if (ctl.is(EvalCtl::Return)) {
 #ifdef ULAM_DEBUG
         utils::Strf strf{program()};
-        debug() << "retval: " << strf.str(fun->ret_type(), ret.res().value())
+        debug() << "retval: " << strf.str(fun->ret_type(), ctl.res().value())
                 << "\n";
 #endif
-        return ret.move_res();
+        return ctl.move_res();
     }
-    debug() << "}\n";
+    ulam_assert(ctl.empty());
 
     auto ret_type = fun->ret_type();
     if (!ret_type->is(VoidId)) {
@@ -187,9 +209,40 @@ ExprRes EvalFuncall::do_funcall(
 
 ExprRes EvalFuncall::do_funcall_native(
     Ref<ast::Node> node, Ref<Fun> fun, LValue self, ExprResList&& args) {
-    // can't eval, return empty value
-    diag().notice(node, "cannot evaluate native function");
-    return empty_ret_val(node, fun);
+    auto native = (has_flag(evl::ReadOnlyCaches) && !fun->is_native_bound())
+                      ? program()->natives().find(fun)
+                      : program()->natives().bind(fun);
+    if (!native) {
+        // can't eval, return empty value
+        diag().notice(node, "cannot evaluate native function");
+        return empty_ret_val(node, fun);
+    }
+    if (has_flag(evl::NoExec))
+        return empty_ret_val(node, fun);
+
+    NativeCall call{env(), node, fun, self, args, native->data};
+    return native->fun(call);
+}
+
+local_slot_t EvalFuncall::local_slot_num(Ref<Fun> fun) {
+    auto body = fun->body_node();
+    if (body->local_slot_num() == NoLocalSlot) {
+        // not bound by LocalResolver, locals are looked up in scope
+        if (!program()->eval_options().local_slots ||
+            has_flag(evl::ReadOnlyCaches))
+            return 0;
+        LocalResolver{}.resolve(fun->node());
+        ulam_assert(body->local_slot_num() != NoLocalSlot);
+    }
+    return body->local_slot_num();
+}
+
+void EvalFuncall::fold_consts(Ref<Fun> fun) {
+    // locals must be bound first, see EvalFuncall::local_slot_num
+    if (program()->eval_options().fold_consts &&
+        !fun->body_node()->is_const_folded() &&
+        !has_flag(evl::ReadOnlyCaches))
+        ConstFolder{}.mark(fun->node());
 }
 
 ExprResList EvalFuncall::make_args_ph(Ref<Fun> fun) {
@@ -213,14 +266,44 @@ ExprRes EvalFuncall::empty_ret_val(Ref<ast::Node> node, Ref<Fun> fun) {
     return {ret_type, std::move(val)};
 }
 
-std::pair<FunSet::Matches, ExprError> EvalFuncall::find_match(
+std::pair<Ref<Fun>, ExprError> EvalFuncall::find_fun(
     Ref<ast::Node> node,
     Ref<FunSet> fset,
     Ref<Class> dyn_cls,
     const TypedValueRefList& args) {
 
+    auto funcall = dynamic_cast<Ref<ast::FunCall>>(node);
+    bool read_only = has_flag(evl::ReadOnlyCaches);
+    Ref<FunCallCache> cache{};
+    if (funcall && FunCallCache::is_cacheable(args)) {
+        if (!funcall->call_cache() && !read_only)
+            funcall->set_call_cache(make<FunCallCache>());
+        cache = funcall->call_cache();
+    }
+    if (cache) {
+        auto fun = cache->get(fset, args);
+        if (fun)
+            return {fun->dispatch(dyn_cls), ExprError::Ok};
+    }
+
+    auto matches = fset->find_match(args);
+    if (cache && !read_only && matches.size() == 1) {
+        // cache match before dispatch
+        cache->add(fset, args, *matches.begin());
+    }
+    auto [match_res, error] = find_match(node, matches, dyn_cls);
+    if (error != ExprError::Ok)
+        return {Ref<Fun>{}, error};
+    return {*match_res.begin(), ExprError::Ok};
+}
+
+std::pair<FunSet::Matches, ExprError> EvalFuncall::find_match(
+    Ref<ast::Node> node,
+    const FunSet::Matches& matches,
+    Ref<Class> dyn_cls) {
+
     auto error = ExprError::Ok;
-    auto match_res = fset->find_match(dyn_cls, args);
+    auto match_res = FunSet::dispatch(matches, dyn_cls);
     if (match_res.empty()) {
         diag().error(node, "no matching functions found");
         error = ExprError::NoMatchingFunction;
@@ -0,0 +1,45 @@
+#include <libulam/assert.hpp>
+#include <libulam/sema/eval/native.hpp>
+#include <libulam/semantic/fun.hpp>
+#include <libulam/semantic/type/class.hpp>
+
+namespace ulam::sema {
+
+void NativeRegistry::add(
+    const std::string_view cls_name,
+    const std::string_view fun_name,
+    native_fun_t fun,
+    void* data) {
+    ulam_assert(fun);
+    auto [_, added] =
+        _map.emplace(key(cls_name, fun_name), NativeFun{fun, data});
+    ulam_assert(added);
+}
+
+bool NativeRegistry::has(
+    const std::string_view cls_name, const std::string_view fun_name) const {
+    return _map.count(key(cls_name, fun_name)) == 1;
+}
+
+Ref<const NativeFun> NativeRegistry::find(Ref<Fun> fun) const {
+    if (!fun->has_cls())
+        return {};
+    auto it = _map.find(key(fun->cls()->mangled_name(), fun->mangled_name()));
+    return (it != _map.end()) ? &it->second : Ref<const NativeFun>{};
+}
+
+Ref<const NativeFun> NativeRegistry::bind(Ref<Fun> fun) const {
+    if (!fun->is_native_bound())
+        fun->set_native(find(fun));
+    return fun->native();
+}
+
+std::string NativeRegistry::key(
+    const std::string_view cls_name, const std::string_view fun_name) {
+    std::string key{cls_name};
+    key += '.';
+    key += fun_name;
+    return key;
+}
+
+} // namespace ulam::sema
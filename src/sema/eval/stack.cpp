@@ -3,24 +3,44 @@
 
 namespace ulam::sema {
 
-EvalStack::Raii::Raii(EvalStack& stack, Ref<Fun> fun, LValue self):
+EvalStack::Raii::Raii(
+    EvalStack& stack, Ref<Fun> fun, LValue self, local_slot_t slot_num):
     _stack{stack} {
-    _stack.push(fun, std::move(self));
+    _stack.push(fun, std::move(self), slot_num);
 }
 
 EvalStack::Raii::~Raii() { _stack.pop(); }
 
-EvalStack::Raii EvalStack::raii(Ref<Fun> fun, LValue self) {
-    return {*this, fun, std::move(self)};
+EvalStack::Raii
+EvalStack::raii(Ref<Fun> fun, LValue self, local_slot_t slot_num) {
+    return {*this, fun, std::move(self), slot_num};
 }
 
-void EvalStack::push(Ref<Fun> fun, LValue self) {
-    _stack.emplace(fun, std::move(self));
+void EvalStack::push(Ref<Fun> fun, LValue self, local_slot_t slot_num) {
+    auto frame_off = _locals.size();
+    _locals.resize(frame_off + slot_num);
+    _stack.emplace(fun, std::move(self), frame_off);
 }
 
 void EvalStack::pop() {
     ulam_assert(!empty());
+    _locals.resize(top().frame_off());
     _stack.pop();
 }
 
+Ref<Var> EvalStack::local(local_slot_t slot) {
+    if (empty())
+        return {};
+    auto idx = top().frame_off() + slot;
+    return (idx < _locals.size()) ? ref(_locals[idx]) : Ref<Var>{};
+}
+
+Ref<Var> EvalStack::set_local(local_slot_t slot, Ptr<Var>&& var) {
+    ulam_assert(!empty());
+    auto idx = top().frame_off() + slot;
+    ulam_assert(idx < _locals.size());
+    _locals[idx] = std::move(var);
+    return ref(_locals[idx]);
+}
+
 } // namespace ulam::sema
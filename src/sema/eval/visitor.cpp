@@ -1,4 +1,5 @@
 #include <libulam/assert.hpp>
+#include <libulam/sema/eval/ctl.hpp>
 #include <libulam/sema/eval/env.hpp>
 #include <libulam/sema/eval/except.hpp>
 #include <libulam/sema/eval/visitor.hpp>
@@ -6,6 +7,7 @@
 #include <libulam/semantic/program.hpp>
 #include <libulam/semantic/scope/flags.hpp>
 #include <libulam/semantic/type.hpp>
+#include <libulam/semantic/type/local_cache.hpp>
 #include <utility>
 
 #ifdef DEBUG_EVAL
@@ -16,6 +18,18 @@
 
 namespace ulam::sema {
 
+namespace {
+
+// node cache is not created if caches are read-only
+template <typename N>
+Ref<LocalTypeCache> type_cache(Ref<N> node, bool is_read_only) {
+    if (!node->type_cache() && !is_read_only)
+        node->set_type_cache(make<LocalTypeCache>());
+    return node->type_cache();
+}
+
+} // namespace
+
 void EvalVisitor::visit(Ref<ast::TypeDef> node) {
     debug() << __FUNCTION__ << " TypeDef\n";
     type_def(node);
@@ -31,13 +45,13 @@ void EvalVisitor::visit(Ref<ast::VarDefList> node) {
 void EvalVisitor::visit(Ref<ast::Block> node) {
     debug() << __FUNCTION__ << " Block\n";
     auto sr = env().scope_raii();
-    for (unsigned n = 0; n < node->child_num(); ++n)
+    for (unsigned n = 0; n < node->child_num() && !env().ctl(); ++n)
         node->get(n)->accept(*this);
 }
 
 void EvalVisitor::visit(Ref<ast::FunDefBody> node) {
     debug() << __FUNCTION__ << " FunDefBody\n";
-    for (unsigned n = 0; n < node->child_num(); ++n)
+    for (unsigned n = 0; n < node->child_num() && !env().ctl(); ++n)
         node->get(n)->accept(*this);
 }
 
@@ -68,17 +82,30 @@ void EvalVisitor::visit(Ref<ast::For> node) {
         node->init()->accept(*this);
 
     auto loop = [&]() -> bool {
-        if (node->has_body()) {
-            try {
-                node->body()->accept(*this);
-            } catch (const EvalExceptContinue&) {
-                debug() << "continue\n";
-            } catch (const EvalExceptBreak&) {
-                debug() << "break\n";
-                return true;
-            }
+        if (!node->has_body())
+            return false;
+        node->body()->accept(*this);
+        return loop_ctl();
+    };
+
+    auto cond_loop = [&]() -> bool {
+        if (!node->has_cond())
+            return loop();
+        auto [is_true, as_cond_ctx] = env().eval_cond(node->cond());
+        if (!is_true)
+            return true;
+        if (!as_cond_ctx.empty()) {
+            auto sr = env().as_cond_scope_raii(as_cond_ctx);
+            return loop();
         }
-        return false;
+        return loop();
+    };
+
+    auto iter = [&]() -> bool {
+        bool done = cond_loop();
+        if (!done && node->has_upd())
+            node->upd()->accept(*this);
+        return done;
     };
 
     bool done = false;
@@ -87,36 +114,26 @@ void EvalVisitor::visit(Ref<ast::For> node) {
         if (loop_count++ == program()->eval_options().max_loop_iterations)
             throw EvalExceptError("for loop limit exceeded");
 
-        auto sr = env().scope_raii();
-        if (node->has_cond()) {
-            auto [is_true, as_cond_ctx] = env().eval_cond(node->cond());
-            done = !is_true;
-            if (!done) {
-                if (!as_cond_ctx.empty()) {
-                    auto sr = env().as_cond_scope_raii(as_cond_ctx);
-                    done = loop();
-                } else {
-                    done = loop();
-                }
-            }
+        // iteration scope is not needed if all locals are in frame slots
+        if (node->has_scope_defs()) {
+            auto sr = env().scope_raii();
+            done = iter();
         } else {
-            done = loop();
+            done = iter();
         }
-
-        if (!done && node->has_upd())
-            node->upd()->accept(*this);
     }
 }
 
 void EvalVisitor::visit(Ref<ast::Return> node) {
     debug() << __FUNCTION__ << " Return\n";
-    throw EvalExceptReturn(node, ret_res(node));
+    auto res = ret_res(node);
+    env().ctl().set_return(node, std::move(res));
 }
 
 void EvalVisitor::visit(Ref<ast::Break> node) {
     debug() << __FUNCTION__ << " Break\n";
     if (scope()->in(scp::Break)) {
-        throw EvalExceptBreak();
+        env().ctl().set_break();
     } else {
         diag().error(node, "unexpected break");
     }
@@ -125,7 +142,7 @@ void EvalVisitor::visit(Ref<ast::Break> node) {
 void EvalVisitor::visit(Ref<ast::Continue> node) {
     debug() << __FUNCTION__ << " Continue\n";
     if (scope()->in(scp::Continue)) {
-        throw EvalExceptContinue();
+        env().ctl().set_continue();
     } else {
         diag().error(node, "unexpected continue");
     }
@@ -148,17 +165,23 @@ void EvalVisitor::visit(Ref<ast::While> node) {
     auto sr = env().scope_raii(scp::BreakAndContinue);
 
     auto loop = [&]() -> bool {
-        if (node->has_body()) {
-            try {
-                node->body()->accept(*this);
-            } catch (const EvalExceptContinue&) {
-                debug() << "continue\n";
-            } catch (const EvalExceptBreak&) {
-                debug() << "break\n";
-                return true;
-            }
+        if (!node->has_body())
+            return false;
+        node->body()->accept(*this);
+        return loop_ctl();
+    };
+
+    auto iter = [&]() -> bool {
+        if (!node->has_cond())
+            return loop();
+        auto [is_true, as_cond_ctx] = env().eval_cond(node->cond());
+        if (!is_true)
+            return true;
+        if (!as_cond_ctx.empty()) {
+            auto sr = env().as_cond_scope_raii(as_cond_ctx);
+            return loop();
         }
-        return false;
+        return loop();
     };
 
     bool done = false;
@@ -167,20 +190,11 @@ void EvalVisitor::visit(Ref<ast::While> node) {
         if (loop_count++ == program()->eval_options().max_loop_iterations)
             throw EvalExceptError("for loop limit exceeded");
 
-        auto sr = env().scope_raii();
-        if (node->has_cond()) {
-            auto [is_true, as_cond_ctx] = env().eval_cond(node->cond());
-            done = !is_true;
-            if (!done) {
-                if (!as_cond_ctx.empty()) {
-                    auto sr = env().as_cond_scope_raii(as_cond_ctx);
-                    done = loop();
-                } else {
-                    done = loop();
-                }
-            }
+        if (node->has_scope_defs()) {
+            auto sr = env().scope_raii();
+            done = iter();
         } else {
-            done = loop();
+            done = iter();
         }
     }
 }
@@ -205,16 +219,46 @@ void EvalVisitor::visit(Ref<ast::TypeOpExpr> node) { env().eval_expr(node); }
 void EvalVisitor::visit(Ref<ast::Ident> node) { env().eval_expr(node); }
 
 Ref<AliasType> EvalVisitor::type_def(Ref<ast::TypeDef> node) {
+    Ref<LocalTypeCache> cache{};
+    if (program()->eval_options().cache_local_types) {
+        cache = type_cache(node, has_flag(evl::ReadOnlyCaches));
+        auto type =
+            cache ? cache->get(scope()->self_cls(), scope()->eff_cls())
+                  : Ref<Type>{};
+        if (type) {
+            auto alias = type->as_alias();
+            scope()->set(alias->name_id(), Ref<UserType>{alias});
+            return alias;
+        }
+    }
+
     Ptr<UserType> type = make<AliasType>(str_pool(), builtins(), nullptr, node);
     auto ref = ulam::ref(type);
     if (!env().resolver(false).resolve(type->as_alias()))
         throw EvalExceptError("failed to resolve type");
-    scope()->set(type->name_id(), std::move(type));
+    if (cache && !has_flag(evl::ReadOnlyCaches)) {
+        // cache owns alias, so that variable types referring to it remain
+        // valid after leaving scope
+        cache->add(scope()->self_cls(), scope()->eff_cls(), std::move(type));
+        scope()->set(ref->name_id(), ref);
+    } else {
+        scope()->set(type->name_id(), std::move(type));
+    }
     return ref->as_alias();
 }
 
 Ref<Var> EvalVisitor::var_def(
     Ref<ast::TypeName> type_name, Ref<ast::VarDef> node, bool is_const) {
+    auto slot = node->local_slot();
+    if (slot != NoLocalSlot) {
+        // slot keeps its variable until the frame is popped, type is
+        // resolved once per frame, value is reset on re-entry
+        auto var = env().local_var(slot);
+        if (var)
+            return reset_var(var);
+        return env().set_local_var(
+            slot, make_var(type_name, node, is_const));
+    }
     auto var = make_var(type_name, node, is_const);
     if (!var)
         return {};
@@ -226,15 +270,55 @@ Ref<Var> EvalVisitor::var_def(
 Ptr<Var> EvalVisitor::make_var(
     Ref<ast::TypeName> type_name, Ref<ast::VarDef> node, bool is_const) {
     auto var_flags = is_const ? Var::Const : Var::NoFlags;
-    auto var = make<Var>(type_name, node, Ref<Type>{}, var_flags);
+
+    // cached type?
+    Ref<LocalTypeCache> cache{};
+    Ref<Type> type{};
+    if (program()->eval_options().cache_local_types) {
+        cache = type_cache(node, has_flag(evl::ReadOnlyCaches));
+        if (cache)
+            type = cache->get(scope()->self_cls(), scope()->eff_cls());
+    }
+
+    auto var = make<Var>(type_name, node, type, var_flags);
     var->set_scope_lvl(env().stack_size());
     if (!env().resolver(false).resolve(ref(var)))
         return {};
+    if (cache && !type && !has_flag(evl::ReadOnlyCaches))
+        cache->add(scope()->self_cls(), scope()->eff_cls(), var->type());
     debug() << "new var: " << str(var->name_id())
             << ", scope lvl: " << var->scope_lvl() << "\n";
     return var;
 }
 
+Ref<Var> EvalVisitor::reset_var(Ref<Var> var) {
+    ulam_assert(var->has_type());
+    var->set_value(Value{RValue{}});
+    var->set_state(Var::NotResolved);
+    if (!env().resolver(false).resolve(var))
+        return {};
+    return var;
+}
+
+bool EvalVisitor::loop_ctl() {
+    auto& ctl = env().ctl();
+    switch (ctl.kind()) {
+    case EvalCtl::None:
+        return false;
+    case EvalCtl::Continue:
+        debug() << "continue\n";
+        ctl.reset();
+        return false;
+    case EvalCtl::Break:
+        debug() << "break\n";
+        ctl.reset();
+        return true;
+    case EvalCtl::Return:
+        return true;
+    }
+    unreachable();
+}
+
 ExprRes EvalVisitor::ret_res(Ref<ast::Return> node) {
     auto res = node->has_expr()
         ? env().eval_expr(node->expr())
@@ -0,0 +1,363 @@
+#include <libulam/sema/eval/compiler.hpp>
+#include <libulam/sema/eval/env.hpp>
+#include <libulam/sema/eval/except.hpp>
+#include <libulam/sema/eval/vm.hpp>
+#include <libulam/sema/resolver/local.hpp>
+#include <libulam/semantic/ops.hpp>
+#include <libulam/semantic/type/builtin/fun.hpp>
+#include <libulam/semantic/type/builtin/void.hpp>
+#include <libulam/semantic/type/builtin_type_id.hpp>
+#include <libulam/semantic/type/ops.hpp>
+#include <libulam/semantic/type/prim.hpp>
+#include <libulam/semantic/var.hpp>
+
+#ifdef DEBUG_EVAL
+#    define ULAM_DEBUG
+#    define ULAM_DEBUG_PREFIX "[ulam::sema::EvalVm] "
+#endif
+#include "src/debug.hpp"
+
+namespace ulam::sema {
+
+ExprRes EvalVm::call(
+    Ref<Fun> fun, LValue self, Ref<Class> eff_cls, ExprResList& args) {
+    auto code = compile(fun, self, eff_cls);
+    if (!code || code->is_disabled())
+        return {};
+
+    _fun = fun;
+    _code = code;
+    _self = self;
+    _regs.resize(code->reg_num());
+    _loops.resize(code->loop_num());
+
+    // bind params, keeping arguments for fallback
+    auto arg_it = args.begin();
+    for (auto param : fun->params()) {
+        ulam_assert(arg_it != args.end());
+        ulam_assert(arg_it->type()->is_same(param->type()));
+        store(
+            param->node()->local_slot(), param->type(),
+            Value{arg_it->value().copy_rvalue()});
+        ++arg_it;
+    }
+
+    code->add_run();
+    auto res = run();
+    if (res.is_nil()) {
+        debug() << "falling back to tree-walking evaluation of `"
+                << fun->name() << "`\n";
+        code->add_deopt();
+    }
+    return res;
+}
+
+Ref<FunCode> EvalVm::compile(Ref<Fun> fun, Ref<Class> eff_cls) {
+    auto self = LValue::make_ph(LValue::DefaultFlags & ~value::IsXvalue);
+    return compile(fun, self, eff_cls);
+}
+
+Ref<FunCode> EvalVm::compile(Ref<Fun> fun, LValue self, Ref<Class> eff_cls) {
+    auto code = fun->code(eff_cls);
+    if (code || has_flag(evl::ReadOnlyCaches))
+        return code;
+
+    auto body = fun->body_node();
+    if (body->local_slot_num() == NoLocalSlot)
+        LocalResolver{}.resolve(fun->node());
+    auto stack_raii = env().stack_raii(fun, self, body->local_slot_num());
+    auto sr = env().fun_scope_raii(fun, self, eff_cls);
+    return fun->add_code(EvalCompiler{env()}.compile(fun, eff_cls));
+}
+
+ExprRes EvalVm::run() {
+    // on failure, fall back to tree-walking evaluator if nothing
+    // observable has been done yet
+    auto fail = [&](ExprError error) -> ExprRes {
+        ulam_assert(error != ExprError::Ok);
+        if (_has_calls)
+            return {error};
+        return {};
+    };
+
+    const auto& instrs = _code->instrs();
+    FunCode::idx_t idx = 0;
+    while (true) {
+        ulam_assert(idx < instrs.size());
+        const auto& instr = instrs[idx++];
+        auto error = ExprError::Ok;
+        switch (instr.opcode) {
+        case Opcode::Const:
+            _regs[instr.a] = _code->constant(instr.idx).copy();
+            break;
+        case Opcode::Move:
+            _regs[instr.a] = take(instr.b);
+            break;
+        case Opcode::InitDefault: {
+            auto type = _code->type(instr.idx);
+            store(instr.a, type, Value{type->construct_default()});
+        } break;
+        case Opcode::Init:
+            error = init(instr);
+            break;
+        case Opcode::Assign:
+            error = assign(instr, instr.a, take(instr.b));
+            break;
+        case Opcode::BinaryOp:
+            error = binary_op(instr);
+            break;
+        case Opcode::UnaryOp:
+            error = unary_op(instr);
+            break;
+        case Opcode::IncDec:
+            error = inc_dec(instr);
+            break;
+        case Opcode::Cast:
+            error = cast(instr);
+            break;
+        case Opcode::Jump:
+            idx = instr.idx;
+            break;
+        case Opcode::JumpIfFalse:
+        case Opcode::JumpIfTrue: {
+            bool truth = false;
+            error = jump_if(instr, truth);
+            if (error == ExprError::Ok &&
+                truth == (instr.opcode == Opcode::JumpIfTrue))
+                idx = instr.idx;
+        } break;
+        case Opcode::LoopInit:
+            _loops[instr.a] = 0;
+            break;
+        case Opcode::LoopCheck:
+            if (_loops[instr.a]++ ==
+                program()->eval_options().max_loop_iterations)
+                throw EvalExceptError("for loop limit exceeded");
+            break;
+        case Opcode::Call:
+            error = call(instr);
+            break;
+        case Opcode::Return: {
+            auto res = ret(instr);
+            if (!res)
+                return fail(res.error());
+            return res;
+        }
+        case Opcode::ReturnVoid:
+            return {builtins().type(VoidId), Value{RValue{}}};
+        case Opcode::End:
+            if (!_fun->ret_type()->is(VoidId)) {
+                if (_has_calls)
+                    diag().error(_fun->body_node(), "no return value");
+                return fail(ExprError::NoReturn);
+            }
+            return {builtins().void_type(), Value::make_r_ph()};
+        }
+        if (error != ExprError::Ok)
+            return fail(error);
+    }
+}
+
+ExprError EvalVm::binary_op(const Instr& instr) {
+    auto left = take(instr.b);
+    auto right = take(instr.c);
+
+    // operand nodes for diagnostics
+    Ref<ast::Node> l_node = instr.node;
+    Ref<ast::Node> r_node = instr.node;
+    if (auto node = dynamic_cast<Ref<ast::BinaryOp>>(instr.node)) {
+        l_node = node->lhs();
+        r_node = node->rhs();
+    }
+
+    type_check_flags_t type_check_flags = NoTypeCheckFlags;
+    if (program()->eval_options().implicit_class_negation_op)
+        type_check_flags |= TypeCheckImplicitClassNegationOp;
+    auto type_errors = binary_op_type_check(
+        instr.op, left.type(), left.value(), right.type(), right.value(),
+        type_check_flags);
+
+    auto recast = [&](Ref<ast::Node> node, TypeError error,
+                      TypedValue& tv) -> ExprError {
+        if (error.status == TypeError::Ok)
+            return ExprError::Ok;
+        if (error.status != TypeError::ImplCastRequired)
+            return type_error(node, error, tv.type());
+        auto res = (error.cast_bi_type_id != NoBuiltinTypeId)
+                       ? cast(node, error.cast_bi_type_id, std::move(tv))
+                       : cast(node, error.cast_type, std::move(tv), false);
+        if (!res)
+            return res.error();
+        tv = res.move_typed_value();
+        return ExprError::Ok;
+    };
+    auto error = recast(l_node, type_errors.first, left);
+    if (error != ExprError::Ok)
+        return error;
+    error = recast(r_node, type_errors.second, right);
+    if (error != ExprError::Ok)
+        return error;
+
+    if (instr.op == Op::Assign) {
+        _regs[instr.a] = std::move(right);
+        return ExprError::Ok;
+    }
+    // operand types are checked by compiler
+    auto l_type = left.type()->actual();
+    auto r_type = right.type()->actual();
+    ulam_assert(l_type->is_prim() && r_type->is_prim());
+    _regs[instr.a] = l_type->as_prim()->binary_op(
+        instr.op, left.move_value().move_rvalue(), r_type->as_prim(),
+        right.move_value().move_rvalue());
+    return ExprError::Ok;
+}
+
+ExprError EvalVm::unary_op(const Instr& instr) {
+    auto arg = take(instr.b);
+    auto error = unary_op_type_check(instr.op, arg.type());
+    switch (error.status) {
+    case TypeError::Ok:
+        break;
+    case TypeError::ImplCastRequired: {
+        auto res = cast(instr.node, error.cast_bi_type_id, std::move(arg));
+        if (!res)
+            return res.error();
+        arg = res.move_typed_value();
+    } break;
+    case TypeError::ExplCastRequired:
+        return ExprError::CastRequired;
+    default:
+        return type_error(instr.node, error, arg.type());
+    }
+
+    auto type = arg.type()->deref();
+    ulam_assert(type->is_prim());
+    _regs[instr.a] =
+        type->as_prim()->unary_op(instr.op, arg.move_value().move_rvalue());
+    return ExprError::Ok;
+}
+
+ExprError EvalVm::inc_dec(const Instr& instr) {
+    // type is checked by compiler
+    auto arg = take(instr.b);
+    auto type = arg.type()->deref();
+    auto tv =
+        type->as_prim()->unary_op(instr.op, arg.move_value().move_rvalue());
+    return assign(instr, instr.b, std::move(tv));
+}
+
+ExprError EvalVm::assign(const Instr& instr, reg_t to, TypedValue&& from) {
+    auto to_type = _regs[to].type()->deref();
+    auto from_type = from.type()->deref();
+    if (!from_type->is_assignable_to(to_type, from.value())) {
+        auto res = cast(instr.node, to_type, std::move(from), true);
+        if (!res)
+            return res.error();
+        from = res.move_typed_value();
+    }
+    store(to, to_type, from.move_value());
+    return ExprError::Ok;
+}
+
+ExprError EvalVm::init(const Instr& instr) {
+    auto type = _code->type(instr.idx);
+    auto res = cast(instr.node, type, take(instr.b), false);
+    if (!res)
+        return res.error();
+    store(instr.a, type, res.move_value());
+    return ExprError::Ok;
+}
+
+ExprError EvalVm::cast(const Instr& instr) {
+    auto res = cast(instr.node, _code->type(instr.idx), take(instr.b), true);
+    if (!res)
+        return res.error();
+    _regs[instr.a] = res.move_typed_value();
+    return ExprError::Ok;
+}
+
+ExprError EvalVm::jump_if(const Instr& instr, bool& truth) {
+    auto res = cast(instr.node, BoolId, _regs[instr.b].copy());
+    if (!res)
+        return res.error();
+    truth = is_true(res);
+    return ExprError::Ok;
+}
+
+ExprError EvalVm::call(const Instr& instr) {
+    const auto& call = _code->call(instr.idx);
+    ExprResList args;
+    for (auto reg : call.args)
+        args.push_back(ExprRes{take(reg)});
+    ExprRes callable{
+        builtins().fun_type(), Value{_self.bound_fset(call.fset)}};
+
+    _has_calls = true;
+    auto res = env().call(call.node, std::move(callable), std::move(args));
+    if (!res)
+        return res.error();
+    _regs[instr.a] = res.move_typed_value();
+    return ExprError::Ok;
+}
+
+ExprRes EvalVm::ret(const Instr& instr) {
+    return cast(instr.node, _fun->ret_type(), take(instr.b), false);
+}
+
+TypedValue EvalVm::take(reg_t reg) {
+    ulam_assert(reg < _regs.size());
+    if (reg < _code->local_num())
+        return _regs[reg].copy();
+    return std::move(_regs[reg]);
+}
+
+void EvalVm::store(reg_t reg, Ref<Type> type, Value&& val) {
+    auto rval = val.move_rvalue();
+    rval.set_is_consteval(false);
+    _regs[reg] = {type, Value{std::move(rval)}};
+}
+
+ExprRes EvalVm::cast(
+    Ref<ast::Node> node, Ref<Type> type, TypedValue&& tv, bool expl) {
+    if (tv.type()->is_same(type))
+        return {std::move(tv)};
+    // before fallback, invalid cast is reported by evaluator
+    if (!_has_calls && !tv.type()->is_castable_to(type, tv.value(), expl))
+        return {ExprError::InvalidCast};
+    return env().cast(node, type, ExprRes{std::move(tv)}, expl);
+}
+
+ExprRes EvalVm::cast(
+    Ref<ast::Node> node,
+    BuiltinTypeId bi_type_id,
+    TypedValue&& tv,
+    bool expl) {
+    if (tv.type()->is(bi_type_id))
+        return {std::move(tv)};
+    if (!_has_calls &&
+        !tv.type()->is_castable_to(bi_type_id, tv.value(), expl))
+        return {ExprError::InvalidCast};
+    return env().cast(node, bi_type_id, ExprRes{std::move(tv)}, expl);
+}
+
+ExprError
+EvalVm::type_error(Ref<ast::Node> node, TypeError error, Ref<Type> type) {
+    ulam_assert(error.status != TypeError::Ok);
+    ulam_assert(error.status != TypeError::ImplCastRequired);
+    if (!_has_calls)
+        return ExprError::InvalidOperandType;
+
+    // same diagnostics as evaluator
+    if (error.status == TypeError::ExplCastRequired) {
+        auto message = "suggest casting " + std::string{type->name()} + " to ";
+        message += (error.cast_bi_type_id != NoBuiltinTypeId)
+                       ? std::string{builtin_type_str(error.cast_bi_type_id)}
+                       : std::string{error.cast_type->name()};
+        diag().error(node, message);
+    } else {
+        diag().error(node, "incompatible type");
+    }
+    return ExprError::InvalidOperandType;
+}
+
+} // namespace ulam::sema
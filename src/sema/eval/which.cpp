@@ -1,4 +1,5 @@
 #include <libulam/sema/eval/cond.hpp>
+#include <libulam/sema/eval/ctl.hpp>
 #include <libulam/sema/eval/env.hpp>
 #include <libulam/sema/eval/except.hpp>
 #include <libulam/sema/eval/expr_visitor.hpp>
@@ -19,10 +20,10 @@ void EvalWhich::eval_which(Ref<ast::Which> node) {
     Context ctx{node};
     if (node->has_expr())
         ctx.which_var = make_which_var(ctx, node->expr());
-    try {
-        eval_cases(ctx);
-    } catch (const EvalExceptBreak&) {
+    eval_cases(ctx);
+    if (env().ctl().is(EvalCtl::Break)) {
         debug() << "break\n";
+        env().ctl().reset();
     }
 }
 
@@ -18,14 +18,14 @@ ExprRes ExprRes::copy() const {
     } else {
         res = {error()};
     }
-    res._data = _data;
+    res._data = copy_data();
     res._flags = _flags & ~NonStickyFlags;
     return res;
 }
 
 ExprRes ExprRes::derived(TypedValue&& tv, bool keep_all_flags) {
     ExprRes res{std::move(tv)};
-    res._data = _data;
+    res._data = copy_data();
     res._flags = keep_all_flags ? _flags : _flags & ~NonStickyFlags;
     return res;
 }
@@ -52,6 +52,7 @@ bool ClassResolver::do_resolve() {
     _cls.set_state(ok ? Def::Resolved : Def::Unresolvable);
     if (ok) {
         _cls.merge_fsets();
+        _cls.init_vtable();
         _cls.init_layout();
         init_default_data();
     }
@@ -88,7 +89,7 @@ bool ClassResolver::resolve_ancestors() {
         if (!_resolver.resolve(anc->cls()))
             return false;
     }
-    _cls._ancestry.init();
+    _cls.init_ancestry();
     return true;
 }
 
@@ -192,8 +193,10 @@ bool ClassResolver::add_common_base() {
     auto urself_type = exp->sym()->get<Class>();
     if (urself_type->is_class()) {
         auto urself = urself_type->as_class();
-        if (urself != &_cls)
+        if (urself != &_cls) {
             _cls.add_ancestor(urself, {});
+            _cls.module()->add_dep(exp->module());
+        }
     }
     return true;
 }
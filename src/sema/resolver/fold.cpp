@@ -0,0 +1,122 @@
+#include <libulam/assert.hpp>
+#include <libulam/sema/resolver/fold.hpp>
+#include <libulam/semantic/ops.hpp>
+#include <libulam/semantic/value/fold_cache.hpp>
+
+namespace ulam::sema {
+
+void ConstFolder::mark(Ref<ast::FunDef> node) {
+    ulam_assert(node->has_body());
+    auto body = node->body();
+    if (body->is_const_folded())
+        return;
+    body->accept(*this);
+    body->set_is_const_folded(true);
+}
+
+void ConstFolder::visit(Ref<ast::TypeOpExpr> node) {
+    Shape shape_ = Shape::Named;
+    if (node->has_type_name()) {
+        node->type_name()->accept(*this);
+    } else {
+        ulam_assert(node->has_expr());
+        shape_ = shape(node->expr());
+    }
+    // constructor call or base selection
+    if (node->has_args()) {
+        node->args()->accept(*this);
+        shape_ = Shape::None;
+    }
+    if (node->has_base_type()) {
+        node->base_type()->accept(*this);
+        shape_ = Shape::None;
+    }
+    mark(node, shape_);
+}
+
+void ConstFolder::visit(Ref<ast::Ident> node) {
+    // local variables are bound to slots at this point
+    bool is_var = node->is_self() || node->is_super() ||
+                  node->local_slot() != NoLocalSlot;
+    set_shape(node, is_var ? Shape::None : Shape::Named);
+}
+
+void ConstFolder::visit(Ref<ast::ParenExpr> node) {
+    set_shape(node, shape(node->inner()));
+}
+
+void ConstFolder::visit(Ref<ast::BinaryOp> node) {
+    auto shape_ = combine(shape(node->lhs()), shape(node->rhs()));
+    if (ops::is_assign(node->op()))
+        shape_ = Shape::None;
+    mark(node, shape_);
+}
+
+void ConstFolder::visit(Ref<ast::UnaryOp> node) {
+    auto shape_ = shape(node->arg());
+    // `is`, `as`
+    if (node->has_type_name()) {
+        node->type_name()->accept(*this);
+        shape_ = Shape::None;
+    }
+    if (ops::is_inc_dec(node->op()))
+        shape_ = Shape::None;
+    mark(node, shape_);
+}
+
+void ConstFolder::visit(Ref<ast::Cast> node) {
+    node->full_type_name()->accept(*this);
+    mark(node, combine(Shape::Named, shape(node->expr())));
+}
+
+void ConstFolder::visit(Ref<ast::Ternary> node) {
+    auto shape_ = shape(node->cond());
+    shape_ = combine(shape_, shape(node->if_true()));
+    shape_ = combine(shape_, shape(node->if_false()));
+    mark(node, shape_);
+}
+
+// literals are cheap to construct and are not cached themselves
+
+void ConstFolder::visit(Ref<ast::BoolLit> node) {
+    set_shape(node, Shape::CtxFree);
+}
+
+void ConstFolder::visit(Ref<ast::NumLit> node) {
+    set_shape(node, Shape::CtxFree);
+}
+
+void ConstFolder::visit(Ref<ast::StrLit> node) {
+    set_shape(node, Shape::CtxFree);
+}
+
+void ConstFolder::visit(Ref<ast::ClassConstAccess> node) {
+    node->type_name()->accept(*this);
+    set_shape(node, Shape::Named);
+}
+
+ConstFolder::Shape ConstFolder::shape(Ref<ast::Expr> node) {
+    _node = {};
+    node->accept(*this);
+    return (_node == node) ? _shape : Shape::None;
+}
+
+void ConstFolder::set_shape(Ref<ast::Expr> node, Shape shape) {
+    _node = node;
+    _shape = shape;
+}
+
+void ConstFolder::mark(Ref<ast::Expr> node, Shape shape) {
+    if (shape != Shape::None && !node->fold_cache())
+        node->set_fold_cache(make<FoldCache>(shape == Shape::CtxFree));
+    set_shape(node, shape);
+}
+
+ConstFolder::Shape ConstFolder::combine(Shape shape1, Shape shape2) {
+    if (shape1 == Shape::None || shape2 == Shape::None)
+        return Shape::None;
+    return (shape1 == Shape::Named || shape2 == Shape::Named) ? Shape::Named
+                                                              : Shape::CtxFree;
+}
+
+} // namespace ulam::sema
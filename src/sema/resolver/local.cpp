@@ -0,0 +1,148 @@
+#include <libulam/sema/resolver/local.hpp>
+
+namespace ulam::sema {
+
+void LocalResolver::resolve(Ref<ast::FunDef> node) {
+    ulam_assert(node->has_body());
+    _names.clear();
+    _slot_num = 0;
+    _scope_def_num = 0;
+
+    // params
+    auto params = node->params();
+    for (unsigned n = 0; n < params->child_num(); ++n)
+        add_var(params->get(n));
+
+    node->body()->accept(*this);
+}
+
+void LocalResolver::visit(Ref<ast::FunDefBody> node) {
+    // function body shares scope with params
+    traverse(node);
+    node->set_local_slot_num(_slot_num);
+}
+
+void LocalResolver::visit(Ref<ast::Block> node) {
+    auto size = block_begin();
+    traverse(node);
+    block_end(size);
+}
+
+void LocalResolver::visit(Ref<ast::TypeDef> node) {
+    traverse(node);
+    ++_scope_def_num;
+}
+
+void LocalResolver::visit(Ref<ast::If> node) {
+    auto size = block_begin();
+    node->cond()->accept(*this);
+    visit_branch(node->if_branch(), node->cond());
+    if (node->has_else_branch())
+        node->else_branch()->accept(*this);
+    block_end(size);
+}
+
+void LocalResolver::visit(Ref<ast::For> node) {
+    auto size = block_begin();
+    if (node->has_init())
+        node->init()->accept(*this);
+    auto scope_def_num = _scope_def_num;
+    if (node->has_cond())
+        node->cond()->accept(*this);
+    if (node->has_body())
+        visit_branch(node->body(), node->cond());
+    if (node->has_upd())
+        node->upd()->accept(*this);
+    node->set_has_scope_defs(_scope_def_num != scope_def_num);
+    block_end(size);
+}
+
+void LocalResolver::visit(Ref<ast::While> node) {
+    auto size = block_begin();
+    auto scope_def_num = _scope_def_num;
+    node->cond()->accept(*this);
+    if (node->has_body())
+        visit_branch(node->body(), node->cond());
+    node->set_has_scope_defs(_scope_def_num != scope_def_num);
+    block_end(size);
+}
+
+void LocalResolver::visit(Ref<ast::WhichCase> node) {
+    auto size = block_begin();
+    auto conds = node->conds();
+    for (unsigned n = 0; n < conds->child_num(); ++n) {
+        auto cond = conds->get(n);
+        cond->accept(*this);
+        if (cond->is_as_cond() && !cond->as_cond()->ident()->is_self())
+            add_unbound(cond->as_cond()->ident()->name_id());
+    }
+    node->branch()->accept(*this);
+    block_end(size);
+}
+
+void LocalResolver::visit(Ref<ast::VarDefList> node) {
+    node->type_name()->accept(*this);
+    for (unsigned n = 0; n < node->def_num(); ++n) {
+        auto def = node->def(n);
+        // var is added to scope after its initializer is evaluated
+        traverse(def);
+        if (node->is_const()) {
+            // constants are stored in scope, may be used in types
+            add_unbound(def->name_id());
+            ++_scope_def_num;
+        } else {
+            add_var(def);
+        }
+    }
+}
+
+void LocalResolver::visit(Ref<ast::Ident> node) {
+    if (node->is_self() || node->is_super() || node->is_local())
+        return;
+    auto name_id = node->name_id();
+    for (auto it = _names.rbegin(); it != _names.rend(); ++it) {
+        if (it->first == name_id) {
+            node->set_local_slot(it->second);
+            return;
+        }
+    }
+}
+
+void LocalResolver::visit(Ref<ast::MemberAccess> node) {
+    // member name is not a local
+    node->obj()->accept(*this);
+    if (node->has_base_type())
+        node->base_type()->accept(*this);
+}
+
+void LocalResolver::visit(Ref<ast::ClassConstAccess> node) {
+    node->type_name()->accept(*this);
+}
+
+void LocalResolver::visit_branch(Ref<ast::Stmt> node, Ref<ast::Cond> cond) {
+    if (!cond || !cond->is_as_cond() || cond->as_cond()->ident()->is_self()) {
+        node->accept(*this);
+        return;
+    }
+    // `as` condition variable shadows the name in the branch
+    auto size = block_begin();
+    add_unbound(cond->as_cond()->ident()->name_id());
+    node->accept(*this);
+    block_end(size);
+}
+
+void LocalResolver::add_var(Ref<ast::VarDefBase> node) {
+    if (_slot_num == NoLocalSlot) {
+        add_unbound(node->name_id());
+        ++_scope_def_num;
+        return;
+    }
+    node->set_local_slot(_slot_num);
+    _names.emplace_back(node->name_id(), _slot_num++);
+}
+
+void LocalResolver::add_unbound(str_id_t name_id) {
+    _names.emplace_back(name_id, NoLocalSlot);
+}
+
+} // namespace ulam::sema
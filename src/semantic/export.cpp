@@ -16,4 +16,14 @@ const Export* ExportTable::add(str_id_t name_id, Export exp) {
     return added ? nullptr : &it->second;
 }
 
+void ExportTable::remove(Ref<const Module> module) {
+    for (auto it = _table.begin(); it != _table.end();) {
+        if (it->second.module() == module) {
+            it = _table.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 } // namespace ulam
@@ -3,6 +3,7 @@
 #include <libulam/ast/nodes/params.hpp>
 #include <libulam/diag.hpp>
 #include <libulam/semantic/fun.hpp>
+#include <libulam/semantic/fun/code.hpp>
 #include <libulam/semantic/mangler.hpp>
 #include <libulam/semantic/scope/version.hpp>
 #include <libulam/semantic/type.hpp>
@@ -24,10 +25,12 @@ namespace ulam {
 Fun::Fun(
     UniqStrPool& str_pool,
     Mangler& mangler,
+    TypeKeyTable& type_keys,
     Scope* scope,
     Ref<ast::FunDef> node):
     _str_pool{str_pool},
     _mangler{mangler},
+    _type_keys{type_keys},
     _param_scope{make<PersScope>(scope)},
     _node{node} {
     ulam_assert(node);
@@ -64,6 +67,12 @@ bool Fun::is_pure_virtual() const { return is_virtual() && !_node->has_body(); }
 
 bool Fun::is_native() const { return _node->is_native(); }
 
+void Fun::set_native(Ref<const sema::NativeFun> native) {
+    ulam_assert(is_native());
+    _native = native;
+    _is_native_bound = true;
+}
+
 bool Fun::has_ellipsis() const { return _node->params()->has_ellipsis(); }
 
 void Fun::add_param(Ref<ast::Param> node) {
@@ -130,6 +139,13 @@ Ref<Fun> Fun::find_override(Ref<const Class> cls) {
     return (it != _overrides.end()) ? it->second : Ref<Fun>{};
 }
 
+Ref<Fun> Fun::dispatch(Ref<const Class> dyn_cls) {
+    if (!has_vslot())
+        return this;
+    auto fun = dyn_cls->vfun(this);
+    return fun ? fun : this;
+}
+
 Ref<PersScope> Fun::scope() { return cls()->scope(); }
 
 Ref<ast::FunRetType> Fun::ret_type_node() const {
@@ -144,11 +160,25 @@ Ref<ast::ParamList> Fun::params_node() const {
 
 Ref<ast::FunDefBody> Fun::body_node() const { return _node->body(); }
 
+Ref<FunCode> Fun::code(Ref<const Class> eff_cls) {
+    for (auto& code : _codes) {
+        if (code->is_for(eff_cls))
+            return ref(code);
+    }
+    return {};
+}
+
+Ref<FunCode> Fun::add_code(Ptr<FunCode>&& code) {
+    ulam_assert(!this->code(code->eff_cls()));
+    _codes.push_back(std::move(code));
+    return ref(_codes.back());
+}
+
 void Fun::add_override(Ref<Fun> fun, Ref<Class> cls) {
     ulam_assert(is_virtual()); // must be already marked as virtual
     ulam_assert(
-        fun->mangled_param_types() ==
-        mangled_param_types()); // parameters must match
+        fun->param_types_key() ==
+        param_types_key()); // parameters must match
 
     if (_overrides.count(cls->id()) == 1) {
         // can happen with multible inheritance
@@ -187,6 +217,18 @@ std::string Fun::mangled_param_types() const {
     return key;
 }
 
+type_key_id_t Fun::param_types_key() const {
+    if (_param_types_key == NoTypeKeyId) {
+        TypeKey key;
+        for (const auto& param : _params)
+            key.add(param->type());
+        if (has_ellipsis())
+            key.add_ellipsis();
+        _param_types_key = _type_keys.id(std::move(key));
+    }
+    return _param_types_key;
+}
+
 // FunSet
 
 FunSet::FunSet(str_id_t name_id): _name_id{name_id} {
@@ -202,12 +244,14 @@ str_id_t FunSet::name_id() const {
 
 FunSet::Matches
 FunSet::find_match(Ref<const Class> dyn_cls, const TypedValueRefList& args) {
-    FunSet::Matches overrides{};
-    auto matches = find_match(args);
-    for (auto match : matches) {
-        auto overrd = match->find_override(dyn_cls);
-        overrides.insert(overrd ? overrd : match);
-    }
+    return dispatch(find_match(args), dyn_cls);
+}
+
+FunSet::Matches
+FunSet::dispatch(const Matches& matches, Ref<const Class> dyn_cls) {
+    Matches overrides{};
+    for (auto match : matches)
+        overrides.insert(match->dispatch(dyn_cls));
     return overrides;
 }
 
@@ -253,9 +297,9 @@ void FunSet::init_map(Diag& diag, UniqStrPool& str_pool) {
 
     // group funs by param types (hopefully one per group)
     using List = std::list<Ref<Fun>>;
-    std::unordered_map<std::string, List> key_map;
+    std::unordered_map<type_key_id_t, List> key_map;
     for (auto fun : _funs) {
-        auto key = fun->mangled_param_types();
+        auto key = fun->param_types_key();
         auto [it, _] = key_map.emplace(key, List{});
         it->second.push_back(fun);
     }
@@ -283,7 +327,7 @@ void FunSet::merge(Ref<FunSet> other, Ref<Class> cls, Ref<Class> from_cls) {
         if (from_cls && fun->cls() != from_cls)
             continue;
         auto [it, added] =
-            _map.value().emplace(fun->mangled_param_types(), fun);
+            _map.value().emplace(fun->param_types_key(), fun);
         if (added) {
             _funs.push_back(fun);
             if (fun->is_virtual() && fun->has_overridden())
@@ -0,0 +1,55 @@
+#include <libulam/semantic/fun/call_cache.hpp>
+
+namespace ulam {
+
+FunCallCache::Stats FunCallCache::_stats;
+
+bool FunCallCache::is_cacheable(const TypedValueRefList& args) {
+    for (const auto& arg : args) {
+        if (arg.get().value().is_consteval() ||
+            arg.get().type()->id() == NoTypeId) {
+            _stats.uncacheable.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+Ref<Fun>
+FunCallCache::get(Ref<FunSet> fset, const TypedValueRefList& args) {
+    for (const auto& entry : _entries) {
+        if (entry.fset != fset || entry.args.size() != args.size())
+            continue;
+        bool is_match = true;
+        auto key_it = entry.args.begin();
+        for (const auto& arg : args) {
+            if (*(key_it++) != arg_key(arg.get())) {
+                is_match = false;
+                break;
+            }
+        }
+        if (is_match) {
+            _stats.hits.fetch_add(1, std::memory_order_relaxed);
+            return entry.fun;
+        }
+    }
+    _stats.misses.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void FunCallCache::add(
+    Ref<FunSet> fset, const TypedValueRefList& args, Ref<Fun> fun) {
+    if (_entries.size() == MaxSize)
+        return; // megamorphic
+    Entry entry{fset, {}, fun};
+    entry.args.reserve(args.size());
+    for (const auto& arg : args)
+        entry.args.push_back(arg_key(arg.get()));
+    _entries.push_back(std::move(entry));
+}
+
+FunCallCache::ArgKey FunCallCache::arg_key(const TypedValue& arg) {
+    return {arg.type()->id(), arg.value().is_tmp()};
+}
+
+} // namespace ulam
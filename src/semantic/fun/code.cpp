@@ -0,0 +1,58 @@
+#include <libulam/semantic/fun/code.hpp>
+#include <libulam/semantic/type/class.hpp>
+
+namespace ulam {
+
+FunCode::Stats FunCode::_stats;
+
+FunCode::FunCode(Ref<Class> eff_cls):
+    _eff_cls{eff_cls}, _eff_cls_id{eff_cls ? eff_cls->id() : NoTypeId} {}
+
+FunCode::~FunCode() {}
+
+bool FunCode::is_for(Ref<const Class> eff_cls) const {
+    return (eff_cls ? eff_cls->id() : NoTypeId) == _eff_cls_id;
+}
+
+void FunCode::set_compiled() {
+    _stats.compiled.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FunCode::set_unsupported() {
+    _stats.unsupported.fetch_add(1, std::memory_order_relaxed);
+    _is_disabled.store(true, std::memory_order_relaxed);
+}
+
+void FunCode::add_deopt() {
+    _stats.deopts.fetch_add(1, std::memory_order_relaxed);
+    if (_deopt_num.fetch_add(1, std::memory_order_relaxed) + 1 == MaxDeopts)
+        _is_disabled.store(true, std::memory_order_relaxed);
+}
+
+void FunCode::add_run() { _stats.runs.fetch_add(1, std::memory_order_relaxed); }
+
+FunCode::idx_t FunCode::add(Instr instr) {
+    _instrs.push_back(instr);
+    return _instrs.size() - 1;
+}
+
+FunCode::idx_t FunCode::add_const(TypedValue&& tv) {
+    _consts.push_back(std::move(tv));
+    return _consts.size() - 1;
+}
+
+FunCode::idx_t FunCode::add_type(Ref<Type> type) {
+    for (idx_t idx = 0; idx < _types.size(); ++idx) {
+        if (_types[idx] == type)
+            return idx;
+    }
+    _types.push_back(type);
+    return _types.size() - 1;
+}
+
+FunCode::idx_t FunCode::add_call(Call&& call) {
+    _calls.push_back(std::move(call));
+    return _calls.size() - 1;
+}
+
+} // namespace ulam
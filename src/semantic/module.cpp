@@ -163,11 +163,25 @@ bool Module::resolve(sema::Resolver& resolver) {
 
 void Module::add_import(str_id_t name_id, const Export& exp) {
     exp.sym()->accept(
-        [&](Ref<ClassTpl> tpl) { _env_scope->set(name_id, tpl); },
-        [&](Ref<Class> cls) { _env_scope->set(name_id, cls); },
+        [&](Ref<ClassTpl> tpl) {
+            _env_scope->set(name_id, tpl);
+            add_dep(exp.module(), true);
+        },
+        [&](Ref<Class> cls) {
+            _env_scope->set(name_id, cls);
+            add_dep(exp.module());
+        },
         [&](auto&&) { unreachable(); });
 }
 
+void Module::add_dep(Ref<Module> module, bool is_tpl) {
+    if (module == this)
+        return;
+    _deps.insert(module->name_id());
+    if (is_tpl)
+        _tpl_deps.insert(module->name_id());
+}
+
 void Module::add_export(Ref<ast::Node> node, str_id_t name_id, Symbol* sym) {
     auto& str_pool = program()->str_pool();
     auto& diag = program()->diag();
@@ -60,6 +60,27 @@ Ref<Module> Program::add_module(Ref<ast::ModuleDef> node) {
     return ref;
 }
 
+void Program::remove_module(Ref<Module> module) {
+    ulam_assert(this->module(module->name_id()) == module);
+    auto unregister = [&](Ref<Class> cls) {
+        _classes.remove(cls);
+        if (cls->is_element())
+            _elements.remove(cls);
+    };
+    for (auto cls : module->classes())
+        unregister(cls);
+    for (auto tpl : module->class_tpls()) {
+        for (auto cls : tpl->classes())
+            unregister(cls);
+    }
+    _exports.remove(module);
+
+    _modules_by_name_id.erase(module->name_id());
+    _modules.remove(module);
+    _module_ptrs.remove_if(
+        [&](const Ptr<Module>& ptr) { return ref(ptr) == module; });
+}
+
 const Export* Program::add_export(str_id_t name_id, Export exp) {
     return _exports.add(name_id, std::move(exp));
 }
@@ -1,5 +1,6 @@
 #include "libulam/semantic/value/flags.hpp"
 #include <libulam/assert.hpp>
+#include <libulam/sema/eval/except.hpp>
 #include <libulam/semantic/type/builtin/bool.hpp>
 #include <libulam/semantic/type/builtin/string.hpp>
 #include <libulam/semantic/type/builtin/unsigned.hpp>
@@ -52,6 +53,8 @@ RValue StringType::from_datum(Datum datum) {
 Datum StringType::to_datum(const RValue& rval) {
     ulam_assert(rval.is<String>());
     Datum datum = rval.get<String>().id;
+    if (datum >= (Datum{1} << bitsize()))
+        throw sema::EvalExceptError("string ID does not fit into String data");
     return datum;
 }
 
@@ -578,12 +578,17 @@ void Class::init(Ref<Module> module) {
 void Class::register_class() {
     ulam_assert(_cls_id == NoClassId);
     _cls_id = program()->classes().add(this);
+    if (_cls_id == NoClassId)
+        program()->diag().fatal(node(), "too many classes");
 }
 
 void Class::register_element() {
     ulam_assert(is_element());
     ulam_assert(_elt_id == NoEltId);
     _elt_id = program()->elements().add(this);
+    if (_elt_id == NoEltId &&
+        name() != program()->class_options().empty_element_name)
+        program()->diag().fatal(node(), "too many elements");
 }
 
 elt_id_t Class::read_element_id(const BitsView data, bitsize_t off) {
@@ -623,6 +628,12 @@ void Class::add_ancestor(Ref<Class> cls, Ref<ast::TypeName> node) {
     }
 }
 
+void Class::init_ancestry() {
+    ulam_assert(_idx == NoClassIdx);
+    _idx = program()->next_class_idx();
+    _ancestry.init();
+}
+
 void Class::merge_fsets() {
     auto merge_methods_and_ops = [&](Ref<Class> other) {
         // methods
@@ -660,6 +671,92 @@ void Class::merge_fsets() {
     }
 }
 
+// Slots are numbered per class hierarchy: new virtual functions of a
+// class get slots after those of its parents, so that tables stay dense and
+// first parent's table is a prefix of class table. With multiple
+// inheritance a slot of other parent can already be taken, in this case the
+// slot is moved to the end of table.
+void Class::init_vtable() {
+    auto final_fun = [&](Ref<Fun> fun) {
+        auto overrd = fun->find_override(this);
+        return overrd ? overrd : fun;
+    };
+
+    auto slot_of = [&](Ref<const Fun> slot_fun) -> Fun::vslot_t {
+        auto vslot = slot_fun->vslot();
+        if (vslot < _vtable.size() && _vtable[vslot].slot_fun == slot_fun)
+            return vslot;
+        auto it = _vslots_moved.find(slot_fun);
+        return (it != _vslots_moved.end()) ? it->second : Fun::NoVSlot;
+    };
+
+    auto set = [&](Ref<const Fun> slot_fun, Ref<Fun> fun) {
+        auto vslot = slot_of(slot_fun);
+        if (vslot == Fun::NoVSlot) {
+            vslot = slot_fun->vslot();
+            if (vslot < _vtable.size() && _vtable[vslot].slot_fun) {
+                vslot = _vtable.size();
+                _vslots_moved[slot_fun] = vslot;
+            }
+            if (vslot >= _vtable.size())
+                _vtable.resize(vslot + 1);
+        }
+        _vtable[vslot] = {slot_fun, fun};
+    };
+
+    // inherited slots, overridden via multiple inheritance or in parents
+    _vtable.clear();
+    _vslots_moved.clear();
+    bool is_first = true;
+    for (auto parent : parents()) {
+        auto parent_cls = parent->cls();
+        if (is_first) {
+            _vtable = parent_cls->_vtable;
+            _vslots_moved = parent_cls->_vslots_moved;
+            for (auto& entry : _vtable) {
+                if (entry.fun)
+                    entry.fun = final_fun(entry.fun);
+            }
+            is_first = false;
+            continue;
+        }
+        for (auto& entry : parent_cls->_vtable) {
+            if (entry.fun && slot_of(entry.slot_fun) == Fun::NoVSlot)
+                set(entry.slot_fun, final_fun(entry.fun));
+        }
+    }
+
+    // own and inherited visible functions; inherited function can become
+    // virtual after its class is resolved (see FunSet::merge)
+    auto add_fset = [&](Ref<FunSet> fset) {
+        for (auto fun : *fset) {
+            if (!fun->is_virtual())
+                continue;
+            if (!fun->has_vslot()) {
+                if (fun->has_overridden() && fun->overridden()->has_vslot()) {
+                    auto overridden = fun->overridden();
+                    fun->_vslot = overridden->vslot();
+                    fun->_vslot_fun = overridden->vslot_fun();
+                } else {
+                    fun->_vslot = _vtable.size();
+                    fun->_vslot_fun = fun;
+                }
+            }
+            set(fun->vslot_fun(), fun);
+        }
+    };
+    for (auto [name_id, fset] : fsets())
+        add_fset(fset);
+    for (auto& [op, fset] : ops())
+        add_fset(ref(fset));
+}
+
+Ref<Fun> Class::moved_vfun(Ref<const Fun> fun) const {
+    auto it = _vslots_moved.find(fun->vslot_fun());
+    return (it != _vslots_moved.end()) ? _vtable[it->second].fun
+                                        : Ref<Fun>{};
+}
+
 void Class::init_layout() {
     bitsize_t off = data_off();
     for (auto prop : props()) {
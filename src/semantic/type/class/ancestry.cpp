@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <libulam/assert.hpp>
 #include <libulam/semantic/type/class.hpp>
 #include <libulam/semantic/type/class/ancestry.hpp>
@@ -102,11 +103,40 @@ void Ancestry::init() {
         }
         anc->set_size_added(added);
     }
+    init_bits();
+}
+
+void Ancestry::init_bits() {
+    ulam_assert(!_has_bits);
+    std::vector<std::pair<cls_idx_t, bitsize_t>> offs;
+    offs.reserve(_ancestors.size());
+    for (auto anc : _ancestors) {
+        ulam_assert(anc->cls()->index() != NoClassIdx);
+        offs.emplace_back(anc->cls()->index(), anc->data_off());
+    }
+    std::sort(offs.begin(), offs.end());
+
+    auto word_num = offs.empty() ? 0 : offs.back().first / WordSize + 1;
+    _bits.resize(word_num, 0);
+    _ranks.resize(word_num, 0);
+    _offs.reserve(offs.size());
+    for (auto [idx, off] : offs) {
+        _bits[idx / WordSize] |= word_t{1} << (idx % WordSize);
+        _offs.push_back(off);
+    }
+    for (unsigned n = 1; n < word_num; ++n)
+        _ranks[n] = _ranks[n - 1] + __builtin_popcountll(_bits[n - 1]);
+    _has_bits = true;
 }
 
 bool Ancestry::is_base(Ref<const Class> cls) const {
     ulam_assert(cls->id() != NoTypeId);
-    return _map.count(cls->id()) == 1;
+    if (!_has_bits)
+        return _map.count(cls->id()) == 1;
+    // not indexed class cannot be an ancestor: ancestors are indexed first
+    auto idx = cls->index();
+    auto word = idx / WordSize;
+    return word < _bits.size() && ((_bits[word] >> (idx % WordSize)) & 1);
 }
 
 Ref<Ancestor> Ancestry::base(str_id_t name_id) {
@@ -116,7 +146,9 @@ Ref<Ancestor> Ancestry::base(str_id_t name_id) {
 
 bitsize_t Ancestry::data_off(Ref<const Class> cls) const {
     ulam_assert(is_base(cls));
-    return _map.at(cls->id())->data_off();
+    if (!_has_bits)
+        return _map.at(cls->id())->data_off();
+    return _offs[rank(cls->index())];
 }
 
 } // namespace ulam::cls
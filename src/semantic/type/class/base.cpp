@@ -116,8 +116,9 @@ Ref<Fun> ClassBase::add_fun(Ref<ast::FunDef> node) {
     auto program = _module->program();
     auto name_id = node->name_id();
 
-    auto fun =
-        make<Fun>(program->str_pool(), program->mangler(), scope(), node);
+    auto fun = make<Fun>(
+        program->str_pool(), program->mangler(), program->type_keys(),
+        scope(), node);
     auto ref = ulam::ref(fun);
     fun->set_scope_version(scope()->version());
 
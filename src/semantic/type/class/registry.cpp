@@ -1,9 +1,22 @@
+#include <algorithm>
 #include <libulam/semantic/type/class/registry.hpp>
+#include <limits>
 
 namespace ulam {
 
+static_assert(NoClassId == 0);
+
 cls_id_t ClassRegistry::add(Ref<Class> cls) {
-    ulam_assert(std::find(_classes.begin(), _classes.end(), cls) == _classes.end());
+    ulam_assert(
+        std::find(_classes.begin(), _classes.end(), cls) == _classes.end());
+    if (!_free_ids.empty()) {
+        auto id = _free_ids.back();
+        _free_ids.pop_back();
+        _classes[id - 1] = cls;
+        return id;
+    }
+    if (_classes.size() == std::numeric_limits<cls_id_t>::max())
+        return NoClassId;
     _classes.push_back(cls);
     return _classes.size();
 }
@@ -14,4 +27,12 @@ Ref<Class> ClassRegistry::get(cls_id_t id) const {
     return _classes[id - 1];
 }
 
+void ClassRegistry::remove(Ref<Class> cls) {
+    auto it = std::find(_classes.begin(), _classes.end(), cls);
+    if (it != _classes.end()) {
+        *it = {};
+        _free_ids.push_back(it - _classes.begin() + 1);
+    }
+}
+
 } // namespace ulam
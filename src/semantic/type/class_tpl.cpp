@@ -2,7 +2,6 @@
 #include <libulam/ast/nodes/expr.hpp>
 #include <libulam/ast/nodes/module.hpp>
 #include <libulam/sema/resolver.hpp>
-#include <libulam/semantic/mangler.hpp>
 #include <libulam/semantic/module.hpp>
 #include <libulam/semantic/program.hpp>
 #include <libulam/semantic/type/class.hpp>
@@ -69,7 +68,7 @@ ClassTpl::add_prop(Ref<ast::TypeName> type_node, Ref<ast::VarDefBase> node) {
 }
 
 std::pair<Ref<Class>, bool> ClassTpl::type(TypedValueList&& args) {
-    auto key = type_args_str(args);
+    auto key = program()->type_keys().id(TypeKey{args});
     auto it = _class_map.find(key);
     if (it != _class_map.end())
         return {ref(it->second), false};
@@ -117,10 +116,6 @@ Ptr<Class> ClassTpl::inst(TypedValueList&& args) {
     return cls;
 }
 
-std::string ClassTpl::type_args_str(const TypedValueList& args) {
-    return program()->mangler().mangled(args);
-}
-
 Ref<Program> ClassTpl::program() { return module()->program(); }
 
 } // namespace ulam
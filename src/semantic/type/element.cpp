@@ -1,5 +1,6 @@
 #include <libulam/semantic/type/class.hpp>
 #include <libulam/semantic/type/element.hpp>
+#include <limits>
 
 namespace ulam {
 
@@ -23,8 +24,14 @@ elt_id_t ElementRegistry::add(Ref<Class> cls) {
     } else {
         // non-Empty element
         ulam_assert(cls->name() != _class_options.empty_element_name);
-        id = _elements.size();
-        _elements.push_back(cls);
+        if (!_free_ids.empty()) {
+            id = _free_ids.back();
+            _free_ids.pop_back();
+            _elements[id] = cls;
+        } else if (_elements.size() <= std::numeric_limits<elt_id_t>::max()) {
+            id = _elements.size();
+            _elements.push_back(cls);
+        }
     }
     return id;
 }
@@ -35,4 +42,13 @@ Ref<Class> ElementRegistry::get(elt_id_t id) const {
     return _elements[id];
 }
 
+void ElementRegistry::remove(Ref<Class> cls) {
+    auto it = std::find(_elements.begin(), _elements.end(), cls);
+    if (it != _elements.end()) {
+        *it = {};
+        if (it != _elements.begin())
+            _free_ids.push_back(it - _elements.begin());
+    }
+}
+
 } // namespace ulam
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <libulam/assert.hpp>
+#include <libulam/semantic/type/key.hpp>
+#include <libulam/semantic/value.hpp>
+#include <libulam/semantic/value/data.hpp>
+
+namespace ulam {
+namespace {
+
+// type IDs are 16 bit, tags cannot be mistaken for a type
+constexpr TypeKey::word_t ValueTag = TypeKey::word_t{1} << 32;
+constexpr TypeKey::word_t IntegerTag = ValueTag | 1;
+constexpr TypeKey::word_t UnsignedTag = ValueTag | 2;
+constexpr TypeKey::word_t BitsTag = ValueTag | 3;
+constexpr TypeKey::word_t StringTag = ValueTag | 4;
+constexpr TypeKey::word_t EllipsisTag = ValueTag | 5;
+
+} // namespace
+
+TypeKey::TypeKey(const TypeList& types) {
+    _words.reserve(types.size());
+    for (auto type : types)
+        add(type);
+}
+
+TypeKey::TypeKey(const TypedValueList& values) {
+    _words.reserve(values.size() * 3);
+    for (const auto& tv : values)
+        add(tv);
+}
+
+void TypeKey::add(Ref<const Type> type) {
+    ulam_assert(type && type->canon());
+    ulam_assert(type->canon()->id() != NoTypeId);
+    add_word(type->canon()->id());
+}
+
+void TypeKey::add(const TypedValue& tv) {
+    add(tv.type());
+    tv.value().with_rvalue([&](const RValue& rval) { add(rval); });
+}
+
+void TypeKey::add(const RValue& rval) {
+    auto add_bits = [&](const Bits& bits) {
+        add_word(BitsTag);
+        add_word(bits.len());
+        for (Bits::size_t off = 0; off < bits.len(); off += Bits::UnitSize) {
+            auto len = std::min<Bits::size_t>(Bits::UnitSize, bits.len() - off);
+            add_word(bits.read(off, len));
+        }
+    };
+    rval.accept(
+        [&](Integer val) {
+            add_word(IntegerTag);
+            add_word((word_t)val);
+        },
+        [&](Unsigned val) {
+            add_word(UnsignedTag);
+            add_word(val);
+        },
+        [&](const Bits& val) { add_bits(val); },
+        [&](const String& str) {
+            add_word(StringTag);
+            add_word(str.id);
+        },
+        [&](const DataPtr& val) { add_bits(val->bits()); },
+        [&](const std::monostate&) { ulam_assert(false); });
+}
+
+void TypeKey::add_ellipsis() { add_word(EllipsisTag); }
+
+std::size_t TypeKey::hash() const {
+    std::size_t hash = _words.size();
+    for (auto word : _words)
+        hash ^= std::hash<word_t>{}(word) + 0x9e3779b9 + (hash << 6) +
+                (hash >> 2);
+    return hash;
+}
+
+type_key_id_t TypeKeyTable::id(TypeKey&& key) {
+    auto it = _ids.find(key);
+    if (it != _ids.end())
+        return it->second;
+    type_key_id_t id = _ids.size();
+    _ids.emplace(std::move(key), id);
+    return id;
+}
+
+} // namespace ulam
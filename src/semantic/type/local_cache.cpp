@@ -0,0 +1,42 @@
+#include <libulam/semantic/type.hpp>
+#include <libulam/semantic/type/local_cache.hpp>
+
+namespace ulam {
+
+LocalTypeCache::Stats LocalTypeCache::_stats;
+
+LocalTypeCache::LocalTypeCache() {}
+
+LocalTypeCache::~LocalTypeCache() {}
+
+Ref<Type>
+LocalTypeCache::get(Ref<const Class> self_cls, Ref<const Class> eff_cls) {
+    Key key{self_cls, eff_cls};
+    for (const auto& entry : _entries) {
+        if (entry.key == key) {
+            _stats.hits.fetch_add(1, std::memory_order_relaxed);
+            return entry.type;
+        }
+    }
+    _stats.misses.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void LocalTypeCache::add(
+    Ref<const Class> self_cls, Ref<const Class> eff_cls, Ref<Type> type) {
+    if (_entries.size() == MaxSize)
+        return;
+    _entries.push_back({{self_cls, eff_cls}, type});
+}
+
+Ref<UserType> LocalTypeCache::add(
+    Ref<const Class> self_cls,
+    Ref<const Class> eff_cls,
+    Ptr<UserType>&& type) {
+    auto type_ref = ref(type);
+    _entries.push_back({{self_cls, eff_cls}, type_ref});
+    _types.push_back(std::move(type));
+    return type_ref;
+}
+
+} // namespace ulam
@@ -1,12 +1,13 @@
 #include <algorithm>
+#include <cstring>
 #include <libulam/assert.hpp>
 #include <libulam/semantic/value/bits.hpp>
 #include <limits>
+#include <new>
 #include <sstream>
 
-// NOTE: keeping it simple for now
-// TODO: (maybe) optimize, see MFM::BitVector impl, use
-// variant<uint32_t,vector>, use small vector
+// NOTE: bits are stored MSB first, bit 0 is the leftmost bit of unit 0;
+// kernels work on whole units, unaligned ranges are shifted and merged
 // TODO: naming: size/len
 
 namespace ulam {
@@ -34,6 +35,146 @@ constexpr Bits::unit_idx_t to_unit_idx(Bits::size_t idx) {
 
 constexpr Bits::size_t to_off(Bits::size_t idx) { return idx % Bits::UnitSize; }
 
+// Unit kernels
+
+using unit_t = _Bits::unit_t;
+using bits_size_t = _Bits::size_t;
+constexpr bits_size_t UnitSize = _Bits::UnitSize;
+
+// reads `len` <= UnitSize bits starting at `idx`, result is right-aligned
+inline unit_t read_bits(const unit_t* units, bits_size_t idx, bits_size_t len) {
+    if (len == 0)
+        return 0;
+    const auto unit_idx = to_unit_idx(idx);
+    const auto off = to_off(idx);
+    const unit_t mask = make_mask(len, 0);
+    if (off + len <= UnitSize)
+        return (units[unit_idx] >> (UnitSize - (off + len))) & mask;
+    const auto len_2 = off + len - UnitSize;
+    return ((units[unit_idx] << len_2) | (units[unit_idx + 1] >> (UnitSize - len_2))) & mask;
+}
+
+// writes `len` <= UnitSize right-aligned bits of `value` starting at `idx`
+inline void
+write_bits(unit_t* units, bits_size_t idx, bits_size_t len, unit_t value) {
+    if (len == 0)
+        return;
+    const auto unit_idx = to_unit_idx(idx);
+    const auto off = to_off(idx);
+    value &= make_mask(len, 0);
+    if (off + len <= UnitSize) {
+        const auto shift = UnitSize - (off + len);
+        const unit_t mask = make_mask(len, shift);
+        units[unit_idx] = (units[unit_idx] & ~mask) | (value << shift);
+        return;
+    }
+    const auto len_2 = off + len - UnitSize;
+    const unit_t mask_1 = make_mask(UnitSize - off, 0);
+    const unit_t mask_2 = make_mask(len_2, UnitSize - len_2);
+    units[unit_idx] = (units[unit_idx] & ~mask_1) | (value >> len_2);
+    units[unit_idx + 1] =
+        (units[unit_idx + 1] & ~mask_2) | (value << (UnitSize - len_2));
+}
+
+// reads full unit starting at `idx`
+inline unit_t read_unit(const unit_t* units, bits_size_t idx) {
+    const auto unit_idx = to_unit_idx(idx);
+    const auto off = to_off(idx);
+    if (off == 0)
+        return units[unit_idx];
+    return (units[unit_idx] << off) | (units[unit_idx + 1] >> (UnitSize - off));
+}
+
+// writes full unit starting at `idx`
+inline void write_unit(unit_t* units, bits_size_t idx, unit_t value) {
+    const auto unit_idx = to_unit_idx(idx);
+    const auto off = to_off(idx);
+    if (off == 0) {
+        units[unit_idx] = value;
+        return;
+    }
+    const unit_t mask = make_mask(UnitSize - off, 0);
+    units[unit_idx] = (units[unit_idx] & ~mask) | (value >> off);
+    units[unit_idx + 1] =
+        (units[unit_idx + 1] & mask) | (value << (UnitSize - off));
+}
+
+void copy_bits(
+    unit_t* dst,
+    bits_size_t dst_idx,
+    const unit_t* src,
+    bits_size_t src_idx,
+    bits_size_t len) {
+    if (to_off(dst_idx) == 0 && to_off(src_idx) == 0) {
+        // aligned
+        const auto unit_num = len / UnitSize;
+        std::memmove(
+            dst + to_unit_idx(dst_idx), src + to_unit_idx(src_idx),
+            unit_num * sizeof(unit_t));
+        const auto done = unit_num * UnitSize;
+        dst_idx += done;
+        src_idx += done;
+        len -= done;
+    } else {
+        // shift and merge
+        for (; len >= UnitSize; len -= UnitSize) {
+            write_unit(dst, dst_idx, read_unit(src, src_idx));
+            dst_idx += UnitSize;
+            src_idx += UnitSize;
+        }
+    }
+    write_bits(dst, dst_idx, len, read_bits(src, src_idx, len));
+}
+
+bool equal_bits(
+    const unit_t* units_1,
+    bits_size_t idx_1,
+    const unit_t* units_2,
+    bits_size_t idx_2,
+    bits_size_t len) {
+    if (to_off(idx_1) == 0 && to_off(idx_2) == 0) {
+        // aligned
+        const auto unit_num = len / UnitSize;
+        if (!std::equal(
+                units_1 + to_unit_idx(idx_1),
+                units_1 + to_unit_idx(idx_1) + unit_num,
+                units_2 + to_unit_idx(idx_2)))
+            return false;
+        const auto done = unit_num * UnitSize;
+        idx_1 += done;
+        idx_2 += done;
+        len -= done;
+    } else {
+        for (; len >= UnitSize; len -= UnitSize) {
+            if (read_unit(units_1, idx_1) != read_unit(units_2, idx_2))
+                return false;
+            idx_1 += UnitSize;
+            idx_2 += UnitSize;
+        }
+    }
+    return read_bits(units_1, idx_1, len) == read_bits(units_2, idx_2, len);
+}
+
+// applies `op` to `len` bits at `dst_idx` and `src_idx`, stores result at
+// `dst_idx`; `src` == nullptr for zeros
+template <typename Op>
+void bin_op_bits(
+    unit_t* dst,
+    bits_size_t dst_idx,
+    const unit_t* src,
+    bits_size_t src_idx,
+    bits_size_t len,
+    Op op) {
+    for (; len >= UnitSize; len -= UnitSize) {
+        unit_t value = src ? read_unit(src, src_idx) : 0;
+        write_unit(dst, dst_idx, op(read_unit(dst, dst_idx), value));
+        dst_idx += UnitSize;
+        src_idx += UnitSize;
+    }
+    unit_t value = src ? read_bits(src, src_idx, len) : 0;
+    write_bits(dst, dst_idx, len, op(read_bits(dst, dst_idx, len), value));
+}
+
 template <typename T> void _write_hex(std::ostream& out, const T& bits) {
     out << "0x";
 
@@ -110,11 +251,9 @@ void BitsView::write(size_t idx, size_t len, unit_t value) {
 void BitsView::write(size_t idx, const BitsView other) {
     ulam_assert(idx < _len);
     ulam_assert(idx + other.len() <= _len);
-    for (size_t idx2 = 0; idx2 < other.len(); idx2 += UnitSize) {
-        size_t size = std::min<bitsize_t>(UnitSize, other.len() - idx2);
-        write(idx, size, other.read(idx2, size));
-        idx += size;
-    }
+    copy_bits(
+        data().storage(), _off + idx, other.data().storage(), other._off,
+        other.len());
 }
 
 BitsView::unit_t BitsView::read_right(size_t len) const {
@@ -128,49 +267,44 @@ void BitsView::write_right(size_t len, unit_t value) {
 }
 
 bool BitsView::empty() const {
-    for (unit_idx_t unit_idx = 0; unit_idx < _len / UnitSize; ++unit_idx) {
-        size_t idx = unit_idx * UnitSize;
-        if (read(idx, UnitSize) != 0)
+    const unit_t* units = data().storage();
+    size_t idx = _off;
+    size_t len = _len;
+    for (; len >= UnitSize; len -= UnitSize) {
+        if (read_unit(units, idx) != 0)
             return false;
+        idx += UnitSize;
     }
-    return true;
+    return read_bits(units, idx, len) == 0;
 }
 
 Bits BitsView::copy() const {
     Bits bv{len()};
-    for (size_t off = 0; off < len(); off += UnitSize) {
-        size_t size = (off + UnitSize > len()) ? len() - off : UnitSize;
-        bv.write(off, size, read(off, size));
-    }
+    copy_bits(bv.storage(), 0, data().storage(), _off, _len);
     return bv;
 }
 
 bool BitsView::operator==(const BitsView& other) {
-    if (_len != other._len)
-        return false;
-    for (unit_idx_t unit_idx = 0; unit_idx < _len / UnitSize; ++unit_idx) {
-        size_t idx = unit_idx * UnitSize;
-        if (read(idx, UnitSize) != other.read(idx, UnitSize))
-            return false;
-    }
-    size_t rem = _len % UnitSize;
-    return (rem == 0) || read_right(rem) == other.read_right(rem);
+    return _len == other._len &&
+           equal_bits(
+               data().storage(), _off, other.data().storage(), other._off,
+               _len);
 }
 
 bool BitsView::operator!=(const BitsView& other) { return !operator==(other); }
 
 BitsView& BitsView::operator&=(const BitsView& other) {
-    bin_op(other, std::bit_and<unit_t>{});
+    bin_op(other, [](unit_t a, unit_t b) { return a & b; });
     return *this;
 }
 
 BitsView& BitsView::operator|=(const BitsView& other) {
-    bin_op(other, std::bit_or<unit_t>{});
+    bin_op(other, [](unit_t a, unit_t b) { return a | b; });
     return *this;
 }
 
 BitsView& BitsView::operator^=(const BitsView& other) {
-    bin_op(other, std::bit_xor<unit_t>{});
+    bin_op(other, [](unit_t a, unit_t b) { return a ^ b; });
     return *this;
 }
 
@@ -200,30 +334,16 @@ std::string BitsView::hex() const {
     return os.str();
 }
 
-void BitsView::bin_op(const BitsView& other, UnitBinOp op) {
-    size_t off1 = 0; // offset from the right
-    while (off1 < len()) {
-        size_t size1 = UnitSize;
-        off1 += UnitSize;
-        if (off1 > len()) {
-            size1 = len() + UnitSize - off1;
-            off1 = len();
-        }
-        unit_t u1 = read(len() - off1, size1);
-        unit_t u2 = 0;
-        if (other.len() + size1 > off1) {
-            size_t off2 = off1;
-            size_t size2 = size1;
-            if (off2 > other.len()) {
-                size2 = other.len() + size1 - off1;
-                off2 = other.len();
-            }
-            ulam_assert(off2 <= other.len());
-            ulam_assert(size2 > 0);
-            u2 = other.read(other.len() - off2, size2);
-        }
-        write(len() - off1, size1, op(u1, u2));
-    }
+template <typename Op> void BitsView::bin_op(const BitsView& other, Op op) {
+    // operands are aligned right, missing bits are zeros
+    const size_t len = std::min(_len, other._len);
+    const size_t rest = _len - len;
+    unit_t* units = data().storage();
+    if (rest > 0)
+        bin_op_bits(units, _off, nullptr, 0, rest, op);
+    bin_op_bits(
+        units, _off + rest, other.data().storage(),
+        other._off + other._len - len, len, op);
 }
 
 Bits& BitsView::data() {
@@ -271,6 +391,19 @@ Bits Bits::copy() const {
     Bits bv{len()};
     ulam_assert(is_storage_dynamic() == bv.is_storage_dynamic());
     std::copy_n(storage(), storage_size(), bv.storage());
+    if (is_storage_dynamic())
+        _stats.copies.fetch_add(1, std::memory_order_relaxed);
+    return bv;
+}
+
+Bits Bits::share() const {
+    if (!is_storage_dynamic())
+        return copy();
+    Bits bv;
+    bv._len = _len;
+    bv._storage.ptr = _storage.ptr;
+    ref_num().fetch_add(1, std::memory_order_relaxed);
+    _stats.shares.fetch_add(1, std::memory_order_relaxed);
     return bv;
 }
 
@@ -530,35 +663,61 @@ Bits::unit_t Bits::last_unit_mask() const {
 }
 
 void Bits::init_storage() {
-    if (is_storage_dynamic()) {
-        _storage.ptr = new unit_t[storage_size()];
-    } else {
-        *_storage.array = {0};
-    }
+    if (is_storage_dynamic())
+        _storage.ptr = alloc_storage(storage_size());
     clear();
 }
 
 void Bits::destroy_storage() {
     if (is_storage_dynamic() && _storage.ptr) {
-        delete[] _storage.ptr;
+        if (ref_num().fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete[] (_storage.ptr - 1);
         _storage.ptr = nullptr;
     }
 }
 
 bool Bits::is_storage_dynamic() const {
-    return storage_size() > sizeof(_storage.array) / UnitSize;
+    return storage_size() > InlineUnitNum;
 }
 
 Bits::unit_idx_t Bits::storage_size() const {
     return (_len + UnitSize - 1) / UnitSize;
 }
 
+Bits::unit_t* Bits::alloc_storage(unit_idx_t size) {
+    static_assert(sizeof(ref_num_t) <= sizeof(unit_t));
+    static_assert(alignof(ref_num_t) <= alignof(unit_t));
+    unit_t* units = new unit_t[size + 1];
+    new (units) ref_num_t{1};
+    return units + 1;
+}
+
+Bits::ref_num_t& Bits::ref_num() const {
+    ulam_assert(is_storage_dynamic());
+    return *reinterpret_cast<ref_num_t*>(_storage.ptr - 1);
+}
+
+void Bits::unshare() {
+    unit_t* units = alloc_storage(storage_size());
+    std::copy_n(_storage.ptr, storage_size(), units);
+    destroy_storage();
+    _storage.ptr = units;
+    _stats.copies.fetch_add(1, std::memory_order_relaxed);
+    _stats.unshares.fetch_add(1, std::memory_order_relaxed);
+}
+
 Bits::unit_t* Bits::storage() {
-    return is_storage_dynamic() ? _storage.ptr : _storage.array;
+    if (!is_storage_dynamic())
+        return _storage.array;
+    if (ref_num().load(std::memory_order_acquire) > 1)
+        unshare();
+    return _storage.ptr;
 }
 
 const Bits::unit_t* Bits::storage() const {
-    return const_cast<Bits&>(*this).storage();
+    return is_storage_dynamic() ? _storage.ptr : _storage.array;
 }
 
+Bits::Stats Bits::_stats;
+
 } // namespace ulam
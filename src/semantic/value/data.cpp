@@ -29,8 +29,9 @@ Data::Data(Ref<Type> type, bool is_ph):
     _type{type}, _bits{is_ph ? (bitsize_t)0 : type->bitsize()}, _is_ph{is_ph} {}
 
 DataPtr Data::copy() const {
-    return !is_ph() ? make_s<Data>(_type, _bits.copy())
-                    : make_s<Data>(_type, true);
+    if (is_ph())
+        return make_s<Data>(_type, true);
+    return make_s<Data>(_type, _bits.share());
 }
 
 DataView Data::view() { return {shared_from_this(), _type, 0}; }
@@ -79,13 +80,17 @@ DataView::DataView(
     bitsize_t off,
     bitsize_t atom_off,
     Ref<Type> atom_type):
-    _storage{storage}, _type{}, _off{off}, _atom{atom_off, atom_type} {
+    _storage{std::move(storage)},
+    _type{},
+    _atom_type{atom_type},
+    _off{off},
+    _atom_off{atom_off} {
 
     _type = type;
 
-    if (_atom.off == NoBitsize && _type->is_atom()) {
-        _atom.off = off;
-        _atom.type = _type;
+    if (_atom_off == NoBitsize && _type->is_atom()) {
+        _atom_off = off;
+        _atom_type = _type;
     }
 }
 
@@ -122,7 +127,7 @@ DataView DataView::array_item(array_idx_t idx) {
     auto array_type = type_->as_array();
     auto item_type = type_->as_array()->item_type();
     bitsize_t off = _off + array_type->item_off(idx);
-    return {_storage, item_type, off, _atom.off, _atom.type};
+    return {_storage, item_type, off, _atom_off, _atom_type};
 }
 
 const DataView DataView::array_item(array_idx_t idx) const {
@@ -152,7 +157,7 @@ DataView DataView::prop(Ref<Prop> prop_) {
     auto prop_off = prop_cls->is_same_or_base_of(cls) ? prop_->data_off_in(cls)
                                                       : prop_->data_off();
     bitsize_t off = _off + prop_off;
-    return {_storage, prop_->type(), off, _atom.off, _atom.type};
+    return {_storage, prop_->type(), off, _atom_off, _atom_type};
 }
 
 const DataView DataView::prop(Ref<Prop> prop_) const {
@@ -160,10 +165,10 @@ const DataView DataView::prop(Ref<Prop> prop_) const {
 }
 
 DataView DataView::atom_of() {
-    if (_atom.off == NoBitsize)
+    if (_atom_off == NoBitsize)
         return {};
-    ulam_assert(_atom.type);
-    return {_storage, _atom.type, _atom.off, _atom.off, _atom.type};
+    ulam_assert(_atom_type);
+    return {_storage, _atom_type, _atom_off, _atom_off, _atom_type};
 }
 
 const DataView DataView::atom_of() const {
@@ -0,0 +1,40 @@
+#include <libulam/semantic/value/fold_cache.hpp>
+
+namespace ulam {
+
+FoldCache::Stats FoldCache::_stats;
+
+void FoldCache::disable() {
+    if (_is_disabled)
+        return;
+    _is_disabled = true;
+    _entries.clear();
+    _stats.disabled.fetch_add(1, std::memory_order_relaxed);
+}
+
+TypedValue
+FoldCache::get(Ref<const Class> self_cls, Ref<const Class> eff_cls) {
+    auto key_ = key(self_cls, eff_cls);
+    for (const auto& entry : _entries) {
+        if (entry.key == key_) {
+            _stats.hits.fetch_add(1, std::memory_order_relaxed);
+            return entry.tv.copy();
+        }
+    }
+    _stats.misses.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void FoldCache::add(
+    Ref<const Class> self_cls,
+    Ref<const Class> eff_cls,
+    const TypedValue& tv) {
+    if (_is_disabled || _entries.size() == MaxSize)
+        return;
+    const auto& val = tv.value();
+    if (!tv.type() || val.empty() || !val.is_rvalue() || !val.is_consteval())
+        return;
+    _entries.push_back({key(self_cls, eff_cls), tv.copy()});
+}
+
+} // namespace ulam
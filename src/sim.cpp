@@ -0,0 +1,406 @@
+#include <algorithm>
+#include <exception>
+#include <libulam/sema/eval/env.hpp>
+#include <libulam/sema/eval/except.hpp>
+#include <libulam/sema/eval/flags.hpp>
+#include <libulam/sema/eval/native.hpp>
+#include <libulam/sema/eval/visitor.hpp>
+#include <libulam/sema/eval/vm.hpp>
+#include <libulam/sema/eval/which.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/scope/flags.hpp>
+#include <libulam/semantic/type/builtin/atom.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/semantic/type/class_tpl.hpp>
+#include <libulam/sim.hpp>
+#include <random>
+#include <set>
+#include <thread>
+
+namespace ulam::sim {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// evaluation environment of worker thread
+class SimEnv : public sema::EvalEnv {
+public:
+    SimEnv(Ref<Program> program, sema::eval_flags_t flags):
+        sema::EvalEnv{program, flags}, _window{program->builtins()} {}
+
+    EventWindow& window() { return _window; }
+
+private:
+    EventWindow _window;
+};
+
+// Visits every branch and loop body once without setting control flow,
+// so that lazily filled caches of the whole function body are populated
+// (cf. sema::EvalFuncall::eval_noexec, which only follows known branches)
+class PrepareVisitor : public sema::EvalVisitor {
+public:
+    using sema::EvalVisitor::EvalVisitor;
+
+    void visit(Ref<ast::FunDefBody> node) override;
+    void visit(Ref<ast::If> node) override;
+    void visit(Ref<ast::For> node) override;
+    void visit(Ref<ast::While> node) override;
+    void visit(Ref<ast::Return> node) override;
+    void visit(Ref<ast::Break> node) override {}
+    void visit(Ref<ast::Continue> node) override {}
+
+private:
+    void visit_branch(Ref<ast::Stmt> stmt, sema::AsCondContext& as_cond_ctx);
+
+    // first visited `return', returned after the whole body is visited
+    Ref<ast::Return> _ret_node{};
+    sema::ExprRes _ret_res{};
+};
+
+void PrepareVisitor::visit(Ref<ast::FunDefBody> node) {
+    for (unsigned n = 0; n < node->child_num(); ++n)
+        node->get(n)->accept(*this);
+    if (_ret_node)
+        env().ctl().set_return(_ret_node, std::move(_ret_res));
+}
+
+void PrepareVisitor::visit(Ref<ast::If> node) {
+    auto sr = env().scope_raii();
+    auto [_, as_cond_ctx] = env().eval_cond(node->cond());
+    visit_branch(node->if_branch(), as_cond_ctx);
+    if (node->has_else_branch())
+        node->else_branch()->accept(*this);
+}
+
+void PrepareVisitor::visit(Ref<ast::For> node) {
+    auto sr = env().scope_raii(scp::BreakAndContinue);
+    if (node->has_init())
+        node->init()->accept(*this);
+
+    auto iter_sr = env().scope_raii();
+    sema::AsCondContext as_cond_ctx;
+    if (node->has_cond())
+        as_cond_ctx = env().eval_cond(node->cond()).second;
+    if (node->has_body())
+        visit_branch(node->body(), as_cond_ctx);
+    if (node->has_upd())
+        node->upd()->accept(*this);
+}
+
+void PrepareVisitor::visit(Ref<ast::While> node) {
+    auto sr = env().scope_raii(scp::BreakAndContinue);
+    auto iter_sr = env().scope_raii();
+    auto [_, as_cond_ctx] = env().eval_cond(node->cond());
+    if (node->has_body())
+        visit_branch(node->body(), as_cond_ctx);
+}
+
+void PrepareVisitor::visit(Ref<ast::Return> node) {
+    auto res = ret_res(node);
+    if (!_ret_node) {
+        _ret_node = node;
+        _ret_res = std::move(res);
+    }
+}
+
+void PrepareVisitor::visit_branch(
+    Ref<ast::Stmt> stmt, sema::AsCondContext& as_cond_ctx) {
+    if (!as_cond_ctx.empty()) {
+        auto sr = env().as_cond_scope_raii(as_cond_ctx);
+        stmt->accept(*this);
+    } else {
+        stmt->accept(*this);
+    }
+}
+
+// visits every `which` case, see PrepareVisitor
+class PrepareWhich : public sema::EvalWhich {
+public:
+    using sema::EvalWhich::EvalWhich;
+
+protected:
+    bool eval_case(Context& ctx, Ref<ast::WhichCase> case_) override {
+        match_conds(ctx, case_->conds());
+        if (!ctx.as_cond_ctx.empty()) {
+            auto sr = env().as_cond_scope_raii(ctx.as_cond_ctx);
+            env().eval_stmt(case_->branch());
+        } else {
+            auto sr = env().scope_raii();
+            env().eval_stmt(case_->branch());
+        }
+        return false;
+    }
+};
+
+// environment for warming up shared caches before running workers
+class PrepareEnv : public sema::EvalEnv {
+public:
+    using sema::EvalEnv::EvalEnv;
+
+    void eval_stmt(Ref<ast::Stmt> stmt) override {
+        PrepareVisitor vis{*this};
+        do_eval_stmt(vis, stmt);
+    }
+
+    void eval_which(Ref<ast::Which> which) override {
+        PrepareWhich ew{*this};
+        do_eval_which(ew, which);
+    }
+};
+
+// EventWindow.aref(Int index)
+sema::ExprRes event_window_aref(sema::NativeCall& call) {
+    auto env = dynamic_cast<SimEnv*>(&call.env());
+    if (!env)
+        throw sema::EvalExceptError("event window is not available");
+
+    ulam_assert(call.args().size() == 1);
+    auto rval = call.args().pop_front().move_value().move_rvalue();
+    ulam_assert(rval.is<Integer>());
+    auto idx = rval.get<Integer>();
+    if (idx < 0 || idx >= EventWindow::Size)
+        throw sema::EvalExceptError("site number out of range");
+
+    auto lval = env->window().atom(idx);
+    lval.set_is_xvalue(false);
+    return {env->builtins().atom_type(), Value{lval}};
+}
+
+// classes and template instances of program modules
+std::vector<Ref<Class>> program_classes(Ref<Program> program) {
+    std::vector<Ref<Class>> classes;
+    for (auto module : program->modules()) {
+        for (auto cls : module->classes())
+            classes.push_back(cls);
+        for (auto tpl : module->class_tpls()) {
+            for (auto cls : tpl->classes())
+                classes.push_back(cls);
+        }
+    }
+    return classes;
+}
+
+} // namespace
+
+// SimStats
+
+double SimStats::events_per_sec() const {
+    auto sec = std::chrono::duration<double>(duration).count();
+    return (sec > 0) ? events / sec : 0;
+}
+
+// Sim
+
+Sim::Sim(Ref<Program> program, Grid& grid, const SimOptions& options):
+    _program{program}, _grid{grid}, _options{options} {
+    ulam_assert(options.threads > 0);
+    ulam_assert(options.tile_size > 0);
+
+    auto& natives = program->natives();
+    if (!natives.has("EventWindow", "aref@232i"))
+        natives.add("EventWindow", "aref@232i", event_window_aref);
+
+    // window type is shared by workers
+    program->builtins().atom_type()->array_type(EventWindow::Size);
+
+    init_tiles();
+    init_behave();
+}
+
+Sim::~Sim() {}
+
+SimStats Sim::run(std::size_t event_num) {
+    unsigned worker_num =
+        std::min<std::size_t>(_options.threads, _tiles.size());
+    if (worker_num > 1 && !_prepared) {
+        prepare();
+        _prepared = true;
+    }
+
+    std::vector<SimStats> worker_stats(worker_num);
+    auto start = Clock::now();
+    if (worker_num == 1) {
+        run_worker(0, 1, event_num, worker_stats[0]);
+    } else {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(worker_num);
+        for (unsigned n = 0; n < worker_num; ++n) {
+            std::size_t num =
+                event_num / worker_num + (n < event_num % worker_num);
+            workers.emplace_back([&, n, num]() {
+                try {
+                    run_worker(n, worker_num, num, worker_stats[n]);
+                } catch (...) {
+                    errors[n] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        for (auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    SimStats stats;
+    stats.duration = Clock::now() - start;
+    for (const auto& ws : worker_stats) {
+        stats.events += ws.events;
+        stats.failed += ws.failed;
+    }
+    return stats;
+}
+
+void Sim::init_tiles() {
+    const auto size = _options.tile_size;
+    _tiles_x = (_grid.width() + size - 1) / size;
+    unsigned tiles_y = (_grid.height() + size - 1) / size;
+    for (unsigned ty = 0; ty < tiles_y; ++ty) {
+        for (unsigned tx = 0; tx < _tiles_x; ++tx) {
+            auto tile = make<Tile>();
+            tile->x = tx * size;
+            tile->y = ty * size;
+            tile->width = std::min(size, _grid.width() - tile->x);
+            tile->height = std::min(size, _grid.height() - tile->y);
+            _tiles.push_back(std::move(tile));
+        }
+    }
+}
+
+void Sim::init_behave() {
+    auto name_id = _program->str_pool().id("behave");
+    if (name_id == NoStrId)
+        return;
+    for (auto cls : program_classes(_program)) {
+        if (!cls->is_element() || cls->state() != Def::Resolved ||
+            cls->name() == _program->class_options().empty_element_name)
+            continue;
+        if (!cls->has_fun(name_id))
+            continue;
+        auto matches = cls->fun(name_id)->find_match(cls, {});
+        if (matches.size() != 1)
+            continue;
+        auto elt_id = cls->element_id();
+        if (_behave.size() <= elt_id)
+            _behave.resize(elt_id + 1);
+        _behave[elt_id] = *matches.begin();
+    }
+}
+
+// Evaluation caches (local types, constant folding, call sites, bytecode,
+// native bindings) are filled lazily and not synchronized, so every function
+// is evaluated here once with each effective class it can be called with.
+// Workers do not add entries, a cache miss is evaluated without caching.
+void Sim::prepare() {
+    PrepareEnv env{_program};
+    const auto& options = _program->eval_options();
+    bool compile = options.bytecode && options.local_slots;
+
+    auto prepare_fset = [&](Ref<Class> cls, Ref<FunSet> fset) {
+        if (!fset)
+            return;
+        for (auto fun : *fset) {
+            if (fun->is_native()) {
+                _program->natives().bind(fun);
+                continue;
+            }
+            if (fun->is_pure_virtual())
+                continue;
+            try {
+                env.eval_noexec(fun, cls);
+                if (compile) {
+                    // eff. class is not set unless base is selected
+                    sema::EvalVm vm{env};
+                    vm.compile(fun, {});
+                    vm.compile(fun, cls);
+                }
+            } catch (const sema::EvalExcept&) {}
+        }
+    };
+
+    // evaluation can add template instances, repeat until there are none
+    std::set<Ref<Class>> prepared;
+    bool added = true;
+    while (added) {
+        added = false;
+        for (auto cls : program_classes(_program)) {
+            if (cls->state() != Def::Resolved || !prepared.insert(cls).second)
+                continue;
+            added = true;
+            // including inherited functions
+            for (auto& [_, sym] : cls->members()) {
+                if (sym.is<FunSet>())
+                    prepare_fset(cls, sym.get<FunSet>());
+            }
+#define FUN_OP(name, fun_op) prepare_fset(cls, cls->op(Op::fun_op));
+#include <libulam/semantic/fun_ops.inc.hpp>
+#undef FUN_OP
+            if (cls->has_constructors())
+                prepare_fset(cls, cls->constructors());
+        }
+    }
+}
+
+void Sim::run_worker(
+    unsigned worker,
+    unsigned worker_num,
+    std::size_t event_num,
+    SimStats& stats) {
+    SimEnv env{
+        _program,
+        (worker_num > 1) ? sema::evl::ReadOnlyCaches : sema::evl::NoFlags};
+    auto& window = env.window();
+    std::mt19937_64 rng{_options.seed + worker};
+
+    std::vector<Ref<Tile>> tiles;
+    for (unsigned n = worker; n < _tiles.size(); n += worker_num)
+        tiles.push_back(ref(_tiles[n]));
+    std::uniform_int_distribution<std::size_t> tile_dist{0, tiles.size() - 1};
+
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (std::size_t n = 0; n < event_num; ++n) {
+        ++stats.events;
+
+        // random site
+        auto tile = tiles[tile_dist(rng)];
+        unsigned x = tile->x + rng() % tile->width;
+        unsigned y = tile->y + rng() % tile->height;
+
+        // lock tiles overlapped by window, in order of index
+        if (worker_num > 1) {
+            constexpr int R = EventWindow::Radius;
+            const int size = _options.tile_size;
+            const int max_x = _grid.width() - 1;
+            const int max_y = _grid.height() - 1;
+            int tx0 = std::max((int)x - R, 0) / size;
+            int tx1 = std::min((int)x + R, max_x) / size;
+            int ty0 = std::max((int)y - R, 0) / size;
+            int ty1 = std::min((int)y + R, max_y) / size;
+            locks.clear();
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx)
+                    locks.emplace_back(_tiles[ty * _tiles_x + tx]->mutex);
+            }
+        }
+
+        auto elt_id = _grid.element_id(x, y);
+        auto fun = behave(elt_id);
+        if (!fun)
+            continue;
+
+        window.load(_grid, x, y);
+        try {
+            auto cls = _program->elements().get(elt_id);
+            auto self = window.atom(0).as(cls);
+            env.funcall(fun->node(), fun, {cls, Value{self}}, {});
+            window.store(_grid);
+        } catch (const sema::EvalExcept&) {
+            ++stats.failed;
+        }
+    }
+    locks.clear();
+}
+
+} // namespace ulam::sim
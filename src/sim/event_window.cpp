@@ -0,0 +1,71 @@
+#include <array>
+#include <cstdlib>
+#include <libulam/semantic/type/builtin/atom.hpp>
+#include <libulam/semantic/type/builtins.hpp>
+#include <libulam/sim/event_window.hpp>
+#include <libulam/sim/grid.hpp>
+
+namespace ulam::sim {
+
+namespace {
+
+using Offsets = std::array<EventWindow::Offset, EventWindow::Size>;
+
+Offsets make_offsets() {
+    constexpr int R = EventWindow::Radius;
+    Offsets offs;
+    unsigned n = 0;
+    for (int dist = 0; dist <= R; ++dist) {
+        for (int x = -dist; x <= dist; ++x) {
+            for (int y = -dist; y <= dist; ++y) {
+                if (std::abs(x) + std::abs(y) == dist)
+                    offs[n++] = {x, y};
+            }
+        }
+    }
+    ulam_assert(n == EventWindow::Size);
+    return offs;
+}
+
+} // namespace
+
+EventWindow::Offset EventWindow::offset(array_idx_t site) {
+    static const Offsets offs = make_offsets();
+    ulam_assert(site < Size);
+    return offs[site];
+}
+
+EventWindow::EventWindow(Builtins& builtins):
+    _atoms{builtins.atom_type()->array_type(Size)->construct_default()} {}
+
+void EventWindow::load(const Grid& grid, int x, int y) {
+    static const Bits Empty{ULAM_ATOM_SIZE};
+    _x = x;
+    _y = y;
+    for (array_idx_t site = 0; site < Size; ++site) {
+        auto off = offset(site);
+        int site_x = x + off.x;
+        int site_y = y + off.y;
+        bool live = grid.has(site_x, site_y);
+        _live[site] = live;
+        auto bits = atom(site).data_view().bits();
+        bits.write(0, live ? grid.site(site_x, site_y).view() : Empty.view());
+    }
+}
+
+void EventWindow::store(Grid& grid) {
+    for (array_idx_t site = 0; site < Size; ++site) {
+        if (!_live[site])
+            continue;
+        auto off = offset(site);
+        auto bits = atom(site).data_view().bits();
+        grid.site(_x + off.x, _y + off.y).write(0, bits);
+    }
+}
+
+LValue EventWindow::atom(array_idx_t site) {
+    ulam_assert(site < Size);
+    return _atoms.array_access(site, false);
+}
+
+} // namespace ulam::sim
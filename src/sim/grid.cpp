@@ -0,0 +1,32 @@
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/sim/grid.hpp>
+
+namespace ulam::sim {
+
+Grid::Grid(unsigned width, unsigned height): _width{width}, _height{height} {
+    ulam_assert(width > 0 && height > 0);
+    _sites.reserve((std::size_t)width * height);
+    for (std::size_t n = 0; n < (std::size_t)width * height; ++n)
+        _sites.emplace_back(ULAM_ATOM_SIZE);
+}
+
+elt_id_t Grid::element_id(unsigned x, unsigned y) const {
+    return site(x, y).read(AtomEltIdOff, AtomEltIdSize);
+}
+
+void Grid::set(unsigned x, unsigned y, Ref<Class> elt) {
+    ulam_assert(elt->is_element());
+    auto rval = elt->construct_default();
+    site(x, y).write(0, rval.get<DataPtr>()->bits().view());
+}
+
+void Grid::clear(unsigned x, unsigned y) { site(x, y) = Bits{ULAM_ATOM_SIZE}; }
+
+std::size_t Grid::count(elt_id_t elt_id) const {
+    std::size_t num = 0;
+    for (const auto& bits : _sites)
+        num += (bits.read(AtomEltIdOff, AtomEltIdSize) == elt_id);
+    return num;
+}
+
+} // namespace ulam::sim
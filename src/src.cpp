@@ -1,8 +1,19 @@
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <libulam/memory/buf.hpp>
 #include <libulam/src.hpp>
 
+#if defined(__unix__) || defined(__APPLE__)
+#    define ULAM_SRC_MMAP 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#else
+#    define ULAM_SRC_MMAP 0
+#endif
+
 namespace ulam {
 
 namespace {
@@ -27,33 +38,89 @@ mem::Buf file_content(const std::filesystem::path& path) {
 
 const mem::BufRef Src::line(linum_t linum) {
     ulam_assert(linum > 0);
+    index_lines(linum);
     const auto buf = content();
-    const char* start = buf.start();
-    if (linum > _line_off.size()) {
-        std::size_t off = _line_off.empty() ? 0 : _line_off.back();
-        const char* cur = start + off;
-        bool is_eof = false;
-        do {
-            while (cur[0] != '\n' && cur[0] != '\0')
-                ++cur;
-            is_eof = (cur[0] == '\0');
-            if (!is_eof)
-                ++cur;
-            _line_off.push_back(cur - start);
-        } while (linum > _line_off.size() && !is_eof);
-    }
     if (linum > _line_off.size())
         return {buf.end(), 0};
     std::size_t off = (linum < 2) ? 0 : _line_off[linum - 2];
-    return {start + off, _line_off[linum - 1] - off};
+    return {buf.start() + off, _line_off[linum - 1] - off};
+}
+
+linum_t Src::linum_at(std::size_t off) {
+    index_lines(0);
+    ulam_assert(!_line_off.empty());
+    // last offset is end of last line
+    auto it = std::upper_bound(_line_off.begin(), _line_off.end() - 1, off);
+    return (it - _line_off.begin()) + 1;
+}
+
+void Src::index_lines(linum_t linum) {
+    if (_is_indexed || (linum > 0 && linum <= _line_off.size()))
+        return;
+    const auto buf = content();
+    const char* start = buf.start();
+    std::size_t off = _line_off.empty() ? 0 : _line_off.back();
+    const char* cur = start + off;
+    bool is_eof = false;
+    do {
+        while (cur[0] != '\n' && cur[0] != '\0')
+            ++cur;
+        is_eof = (cur[0] == '\0');
+        if (!is_eof)
+            ++cur;
+        _line_off.push_back(cur - start);
+    } while ((linum == 0 || linum > _line_off.size()) && !is_eof);
+    _is_indexed = is_eof;
 }
 
+FileSrc::~FileSrc() { unmap(); }
+
 const mem::BufRef FileSrc::content() {
     // TODO: error handling
-    if (!_buf)
+    if (!_map && !_buf && !map())
         _buf = file_content(_path);
+    if (_map)
+        return {static_cast<const char*>(_map), _map_size + 1};
     ulam_assert(_buf);
     return _buf->ref();
 }
 
+bool FileSrc::map() {
+#if ULAM_SRC_MMAP
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    std::size_t size = st.st_size;
+    std::size_t page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0 || size % page_size == 0) {
+        // no room for \0
+        close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    _map = map;
+    _map_size = size;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileSrc::unmap() {
+#if ULAM_SRC_MMAP
+    if (_map)
+        munmap(_map, _map_size);
+#endif
+    _map = nullptr;
+    _map_size = 0;
+}
+
 } // namespace ulam
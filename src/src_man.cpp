@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <libulam/assert.hpp>
 #include <libulam/src_loc.hpp>
 #include <libulam/src_man.hpp>
@@ -5,62 +6,99 @@
 namespace ulam {
 
 Src* SrcMan::string(std::string text, Path path) {
+    auto lock = this->lock();
     ulam_assert(_src_map.count(path) == 0);
-    auto ptr = std::make_unique<StrSrc>(_srcs.size(), std::move(text), path);
-    if (!path.empty())
-        _src_map[path] = ptr.get();
-    _srcs.emplace_back(std::move(ptr));
-    return _srcs.back().get();
+    return add(std::make_unique<StrSrc>(_srcs.size(), std::move(text), path));
 }
 
 Src* SrcMan::file(Path path) {
+    auto lock = this->lock();
     ulam_assert(_src_map.count(path) == 0);
-    auto ptr = std::make_unique<FileSrc>(_srcs.size(), path);
-    if (!path.empty())
-        _src_map[path] = ptr.get();
-    _srcs.push_back(std::move(ptr));
-    return _srcs.back().get();
+    return add(std::make_unique<FileSrc>(_srcs.size(), path));
 }
 
 Src* SrcMan::src(src_id_t src_id) {
+    auto lock = this->lock();
     ulam_assert(src_id < _srcs.size());
     return _srcs[src_id].get();
 }
 
 Src* SrcMan::src(const Path& path) {
+    auto lock = this->lock();
     auto it = _src_map.find(path);
     return (it != _src_map.end()) ? it->second : nullptr;
 }
 
-loc_id_t
-SrcMan::loc_id(src_id_t src_id, const char* ptr, linum_t linum, chr_t chr) {
-    loc_id_t id = _locs.size();
-    _locs.emplace_back(src_id, ptr, linum, chr);
-    return id;
+loc_id_t SrcMan::loc_id(src_id_t src_id, const char* ptr) {
+    auto lock = this->lock();
+    ulam_assert(src_id < _srcs.size());
+    const auto buf = _srcs[src_id]->content();
+    ulam_assert(buf.start() <= ptr && ptr < buf.end());
+    auto& start = _loc_starts[src_id];
+    if (start == NoLocId) {
+        ulam_assert(buf.size() < (std::size_t)(NoLocId - _loc_end));
+        start = _loc_end;
+        _loc_end += buf.size();
+        _loc_srcs.emplace_back(start, src_id);
+    }
+    return start + (ptr - buf.start());
 }
 
 SrcLoc SrcMan::loc(loc_id_t loc_id) {
-    ulam_assert(loc_id != NoLocId);
-    ulam_assert(loc_id < _locs.size());
-    return _locs[loc_id];
+    auto lock = this->lock();
+    auto [src, off] = src_off(loc_id);
+    auto linum = src->linum_at(off);
+    auto line = src->line(linum);
+    chr_t chr = src->content().start() + off - line.start() + 1;
+    return {src->id(), off, linum, chr};
 }
 
 std::string_view SrcMan::str_at(const SrcLoc& loc, std::size_t size, int off) {
-    // TODO: remove ptr from loc
-    return {loc.ptr() + off, size};
+    auto lock = this->lock();
+    return {src(loc.src_id())->content().start() + loc.off() + off, size};
 }
 
 std::string_view SrcMan::str_at(loc_id_t loc_id, std::size_t size, int off) {
-    return str_at(loc(loc_id), size, off);
+    auto lock = this->lock();
+    auto [src, src_off] = this->src_off(loc_id);
+    return {src->content().start() + src_off + off, size};
 }
 
 std::string_view SrcMan::line_at(const SrcLoc& loc) {
+    auto lock = this->lock();
     auto ref = src(loc.src_id())->line(loc.linum());
     return {ref.start(), ref.size()};
 }
 
 std::string_view SrcMan::line_at(loc_id_t loc_id) {
+    auto lock = this->lock();
     return line_at(loc(loc_id));
 }
 
+std::unique_lock<std::recursive_mutex> SrcMan::lock() {
+    return _locking ? std::unique_lock{*_mutex}
+                    : std::unique_lock<std::recursive_mutex>{};
+}
+
+Src* SrcMan::add(std::unique_ptr<Src>&& src) {
+    ulam_assert(_srcs.size() < (src_id_t)-1);
+    if (!src->path().empty())
+        _src_map[src->path()] = src.get();
+    _srcs.push_back(std::move(src));
+    _loc_starts.push_back(NoLocId);
+    return _srcs.back().get();
+}
+
+std::pair<Src*, std::size_t> SrcMan::src_off(loc_id_t loc_id) {
+    auto lock = this->lock();
+    ulam_assert(loc_id != NoLocId);
+    ulam_assert(loc_id < _loc_end);
+    auto it = std::upper_bound(
+        _loc_srcs.begin(), _loc_srcs.end(), loc_id,
+        [](loc_id_t loc_id, const auto& item) { return loc_id < item.first; });
+    ulam_assert(it != _loc_srcs.begin());
+    --it;
+    return {src(it->second), loc_id - it->first};
+}
+
 } // namespace ulam
@@ -12,20 +12,21 @@ bool StrPoolBase::has_id(str_id_t id) const {
 
 const std::string_view StrPoolBase::get(str_id_t id) const {
     ulam_assert(id != NoStrId);
-    ulam_assert(id < _index.size());
-    return _index[id];
+    return _index.get(id);
 }
 
 StrPoolBase::PairT StrPoolBase::store(const std::string_view str, bool copy) {
+    std::lock_guard<std::mutex> lock{_store_mutex};
+    ulam_assert(_index.size() < NoStrId);
     auto copied = copy ? _notepad.write(str) : str;
-    str_id_t id = _index.size();
-    _index.push_back(copied);
+    str_id_t id = _index.push_back(copied);
     return {id, copied};
 }
 
 // UniqStrPool
 
-UniqStrPool::UniqStrPool(UniqStrPool* parent): StrPoolBase{}, _parent{parent} {
+UniqStrPool::UniqStrPool(UniqStrPool* parent):
+    StrPoolBase{}, _parent{parent}, _map{_index} {
     if (_parent) {
         _offset = _parent->_offset + _parent->_index.size();
         _parent->_is_locked = true; // lock parent
@@ -33,17 +34,21 @@ UniqStrPool::UniqStrPool(UniqStrPool* parent): StrPoolBase{}, _parent{parent} {
 }
 
 bool UniqStrPool::has(const std::string_view str) const {
-    return _map.count(str) == 1 || (_parent && _parent->has(str));
+    return id(str) != NoStrId;
 }
 
 str_id_t UniqStrPool::id(const std::string_view str) const {
+    return id(str, StrIdMap::hash(str));
+}
+
+str_id_t UniqStrPool::id(const std::string_view str, hash_t hash) const {
     if (_parent) {
-        auto str_id = _parent->id(str);
+        auto str_id = _parent->id(str, hash);
         if (str_id != NoStrId)
             return str_id;
     }
-    auto it = _map.find(str);
-    return (it != _map.end()) ? it->second + _offset : NoStrId;
+    auto idx = _map.find(str, hash);
+    return (idx != StrIdMap::NoIdx) ? idx + _offset : NoStrId;
 }
 
 const std::string_view UniqStrPool::get(str_id_t id) const {
@@ -56,16 +61,18 @@ const std::string_view UniqStrPool::get(str_id_t id) const {
 
 str_id_t UniqStrPool::put(const std::string_view str, bool copy) {
     ulam_assert(!_is_locked);
-    if (_parent) {
-        auto str_id = _parent->id(str);
-        if (str_id != NoStrId)
-            return str_id;
-    }
-    auto it = _map.find(str);
-    if (it != _map.end())
-        return it->second;
+    auto hash = StrIdMap::hash(str);
+    auto str_id = id(str, hash);
+    if (str_id != NoStrId)
+        return str_id;
+
+    // re-check under shard lock
+    auto lock = _map.lock(hash);
+    auto idx = _map.find(str, hash);
+    if (idx != StrIdMap::NoIdx)
+        return idx + _offset;
     auto stored = store(str, copy);
-    _map[stored.second] = stored.first;
+    _map.add(hash, stored.first);
     return stored.first + _offset;
 }
 
@@ -0,0 +1,86 @@
+#include <libulam/assert.hpp>
+#include <libulam/str_pool/id_map.hpp>
+
+namespace ulam {
+
+// StrIdMap::Table
+
+StrIdMap::Table::Table(std::size_t size):
+    _mask{size - 1}, _slots{new std::atomic<std::uint64_t>[size]} {
+    ulam_assert((size & _mask) == 0);
+    for (std::size_t pos = 0; pos < size; ++pos)
+        _slots[pos].store(0, std::memory_order_relaxed);
+}
+
+void StrIdMap::Table::add(std::uint64_t value) {
+    ulam_assert(value != 0);
+    ulam_assert(_size < capacity());
+    auto pos = (hash_t)(value >> 32);
+    while (_slots[pos & _mask].load(std::memory_order_relaxed) != 0)
+        ++pos;
+    _slots[pos & _mask].store(value, std::memory_order_release);
+    ++_size;
+}
+
+// StrIdMap
+
+StrIdMap::StrIdMap(const StrIndex& index): _index{index} {
+    for (auto& shard : _shards) {
+        shard.tables.push_back(make<Table>(FirstTableSize));
+        shard.table.store(ref(shard.tables.back()), std::memory_order_release);
+    }
+}
+
+StrIdMap::hash_t StrIdMap::hash(std::string_view str) {
+    // FNV-1a
+    hash_t hash = 2166136261u;
+    for (unsigned char ch : str) {
+        hash ^= ch;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+StrIdMap::idx_t StrIdMap::find(std::string_view str, hash_t hash) const {
+    const auto& shard = _shards[shard_idx(hash)];
+    auto table = shard.table.load(std::memory_order_acquire);
+    for (std::size_t pos = hash;; ++pos) {
+        auto value = table->slot(pos);
+        if (value == 0)
+            return NoIdx;
+        if ((hash_t)(value >> 32) == hash) {
+            idx_t idx = (idx_t)value - 1;
+            if (_index.get(idx) == str)
+                return idx;
+        }
+    }
+}
+
+std::unique_lock<std::mutex> StrIdMap::lock(hash_t hash) {
+    return std::unique_lock<std::mutex>{_shards[shard_idx(hash)].mutex};
+}
+
+void StrIdMap::add(hash_t hash, idx_t idx) {
+    ulam_assert(idx != NoIdx);
+    auto& shard = _shards[shard_idx(hash)];
+    auto table = ref(shard.tables.back());
+    std::uint64_t value = ((std::uint64_t)hash << 32) | ((std::uint64_t)idx + 1);
+
+    // grow at 1/2 load, old table stays readable
+    if ((table->size() + 1) * 2 > table->capacity()) {
+        auto grown = make<Table>(table->capacity() * 2);
+        for (std::size_t pos = 0; pos < table->capacity(); ++pos) {
+            auto old_value = table->slot(pos);
+            if (old_value != 0)
+                grown->add(old_value);
+        }
+        grown->add(value);
+        shard.tables.push_back(std::move(grown));
+        shard.table.store(
+            ref(shard.tables.back()), std::memory_order_release);
+        return;
+    }
+    table->add(value);
+}
+
+} // namespace ulam
@@ -0,0 +1,44 @@
+#include <libulam/assert.hpp>
+#include <libulam/str_pool/index.hpp>
+
+namespace ulam {
+
+StrIndex::StrIndex() {
+    for (auto& chunk : _chunks)
+        chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+StrIndex::~StrIndex() {
+    for (auto& chunk : _chunks)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
+
+std::string_view StrIndex::get(std::size_t idx) const {
+    ulam_assert(idx < size());
+    auto [chunk, off] = locate(idx);
+    return _chunks[chunk].load(std::memory_order_acquire)[off];
+}
+
+std::size_t StrIndex::push_back(std::string_view str) {
+    auto idx = _size.load(std::memory_order_relaxed);
+    auto [chunk, off] = locate(idx);
+    ulam_assert(chunk < ChunkNum);
+    auto items = _chunks[chunk].load(std::memory_order_relaxed);
+    if (!items) {
+        items = new std::string_view[chunk_size(chunk)];
+        _chunks[chunk].store(items, std::memory_order_release);
+    }
+    items[off] = str;
+    _size.store(idx + 1, std::memory_order_release);
+    return idx;
+}
+
+std::pair<unsigned, std::size_t> StrIndex::locate(std::size_t idx) {
+    // chunk N starts at (2^N - 1) * FirstChunkSize
+    std::size_t pos = idx + chunk_size(0);
+    unsigned bit = 63 - __builtin_clzll(pos);
+    unsigned chunk = bit - FirstChunkBits;
+    return {chunk, pos - chunk_size(chunk)};
+}
+
+} // namespace ulam
@@ -1,25 +1,105 @@
 #include "src/detail/string.hpp"
-#include <libulam/assert.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <libulam/assert.hpp>
 #include <libulam/semantic/ops.hpp>
 #include <libulam/token.hpp>
-#include <map>
 
 namespace ulam::tok {
 namespace {
 
-auto make_keyword_type_table() {
+// Keywords are looked up in a perfect hash table built at compile time:
+// hash seed is chosen so that every keyword gets its own slot.
+
+struct Keyword {
+    std::string_view str;
+    Type type;
+};
+
+constexpr bool is_keyword(const char* str) {
+    return str && (str[0] == '@' || detail::is_word(str[0]));
+}
+
+constexpr std::size_t keyword_num() {
+    std::size_t num = 0;
+#define TOK(str, type)                                                         \
+    if (is_keyword(str))                                                       \
+        ++num;
+#include <libulam/token.inc.hpp>
+#undef TOK
+    return num;
+}
+
+constexpr std::size_t KeywordNum = keyword_num();
+using KeywordList = std::array<Keyword, KeywordNum>;
+
+constexpr KeywordList make_keywords() {
     // "_dummy_" keys are never inserted, they are only here to keep
     // compiler happy
-    std::map<std::string_view, Type> table;
+    KeywordList keywords{};
+    std::size_t idx = 0;
 #define TOK(str, type)                                                         \
-    if (str && (*((char*)str) == '@' || detail::is_word(*(char*)str)))         \
-        table[str ? str : "_dummy_"] = type;
+    if (is_keyword(str))                                                       \
+        keywords[idx++] = {str ? str : "_dummy_", type};
 #include <libulam/token.inc.hpp>
 #undef TOK
-    return table;
+    return keywords;
+}
+
+constexpr KeywordList Keywords = make_keywords();
+
+constexpr std::size_t max_keyword_size() {
+    std::size_t size = 0;
+    for (const auto& keyword : Keywords)
+        size = std::max(size, keyword.str.size());
+    return size;
+}
+
+constexpr std::size_t MaxKeywordSize = max_keyword_size();
+
+constexpr unsigned KeywordTableBits = 10;
+constexpr std::uint8_t NoKeyword = -1;
+static_assert(KeywordNum < NoKeyword);
+
+constexpr std::size_t keyword_slot(std::string_view str, std::uint32_t seed) {
+    std::uint32_t hash = seed;
+    for (char ch : str)
+        hash = (hash ^ static_cast<std::uint8_t>(ch)) * 16777619u;
+    return hash >> (32 - KeywordTableBits);
 }
 
+struct KeywordHashTable {
+    bool ok{false};
+    std::uint32_t seed{};
+    std::array<std::uint8_t, 1 << KeywordTableBits> slots{};
+};
+
+constexpr KeywordHashTable make_keyword_table() {
+    constexpr std::uint32_t MaxAttempts = 1000;
+    for (std::uint32_t attempt = 0; attempt < MaxAttempts; ++attempt) {
+        KeywordHashTable table{};
+        table.seed = 2166136261u + attempt;
+        for (auto& slot : table.slots)
+            slot = NoKeyword;
+        table.ok = true;
+        for (std::size_t idx = 0; idx < KeywordNum; ++idx) {
+            auto& slot = table.slots[keyword_slot(Keywords[idx].str, table.seed)];
+            if (slot != NoKeyword) {
+                table.ok = false;
+                break;
+            }
+            slot = idx;
+        }
+        if (table.ok)
+            return table;
+    }
+    return {};
+}
+
+constexpr KeywordHashTable KeywordTable = make_keyword_table();
+static_assert(KeywordTable.ok, "failed to build keyword hash table");
+
 } // namespace
 
 const char* type_str(tok::Type type) {
@@ -47,11 +127,12 @@ const char* type_name(tok::Type type) {
 }
 
 Type type_by_keyword(std::string_view str) {
-    static auto table{make_keyword_type_table()};
     ulam_assert(str[0] == '@' || detail::is_word(str[0]));
-    auto it = table.find(str);
-    if (it != table.end())
-        return it->second;
+    if (str.size() <= MaxKeywordSize) {
+        auto idx = KeywordTable.slots[keyword_slot(str, KeywordTable.seed)];
+        if (idx != NoKeyword && Keywords[idx].str == str)
+            return Keywords[idx].type;
+    }
     if (str[0] == '@')
         return InvalidAtKeyword;
     if (detail::is_upper(str[0]))
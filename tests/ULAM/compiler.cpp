@@ -1,8 +1,10 @@
 #include "./compiler.hpp"
+#include "./eval/native.hpp"
 #include "./out.hpp"
 #include "./utils.hpp"
 #include "tests/ast/print.hpp"
 #include <iostream>
+#include <libulam/parser/parallel.hpp>
 #include <libulam/sema.hpp>
 #include <libulam/sema/eval.hpp>
 #include <libulam/sema/eval/except.hpp>
@@ -27,31 +29,43 @@ void Compiler::parse_module_file(const Path& path) {
 }
 
 void Compiler::parse_module_str(const std::string& text, const Path& path) {
-    auto module = _parser.parse_module_str(text, path);
-    auto name = path.stem().string();
-    std::cerr << "parsing module " << name << "\n";
-    if (module) {
-        if (_ast->has_module(module->name_id()))
-            throw std::invalid_argument{
-                std::string{"duplicate module name "} + name};
-        // NOTE: only string modules to be compiled: all files are from stdlib
-        _module_name_ids.insert(module->name_id());
-        _ast->add_module(std::move(module));
-    }
+    add_module(_parser.parse_module_str(text, path), path);
+}
+
+void Compiler::parse_module_strs(
+    const std::vector<std::pair<Path, std::string_view>>& srcs,
+    unsigned jobs) {
+    ulam::ParallelParser parser{_ctx, _ast->ctx()};
+    for (const auto& [path, text] : _str_srcs)
+        parser.add_str_src(text, path);
+    for (const auto& [path, text] : srcs)
+        parser.add_module_str(std::string{text}, path);
+
+    auto modules = parser.parse(jobs);
+    for (unsigned n = 0; n < srcs.size(); ++n)
+        add_module(std::move(modules[n]), srcs[n].first);
 }
 
 void Compiler::add_str_src(const std::string& text, const Path& path) {
     _parser.add_str_src(text, path);
+    _str_srcs.emplace_back(path, text);
 }
 
 ulam::Ref<ulam::Program> Compiler::analyze() {
     // TEST {
+    // only modules of this test, base program modules are shared
     test::ast::Printer printer{std::cout, ulam::ref(_ast)};
-    printer.print();
+    for (unsigned n = 0; n < _ast->child_num(); ++n) {
+        auto module = _ast->get(n);
+        if (_module_name_ids.count(module->name_id()) > 0)
+            printer.print(module);
+    }
     // }
 
     auto program = ulam::sema::init(_ctx, ulam::ref(_ast));
     ulam_assert(program);
+    if (program->natives().empty())
+        EvalNative::add(program->natives()); // program can be extended
     ulam::sema::resolve(_ctx, program);
     return program;
 }
@@ -344,3 +358,17 @@ ulam::Ref<ulam::Program> Compiler::program() {
     ulam_assert(_ast->program());
     return _ast->program();
 }
+
+void Compiler::add_module(
+    ulam::Ptr<ulam::ast::ModuleDef>&& module, const Path& path) {
+    auto name = path.stem().string();
+    std::cerr << "parsing module " << name << "\n";
+    if (module) {
+        if (_ast->has_module(module->name_id()))
+            throw std::invalid_argument{
+                std::string{"duplicate module name "} + name};
+        // NOTE: only string modules to be compiled: all files are from stdlib
+        _module_name_ids.insert(module->name_id());
+        _ast->add_module(std::move(module));
+    }
+}
@@ -19,12 +19,22 @@ public:
 
     Compiler():
         _ctx{},
-        _ast{ulam::make<ulam::ast::Root>()},
-        _parser{_ctx, _ast->ctx().str_pool(), _ast->ctx().text_pool()} {}
+        _ast{ulam::make<ulam::ast::Root>(true /* use arena */)},
+        _parser{
+            _ctx, _ast->ctx().str_pool(), _ast->ctx().text_pool(),
+            _ast->ctx().arena()} {
+        // codegen visits every subexpression
+        _ctx.options.eval_options.fold_consts = false;
+    }
 
     void parse_module_file(const Path& path);
     void parse_module_str(const std::string& text, const Path& path);
 
+    // parses modules using `jobs' threads
+    void parse_module_strs(
+        const std::vector<std::pair<Path, std::string_view>>& srcs,
+        unsigned jobs);
+
     void add_str_src(const std::string& text, const Path& path);
 
     ulam::Ref<ulam::Program> analyze();
@@ -99,9 +109,12 @@ private:
 
     ulam::Ref<ulam::Program> program();
 
+    void add_module(ulam::Ptr<ulam::ast::ModuleDef>&& module, const Path& path);
+
     ulam::Context _ctx;
     ulam::Ptr<ulam::ast::Root> _ast;
     ulam::Parser _parser;
+    std::vector<std::pair<Path, std::string>> _str_srcs;
     std::set<ulam::str_id_t> _module_name_ids;
     std::vector<int> _statuses;
 };
@@ -1,13 +1,23 @@
+#include "./compiler.hpp"
 #include "./test_case.hpp"
 #include <algorithm>
+#include <chrono>
 #include <libulam/assert.hpp>
+#include <libulam/semantic/fun/call_cache.hpp>
+#include <libulam/semantic/value/bits.hpp>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <sys/wait.h>
+#include <unistd.h>
 
 constexpr char UlamPathEnv[] = "ULAM_PATH";
 
@@ -267,42 +277,328 @@ static const std::set<std::string> SkipExitStatusCheck = {
 using Path = std::filesystem::path;
 
 static void exit_usage(std::string name) {
-    std::cout << name << "[{<case-number>|'t<test-number>'}]\n";
+    std::cout << name
+              << " [-j <jobs>] [-p <parse-jobs>] [-k]"
+                 " [{<case-number>|'t<test-number>'}]\n";
     std::exit(-1);
 }
 
-static bool run(Path stdlib_dir, const Path& path, bool single) {
+// Stdlib modules parsed and analyzed once, test cases are run in forked
+// processes on top of (copy-on-write) base program
+class Stdlib {
+public:
+    explicit Stdlib(const Path& dir): _dir{dir} {}
+
+    Compiler& base(bool with_empty) {
+        auto& compiler = _bases[with_empty ? 1 : 0];
+        if (!compiler) {
+            compiler = std::make_unique<Compiler>();
+            compiler->parse_module_file(_dir / "UrSelf.ulam");
+            if (with_empty)
+                compiler->parse_module_file(_dir / "Empty.ulam");
+            if (!compiler->analyze())
+                throw std::invalid_argument("failed to analyze stdlib");
+        }
+        return *compiler;
+    }
+
+private:
+    Path _dir;
+    std::unique_ptr<Compiler> _bases[2]; // {w/o Empty, with Empty}
+};
+
+struct Stats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t uncacheable{0};
+    std::uint64_t copies{0};
+    std::uint64_t unshares{0};
+    std::uint64_t shares{0};
+
+    static Stats current() {
+        const auto& cache_stats = ulam::FunCallCache::stats();
+        const auto& bits_stats = ulam::Bits::stats();
+        return {
+            cache_stats.hits.load(),
+            cache_stats.misses.load(),
+            cache_stats.uncacheable.load(),
+            bits_stats.copies.load(),
+            bits_stats.unshares.load(),
+            bits_stats.shares.load()};
+    }
+
+    void add(const Stats& other, bool sub = false) {
+        auto op = [&](std::uint64_t& val, std::uint64_t other_val) {
+            val = sub ? val - other_val : val + other_val;
+        };
+        op(hits, other.hits);
+        op(misses, other.misses);
+        op(uncacheable, other.uncacheable);
+        op(copies, other.copies);
+        op(unshares, other.unshares);
+        op(shares, other.shares);
+    }
+};
+
+// collected from forked processes
+static Stats forked_stats;
+
+// number of threads parsing modules of a test case
+static unsigned parse_jobs = 1;
+
+static bool run(TestCase& test_case, Compiler& compiler) {
     try {
-        TestCase::flags_t flags = TestCase::NoFlags;
-        if (!single && SkipAnswerCheck.count(path.filename()) > 0)
-            flags |= TestCase::SkipAnswerCheck;
-        if (!single && SkipExitStatusCheck.count(path.filename()) > 0)
-            flags |= TestCase::SkipExitStatusCheck;
-        TestCase test_case{stdlib_dir, path, flags};
-        return test_case.run();
+        return test_case.run(compiler, parse_jobs);
     } catch (std::invalid_argument& e) {
         std::cerr << e.what() << "\n";
-        return false;
+    } catch (std::exception& exc) {
+        std::cout << "exception thrown\n";
     }
+    return false;
 }
 
-static bool
-run(Path stdlib_dir, unsigned n, std::vector<Path> test_paths, bool single) {
+// single test case, runs in-process
+static bool run(Stdlib& stdlib, unsigned n, std::vector<Path> test_paths) {
     ulam_assert(n > 0);
     auto& path = test_paths[n - 1];
     std::cout << "# " << std::dec << n << " " << path.filename() << "\n";
-    bool ok = true;
+    bool ok = false;
     try {
-        ok = run(stdlib_dir, path, single);
+        TestCase test_case{path};
+        ok = run(test_case, stdlib.base(!test_case.has_empty()));
+    } catch (std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
     } catch (std::exception& exc) {
         std::cout << "exception thrown\n";
-        ok = false;
     }
     std::cout << "# " << std::dec << n << " " << path.filename() << " "
               << (ok ? "OK" : "FAIL") << "\n";
     return ok;
 }
 
+// test case running in forked process, base compiler state is not affected
+struct TestRun {
+    using Clock = std::chrono::steady_clock;
+
+    unsigned n;
+    pid_t pid{-1};
+    int stats_fd{-1};
+    std::FILE* out{nullptr}; // captured stdout
+    std::FILE* err{nullptr}; // captured stderr
+    std::string out_text;
+    std::string err_text;
+    Clock::time_point start{};
+    double time{0};
+    bool ok{false};
+    bool done{false};
+};
+
+static std::string read_captured(std::FILE* file) {
+    std::string text;
+    std::rewind(file);
+    char buf[4096];
+    std::size_t size = 0;
+    while ((size = std::fread(buf, 1, sizeof(buf), file)) > 0)
+        text.append(buf, size);
+    std::fclose(file);
+    return text;
+}
+
+// returns false if process is not started
+static bool
+start(Stdlib& stdlib, const Path& path, TestRun& test_run, bool capture) {
+    test_run.start = TestRun::Clock::now();
+    try {
+        TestCase::flags_t flags = TestCase::NoFlags;
+        if (SkipAnswerCheck.count(path.filename()) > 0)
+            flags |= TestCase::SkipAnswerCheck;
+        if (SkipExitStatusCheck.count(path.filename()) > 0)
+            flags |= TestCase::SkipExitStatusCheck;
+        TestCase test_case{path, flags};
+        auto& compiler = stdlib.base(!test_case.has_empty());
+
+        int fds[2];
+        if (pipe(fds) != 0)
+            throw std::runtime_error("pipe failed");
+        if (capture) {
+            test_run.out = std::tmpfile();
+            test_run.err = std::tmpfile();
+            if (!test_run.out || !test_run.err)
+                throw std::runtime_error("failed to create temporary file");
+        }
+        std::cout.flush();
+        std::cerr.flush();
+
+        test_run.pid = fork();
+        if (test_run.pid < 0)
+            throw std::runtime_error("fork failed");
+        if (test_run.pid == 0) {
+            close(fds[0]);
+            if (capture) {
+                dup2(fileno(test_run.out), STDOUT_FILENO);
+                dup2(fileno(test_run.err), STDERR_FILENO);
+            }
+            auto stats = Stats::current();
+            bool ok = run(test_case, compiler);
+            std::cout.flush();
+            std::cerr.flush();
+            // send stats diff to parent
+            auto diff = Stats::current();
+            diff.add(stats, true);
+            [[maybe_unused]] auto size = write(fds[1], &diff, sizeof(diff));
+            close(fds[1]);
+            std::_Exit(ok ? 0 : 1); // skip cleanup
+        }
+        close(fds[1]);
+        test_run.stats_fd = fds[0];
+        return true;
+
+    } catch (std::invalid_argument& e) {
+        test_run.err_text = std::string{e.what()} + "\n";
+    } catch (std::exception& exc) {
+        test_run.out_text = "exception thrown\n";
+    }
+    test_run.done = true;
+    return false;
+}
+
+static void finish(TestRun& test_run, int status) {
+    test_run.time = std::chrono::duration<double>(
+                        TestRun::Clock::now() - test_run.start)
+                        .count();
+
+    Stats diff;
+    if (read(test_run.stats_fd, &diff, sizeof(diff)) == sizeof(diff))
+        forked_stats.add(diff);
+    close(test_run.stats_fd);
+
+    if (test_run.out) {
+        test_run.out_text = read_captured(test_run.out);
+        test_run.err_text = read_captured(test_run.err);
+    }
+    if (WIFSIGNALED(status)) {
+        test_run.out_text +=
+            "terminated by signal " + std::to_string(WTERMSIG(status)) + "\n";
+    }
+    test_run.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    test_run.done = true;
+}
+
+// first `printed_num' test runs are reported
+static void print_summary(
+    const std::vector<Path>& test_paths,
+    const std::vector<TestRun>& test_runs,
+    std::size_t printed_num) {
+    constexpr unsigned SlowestNum = 10;
+
+    unsigned passed = 0, failed = 0;
+    std::vector<const TestRun*> finished;
+    for (std::size_t i = 0; i < printed_num; ++i) {
+        const auto& test_run = test_runs[i];
+        ++(test_run.ok ? passed : failed);
+        finished.push_back(&test_run);
+    }
+    std::cout << "# " << std::dec << passed << " passed, " << failed
+              << " failed, " << (test_runs.size() - passed - failed)
+              << " not run\n";
+
+    auto num = std::min<std::size_t>(SlowestNum, finished.size());
+    std::partial_sort(
+        finished.begin(), finished.begin() + num, finished.end(),
+        [](auto a, auto b) { return a->time > b->time; });
+    if (num > 0)
+        std::cout << "# slowest:\n";
+    for (std::size_t i = 0; i < num; ++i) {
+        std::cout << "#   " << std::fixed << std::setprecision(3)
+                  << finished[i]->time << "s " << finished[i]->n << " "
+                  << test_paths[finished[i]->n - 1].filename() << "\n";
+    }
+    std::cout << std::defaultfloat;
+}
+
+// Runs up to `jobs' test processes at a time, output of each test is printed
+// in test order (captured if more than one job)
+static bool run(
+    Stdlib& stdlib,
+    const std::vector<Path>& test_paths,
+    unsigned jobs,
+    bool keep_going) {
+    ulam_assert(jobs > 0);
+    const bool capture = jobs > 1;
+
+    std::vector<TestRun> test_runs;
+    for (unsigned n = 1; n <= test_paths.size(); ++n) {
+        if (Skip.count(test_paths[n - 1].filename()) == 0)
+            test_runs.push_back({n});
+    }
+
+    auto print_header = [&](const TestRun& test_run) {
+        std::cout << "# " << std::dec << test_run.n << " "
+                  << test_paths[test_run.n - 1].filename() << "\n";
+    };
+
+    std::size_t next = 0;
+    std::size_t printed = 0;
+    unsigned running = 0;
+    bool stop = false;
+    while ((!stop && printed < test_runs.size()) || running > 0) {
+        // start
+        while (!stop && running < jobs && next < test_runs.size()) {
+            auto& test_run = test_runs[next++];
+            if (!capture)
+                print_header(test_run);
+            if (start(stdlib, test_paths[test_run.n - 1], test_run, capture))
+                ++running;
+            if (!capture)
+                break; // wait for output before next header
+        }
+
+        // wait
+        if (running > 0) {
+            int status = 0;
+            pid_t pid = waitpid(-1, &status, 0);
+            if (pid < 0)
+                throw std::runtime_error("waitpid failed");
+            for (std::size_t i = printed; i < next; ++i) {
+                auto& test_run = test_runs[i];
+                if (test_run.pid == pid && !test_run.done) {
+                    finish(test_run, status);
+                    --running;
+                    break;
+                }
+            }
+        }
+
+        // print in order
+        while (!stop && printed < next && test_runs[printed].done) {
+            const auto& test_run = test_runs[printed++];
+            if (capture)
+                print_header(test_run);
+            std::cout << test_run.out_text;
+            std::cerr << test_run.err_text;
+            std::cout << "# " << std::dec << test_run.n << " "
+                      << test_paths[test_run.n - 1].filename() << " "
+                      << (test_run.ok ? "OK" : "FAIL") << "\n";
+            stop = !test_run.ok && !keep_going;
+        }
+    }
+    print_summary(test_paths, test_runs, printed);
+
+    return std::all_of(
+        test_runs.begin(), test_runs.begin() + printed,
+        [](const TestRun& test_run) { return test_run.ok; });
+}
+
+static void print_stats() {
+    auto stats = Stats::current();
+    stats.add(forked_stats);
+    std::cout << "# call cache: " << stats.hits << " hits, " << stats.misses
+              << " misses, " << stats.uncacheable << " uncacheable\n";
+    std::cout << "# bits storage: " << stats.copies << " copies ("
+              << stats.unshares << " on write), " << stats.shares
+              << " shared\n";
+}
+
 int main(int argc, char** argv) {
     // ULAM root
     const char* ulam_path_env = std::getenv(UlamPathEnv);
@@ -311,19 +607,44 @@ int main(int argc, char** argv) {
         std::exit(-1);
     }
     const Path ulam_src_root{ulam_path_env};
-    if (argc > 2)
+
+    // options
+    unsigned jobs = 1;
+    bool keep_going = false;
+    int argn = 1;
+    for (; argn < argc && argv[argn][0] == '-'; ++argn) {
+        std::string_view opt{argv[argn]};
+        if (opt == "-k") {
+            keep_going = true;
+        } else if (opt.substr(0, 2) == "-j" || opt.substr(0, 2) == "-p") {
+            std::string num{opt.substr(2)};
+            if (num.empty() && ++argn < argc)
+                num = argv[argn];
+            unsigned& val = (opt[1] == 'j') ? jobs : parse_jobs;
+            try {
+                val = std::stoul(num);
+            } catch (std::exception&) {
+                exit_usage(argv[0]);
+            }
+            if (val == 0)
+                exit_usage(argv[0]);
+        } else {
+            exit_usage(argv[0]);
+        }
+    }
+    if (argc - argn > 1)
         exit_usage(argv[0]);
 
     // ULAM paths
-    const Path stdlib_dir{ulam_src_root / "share" / "ulam" / "stdlib"};
+    Stdlib stdlib{ulam_src_root / "share" / "ulam" / "stdlib"};
     const Path test_src_dir{
         ulam_src_root / "src" / "test" / "generic" / "safe"};
 
     // case number/test name
     unsigned case_num = 0;
     std::string test_name;
-    if (argc > 1) {
-        std::string_view arg{argv[1]};
+    if (argn < argc) {
+        std::string_view arg{argv[argn]};
         if (arg.empty())
             exit_usage(argv[0]);
         if (arg[0] == 't') {
@@ -343,7 +664,7 @@ int main(int argc, char** argv) {
 
     if (case_num != 0) {
         if (case_num <= test_paths.size()) {
-            run(stdlib_dir, case_num, test_paths, true);
+            run(stdlib, case_num, test_paths);
         } else {
             std::cout << "case not found\n";
         }
@@ -355,18 +676,15 @@ int main(int argc, char** argv) {
                        test_name;
             });
         if (it != test_paths.end()) {
-            run(stdlib_dir, std::distance(test_paths.begin(), it) + 1,
-                test_paths, true);
+            run(stdlib, std::distance(test_paths.begin(), it) + 1,
+                test_paths);
         } else {
             std::cout << "test not found\n";
         }
 
     } else {
-        for (unsigned n = 1; n <= test_paths.size(); ++n) {
-            if (Skip.count(test_paths[n - 1].filename()) > 0)
-                continue;
-            if (!run(stdlib_dir, n, test_paths, false))
-                return -1;
-        }
+        if (!run(stdlib, test_paths, jobs, keep_going))
+            return -1;
     }
+    print_stats();
 }
@@ -3,8 +3,10 @@
 #include "./flags.hpp"
 #include "libulam/semantic/type/builtin_type_id.hpp"
 #include "libulam/semantic/value/types.hpp"
+#include <cstdlib>
 #include <libulam/sema/eval/flags.hpp>
 #include <libulam/sema/expr_error.hpp>
+#include <libulam/semantic/type/class.hpp>
 #include <string>
 
 #define NO_EXEC(fr)
@@ -114,10 +116,15 @@ ExprRes EvalFuncall::do_funcall_native(
     if (has_flag(ulam::sema::evl::NoExec))
         return empty_ret_val(node, fun);
 
-    auto res = call_native(node, fun, self, std::move(args));
-    return (res.error() != ulam::sema::ExprError::CannotEvalNative)
-               ? std::move(res)
-               : empty_ret_val(node, fun);
+    if (!program()->natives().bind(fun)) {
+        const auto class_name = fun->cls()->mangled_name();
+        const auto fun_name = fun->mangled_name();
+        auto message = std::string{"cannot eval native function "} +
+                       std::string{class_name} + "." + std::string{fun_name};
+        diag().notice(node->loc_id(), fun_name.size(), message);
+        std::exit(0);
+    }
+    return Base::do_funcall_native(node, fun, self, std::move(args));
 }
 
 ExprResList EvalFuncall::cast_args(
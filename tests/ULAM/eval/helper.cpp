@@ -1,6 +1,5 @@
 #include "./helper.hpp"
 #include "./flags.hpp"
-#include "./native.hpp"
 #include <libulam/assert.hpp>
 
 bool EvalHelper::in_main() const { return _env.stack_size() == 1; }
@@ -10,11 +9,3 @@ bool EvalHelper::codegen_enabled() const {
     ulam_assert(!is_enabled || _env.has_flag(ulam::sema::evl::NoExec));
     return is_enabled;
 }
-
-ulam::sema::ExprRes EvalHelper::call_native(
-    ulam::Ref<ulam::ast::Node> node,
-    ulam::Ref<ulam::Fun> fun,
-    ulam::LValue self,
-    ulam::sema::ExprResList&& args) {
-    return EvalNative{_env}.call(node, fun, self, std::move(args));
-}
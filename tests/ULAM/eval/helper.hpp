@@ -20,12 +20,6 @@ public:
 
     EvalTestContext& test_ctx() { return _env.test_ctx(); }
 
-    ulam::sema::ExprRes call_native(
-        ulam::Ref<ulam::ast::Node> node,
-        ulam::Ref<ulam::Fun> fun,
-        ulam::LValue self,
-        ulam::sema::ExprResList&& args);
-
     void set_status(int status) { _env.set_status(status); }
 
 private:
@@ -1,5 +1,4 @@
 #include "./native.hpp"
-#include <functional>
 #include <iostream>
 #include <libulam/assert.hpp>
 #include <libulam/sema/eval/except.hpp>
@@ -14,138 +13,98 @@
 namespace {
 
 using ExprRes = EvalNative::ExprRes;
-using ExprResList = EvalNative::ExprResList;
-using FunRef = EvalNative::FunRef;
-using NodeRef = EvalNative::NodeRef;
+using NativeCall = EvalNative::NativeCall;
 using EvalExceptAssert = ulam::sema::EvalExceptAssert;
 
 } // namespace
 
-EvalNative::EvalNative(EvalEnv& env):
-    ::EvalHelper{env},
-    Base{env},
-    _bar_atom{builtins().atom_type()->construct_default()} {
-#define ADD_METHOD(class_name, fun_name, method)                               \
-    do {                                                                       \
-        namespace ph = std::placeholders;                                      \
-        NamePair key{class_name, fun_name};                                    \
-        ulam_assert(_map.count(key) == 0);                                     \
-        _map.emplace(                                                          \
-            key, std::bind(                                                    \
-                     std::mem_fn(&EvalNative::method), this, ph::_1, ph::_2,   \
-                     ph::_3, ph::_4));                                         \
-    } while (false)
-
-    ADD_METHOD("System", "print@13i", eval_system_print_int);
-    ADD_METHOD("System", "print@14i", eval_system_print_int);
-    ADD_METHOD("System", "print@232i", eval_system_print_int);
-    ADD_METHOD("System", "print@232u", eval_system_print_unsigned);
-    ADD_METHOD("System", "print@13b", eval_system_print_unsigned_hex);
-    ADD_METHOD("System", "print@13y", eval_system_print_unsigned_hex);
-    ADD_METHOD("System", "assert@11b", eval_system_assert);
-    ADD_METHOD("SystemU3", "print@s", eval_system_print_string);
-    ADD_METHOD("SystemU5", "print@264i", eval_system_print_int);
-    ADD_METHOD("SystemU5", "print@264u", eval_system_print_unsigned);
-    ADD_METHOD("SystemU5", "print@s", eval_system_print_string);
-
-    ADD_METHOD("EventWindow", "aref@232i", eval_event_window_aref);
-    ADD_METHOD("EventWindow@232i", "aref@232i", eval_event_window_aref);
-    ADD_METHOD("Math", "max@*", eval_math_max);
-    ADD_METHOD("Bar", "aref@232i", eval_bar_aref);
-
-#undef ADD_METHOD
-}
-
-ExprRes EvalNative::call(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    const auto class_name = fun->cls()->mangled_name();
-    const auto fun_name = fun->mangled_name();
-    auto it = _map.find({class_name, fun_name});
-    if (it == _map.end()) {
-        auto message = std::string{"cannot eval native function "} +
-                       std::string{class_name} + "." + std::string{fun_name};
-        diag().notice(node->loc_id(), fun_name.size(), message);
-        std::exit(0);
-        return {ulam::sema::ExprError::CannotEvalNative};
-    }
-    return (it->second)(node, fun, self, std::move(args));
+void EvalNative::add(ulam::sema::NativeRegistry& natives) {
+    natives.add("System", "print@13i", eval_system_print_int);
+    natives.add("System", "print@14i", eval_system_print_int);
+    natives.add("System", "print@232i", eval_system_print_int);
+    natives.add("System", "print@232u", eval_system_print_unsigned);
+    natives.add("System", "print@13b", eval_system_print_unsigned_hex);
+    natives.add("System", "print@13y", eval_system_print_unsigned_hex);
+    natives.add("System", "assert@11b", eval_system_assert);
+    natives.add("SystemU3", "print@s", eval_system_print_string);
+    natives.add("SystemU5", "print@264i", eval_system_print_int);
+    natives.add("SystemU5", "print@264u", eval_system_print_unsigned);
+    natives.add("SystemU5", "print@s", eval_system_print_string);
+
+    natives.add("EventWindow", "aref@232i", eval_event_window_aref);
+    natives.add("EventWindow@232i", "aref@232i", eval_event_window_aref);
+    natives.add("Math", "max@*", eval_math_max);
+    natives.add("Bar", "aref@232i", eval_bar_aref);
 }
 
 // System
 
-ExprRes EvalNative::eval_system_print_int(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    auto arg = args.pop_front();
+ExprRes EvalNative::eval_system_print_int(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    auto arg = call.args().pop_front();
     auto rval = arg.move_value().move_rvalue();
     ulam_assert(rval.is<ulam::Integer>());
     out() << rval.get<ulam::Integer>() << "\n";
-    return void_res();
+    return void_res(call);
 }
 
-ExprRes EvalNative::eval_system_print_unsigned(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    auto arg = args.pop_front();
+ExprRes EvalNative::eval_system_print_unsigned(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    auto arg = call.args().pop_front();
     auto rval = arg.move_value().move_rvalue();
     ulam_assert(rval.is<ulam::Unsigned>());
     out() << rval.get<ulam::Unsigned>() << "\n";
-    return void_res();
+    return void_res(call);
 }
 
-ExprRes EvalNative::eval_system_print_unsigned_hex(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    auto arg = args.pop_front();
+ExprRes EvalNative::eval_system_print_unsigned_hex(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    auto arg = call.args().pop_front();
     auto rval = arg.move_value().move_rvalue();
     ulam_assert(rval.is<ulam::Unsigned>());
     out() << std::hex << rval.get<ulam::Unsigned>() << "\n";
-    return void_res();
+    return void_res(call);
 }
 
-ExprRes EvalNative::eval_system_assert(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    if (!env().is_true(args.pop_front()))
+ExprRes EvalNative::eval_system_assert(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    if (!env(call).is_true(call.args().pop_front()))
         throw ulam::sema::EvalExceptAssert("assert failed");
-    return void_res();
+    return void_res(call);
 }
 
-ExprRes EvalNative::eval_system_print_string(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    auto arg = args.pop_front();
+ExprRes EvalNative::eval_system_print_string(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    auto arg = call.args().pop_front();
     auto val = arg.move_value();
-    auto str_type = builtins().string_type();
+    auto str_type = env(call).builtins().string_type();
     out() << str_type->text(val) << "\n";
-    return void_res();
+    return void_res(call);
 }
 
 // EventWindow
 
-ExprRes EvalNative::eval_event_window_aref(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    auto idx_arg = args.pop_front();
+ExprRes EvalNative::eval_event_window_aref(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    auto idx_arg = call.args().pop_front();
 
-    auto& ctx = test_ctx();
+    auto& ctx = env(call).test_ctx();
     const auto idx = array_idx(idx_arg.move_value().move_rvalue());
     auto lval = (idx == 0) ? ctx.active_atom() : ctx.neighbor(idx);
     lval.set_is_xvalue(false);
-    return {builtins().atom_type(), ulam::Value{lval}};
+    return {env(call).builtins().atom_type(), ulam::Value{lval}};
 }
 
 // Math
-ExprRes EvalNative::eval_math_max(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
+ExprRes EvalNative::eval_math_max(NativeCall& call) {
     const auto Min = ulam::utils::integer_min(ulam::IntType::DefaultSize);
     const auto Max = ulam::utils::integer_max(ulam::IntType::DefaultSize);
 
     auto max = Min;
     bool is_consteval = true;
-    while (!args.empty()) {
-        auto arg = args.pop_front();
-        arg = env().cast(node, ulam::IntId, std::move(arg));
+    while (!call.args().empty()) {
+        auto arg = call.args().pop_front();
+        arg = env(call).cast(call.node(), ulam::IntId, std::move(arg));
         if (!arg)
             return arg;
 
@@ -157,7 +116,7 @@ ExprRes EvalNative::eval_math_max(
         is_consteval = is_consteval && rval.is_consteval();
     }
 
-    auto ret_type = builtins().int_type();
+    auto ret_type = env(call).builtins().int_type();
     auto ret_rval = ret_type->construct(max);
     ret_rval.set_is_consteval(is_consteval);
     return {ret_type, ulam::Value{std::move(ret_rval)}};
@@ -165,13 +124,14 @@ ExprRes EvalNative::eval_math_max(
 
 // Bar
 
-ExprRes EvalNative::eval_bar_aref(
-    NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args) {
-    ulam_assert(args.size() == 1);
-    auto idx_arg = args.pop_front();
+ExprRes EvalNative::eval_bar_aref(NativeCall& call) {
+    ulam_assert(call.args().size() == 1);
+    auto idx_arg = call.args().pop_front();
     ulam_assert(idx_arg);
-    auto type = builtins().atom_type()->ref_type();
-    return {type, ulam::Value{_bar_atom.atom_of()}};
+    auto type = env(call).builtins().atom_type()->ref_type();
+    // NOTE: no good way to distinguish Bar quark instances, use empty atom
+    auto atom = env(call).builtins().atom_type()->construct_default();
+    return {type, ulam::Value{atom.atom_of()}};
 }
 
 // utils
@@ -197,8 +157,12 @@ ulam::array_idx_t EvalNative::array_idx(const ulam::RValue& idx_rval) {
     return static_cast<ulam::array_idx_t>(idx_int);
 }
 
+EvalEnv& EvalNative::env(NativeCall& call) {
+    return static_cast<EvalEnv&>(call.env());
+}
+
 std::ostream& EvalNative::out() { return std::cout << ">> "; }
 
-ExprRes EvalNative::void_res() {
-    return {builtins().void_type(), ulam::Value{ulam::RValue{}}};
+ExprRes EvalNative::void_res(NativeCall& call) {
+    return {env(call).builtins().void_type(), ulam::Value{ulam::RValue{}}};
 }
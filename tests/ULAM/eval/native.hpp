@@ -1,36 +1,20 @@
 #pragma once
-#include "./helper.hpp"
-#include <functional>
-#include <libulam/sema/eval/env.hpp>
-#include <libulam/sema/eval/helper.hpp>
+#include "./env.hpp"
+#include <libulam/sema/eval/native.hpp>
 #include <libulam/sema/expr_res.hpp>
 #include <libulam/semantic/value.hpp>
-#include <map>
 #include <ostream>
 #include <string_view>
-#include <utility>
 
-class EvalNative : public EvalHelper, public ulam::sema::EvalHelper {
+class EvalNative {
 public:
-    using Base = ulam::sema::EvalHelper;
     using ExprRes = ulam::sema::ExprRes;
-    using ExprResList = ulam::sema::ExprResList;
-    using FunRef = ulam::Ref<ulam::Fun>;
-    using NodeRef = ulam::Ref<ulam::ast::Node>;
+    using NativeCall = ulam::sema::NativeCall;
 
-    explicit EvalNative(EvalEnv& env);
-
-    ExprRes
-    call(NodeRef node, FunRef fun, ulam::LValue self, ExprResList&& args);
+    static void add(ulam::sema::NativeRegistry& natives);
 
 private:
-    using NamePair = std::pair<const std::string_view, const std::string_view>;
-    using FunImpl =
-        std::function<ExprRes(NodeRef, FunRef, ulam::LValue, ExprResList&&)>;
-    using Map = std::map<NamePair, FunImpl>;
-
-#define _METHOD_DECL(name)                                                  \
-    ExprRes name(NodeRef, FunRef, ulam::LValue, ExprResList&&)
+#define _METHOD_DECL(name) static ExprRes name(NativeCall& call)
 
     // System, SystemU3, SystemU5
     _METHOD_DECL(eval_system_print_int);
@@ -52,17 +36,15 @@ private:
 
     // utils
 
-    ulam::LValue obj_prop(ulam::LValue obj, const std::string_view prop_name);
-    ulam::LValue array_item(ulam::LValue array, ulam::RValue&& idx_rval);
+    static EvalEnv& env(NativeCall& call);
 
-    ulam::array_idx_t array_idx(const ulam::RValue& idx_rval);
+    static ulam::LValue
+    obj_prop(ulam::LValue obj, const std::string_view prop_name);
+    static ulam::LValue array_item(ulam::LValue array, ulam::RValue&& idx_rval);
 
-    std::ostream& out();
+    static ulam::array_idx_t array_idx(const ulam::RValue& idx_rval);
 
-    ExprRes void_res();
+    static std::ostream& out();
 
-    // NOTE: single shared Empty atom, there's no good way to distinguish Bar
-    // quark instances
-    ulam::RValue _bar_atom;
-    Map _map;
+    static ExprRes void_res(NativeCall& call);
 };
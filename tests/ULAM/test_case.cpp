@@ -58,33 +58,27 @@ void print_statuses(const std::vector<int>& statuses) {
 
 } // namespace
 
-TestCase::TestCase(const Path& stdlib_dir, const Path& path, flags_t flags):
-    _stdlib_dir{stdlib_dir}, _flags{flags} {
+TestCase::TestCase(const Path& path, flags_t flags): _flags{flags} {
     load(path);
     parse();
 }
 
-bool TestCase::run() {
+bool TestCase::run(Compiler& compiler, unsigned parse_jobs) {
     ulam_assert(_srcs.size() > 0);
     std::stringstream out;
-    Compiler compiler;
 
     // add .inc srcs
     for (auto [path, text] : _inc_srcs)
         compiler.add_str_src(std::string{text}, path);
 
     // parse .ulam srcs
-    bool has_empty = false;
-    for (auto [path, text] : _srcs) {
-        has_empty = has_empty || path.filename() == "Empty.ulam";
-        compiler.parse_module_str(std::string{text}, path);
+    if (parse_jobs > 1) {
+        compiler.parse_module_strs(_srcs, parse_jobs);
+    } else {
+        for (auto [path, text] : _srcs)
+            compiler.parse_module_str(std::string{text}, path);
     }
 
-    // stdlib
-    compiler.parse_module_file(_stdlib_dir / "UrSelf.ulam");
-    if (!has_empty)
-        compiler.parse_module_file(_stdlib_dir / "Empty.ulam");
-
     // analyze
     auto program = compiler.analyze();
     if (!program)
@@ -197,6 +191,7 @@ void TestCase::add_src(Path path, const std::string_view text) {
     if (!path.has_parent_path() && ext != ".inc")
         path = "." / path;
     if (ext == ".ulam") {
+        _has_empty = _has_empty || path.filename() == "Empty.ulam";
         _srcs.emplace_back(std::move(path), text);
     } else if (ext == ".inc") {
         _inc_srcs.emplace_back(std::move(path), text);
@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <vector>
 
+class Compiler;
+
 class TestCase {
 public:
     using Path = std::filesystem::path;
@@ -13,9 +15,14 @@ public:
     static constexpr flags_t SkipAnswerCheck = 1;
     static constexpr flags_t SkipExitStatusCheck = 2;
 
-    TestCase(const Path& stdlib_dir, const Path& path, flags_t flags = NoFlags);
+    TestCase(const Path& path, flags_t flags = NoFlags);
+
+    // test defines its own Empty element
+    bool has_empty() const { return _has_empty; }
 
-    bool run();
+    // compiler is expected to have stdlib modules analyzed,
+    // test modules are parsed using `parse_jobs' threads
+    bool run(Compiler& compiler, unsigned parse_jobs = 1);
 
 private:
     void load(const Path& path);
@@ -23,7 +30,6 @@ private:
 
     void add_src(Path path, const std::string_view text);
 
-    Path _stdlib_dir;
     std::string _text;
     std::string_view _answers_text;
     AnswerMap _answers;
@@ -31,5 +37,6 @@ private:
     // {filename, text}
     std::vector<std::pair<Path, std::string_view>> _srcs;
     std::vector<std::pair<Path, std::string_view>> _inc_srcs;
+    bool _has_empty{false};
     flags_t _flags;
 };
@@ -18,6 +18,10 @@ PrinterBase::~PrinterBase() { ulam_assert(_lvl == 0); }
 
 void PrinterBase::print() { visit(_ast); }
 
+void PrinterBase::print(ulam::Ref<ulam::ast::ModuleDef> module) {
+    visit(module);
+}
+
 void PrinterBase::visit(ulam::Ref<ulam::ast::ModuleDef> node) {
     if (do_visit(node)) {
         inc_lvl();
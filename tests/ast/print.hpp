@@ -20,6 +20,7 @@ public:
     virtual ~PrinterBase();
 
     void print();
+    void print(ulam::Ref<ulam::ast::ModuleDef> module);
 
     struct {
         unsigned ident = 2;
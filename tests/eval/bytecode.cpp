@@ -0,0 +1,256 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/sema/eval/except.hpp>
+#include <libulam/semantic/fun/code.hpp>
+#include <libulam/semantic/value.hpp>
+#include <vector>
+
+static const char* Program = R"END(
+quark Calc {
+  constant Int cBase = 10;
+  Int m = 2;
+
+  Int sq(Int x) {
+    return x * x;
+  }
+
+  Int sumSq(Int n) {
+    Int s = 0;
+    for (Int i = 0; i < n; ++i) {
+      if (i % 3 == 0)
+        continue;
+      if (i > 20)
+        break;
+      s += sq(i);
+    }
+    return s;
+  }
+
+  Int collatz(Int n) {
+    Int steps = 0;
+    while (n != 1) {
+      if (n % 2 == 0)
+        n = n / 2;
+      else
+        n = 3 * n + 1;
+      steps++;
+    }
+    return steps;
+  }
+
+  Int fib(Int n) {
+    if (n < 2)
+      return n;
+    return fib(n - 1) + fib(n - 2);
+  }
+
+  Unsigned bits(Unsigned x) {
+    Unsigned(8) small = (Unsigned(8)) x;
+    Unsigned r = small;
+    r += (Unsigned) cBase;
+    r *= 3;
+    return r;
+  }
+
+  Int bitsInt(Unsigned x) {
+    return (Int) bits(x);
+  }
+
+  Bool logic(Int a, Int b) {
+    Bool r = a > 0 && b > 0 || a == b;
+    return !r || a < b;
+  }
+
+  Int logicInt(Int a, Int b) {
+    if (logic(a, b))
+      return 1;
+    return 0;
+  }
+
+  Int mixed(Int x) {
+    return x * m + (x > 0 ? 1 : -1);
+  }
+
+  Int calls(Int x) {
+    Int r = mixed(x);
+    r += Int(4).maxof;
+    nothing(x);
+    return r + -x;
+  }
+
+  Void nothing(Int x) {
+    Int y = x;
+    if (y > 0)
+      return;
+    y = 1;
+  }
+
+  Int forever() {
+    Int i = 0;
+    while (true) {
+      ++i;
+    }
+    return i;
+  }
+
+  Int(3) narrow(Int x) {
+    return x;
+  }
+
+  Int(3) narrowAfterCall(Int x) {
+    nothing(x);
+    return x;
+  }
+}
+
+quark Base {
+  Int inc(Int x) {
+    return x + 1;
+  }
+}
+
+quark Mid : Base {}
+
+quark Derived : Mid {}
+)END";
+
+static const char* Cases[] = {
+    "Calc c; c.sumSq(30);",    "Calc c; c.collatz(27);",
+    "Calc c; c.fib(12);",      "Calc c; c.bitsInt(300);",
+    "Calc c; c.logicInt(1, 2);", "Calc c; c.logicInt(2, 1);",
+    "Calc c; c.logicInt(-1, -1);", "Calc c; c.calls(5);",
+    "Calc c; c.calls(-5);",
+};
+
+// same function called with different effective classes
+static const char* EffClsCases[] = {
+    "Derived d; d.inc(1);",
+    "Derived d; d.Mid.inc(2);",
+    "Derived d; d.Base.inc(3);",
+};
+
+// invalid casts before and after a call
+static const char* ErrorCases[] = {
+    "Calc c; c.narrow(5);",
+    "Calc c; c.narrowAfterCall(5);",
+};
+
+struct ErrorRes {
+    ulam::sema::ExprError error;
+    unsigned err_num; // diagnostics emitted
+};
+
+static bool run(bool bytecode, std::vector<ulam::Integer>& results) {
+    ulam::Context ctx;
+    ctx.options.eval_options.bytecode = bytecode;
+    auto ast = analyze(ctx, Program, "Calc");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    for (auto text : Cases) {
+        auto res = eval.eval(text);
+        if (!res) {
+            std::cerr << "failed to evaluate `" << text << "`\n";
+            return false;
+        }
+        results.push_back(res.value().rvalue().get<ulam::Integer>());
+    }
+
+    // loop limit is enforced
+    try {
+        eval.eval("Calc c; c.forever();");
+        std::cerr << "loop limit not enforced\n";
+        return false;
+    } catch (const ulam::sema::EvalExceptError&) {}
+    return true;
+}
+
+static void run_errors(bool bytecode, std::vector<ErrorRes>& results) {
+    ulam::Context ctx;
+    ctx.options.eval_options.bytecode = bytecode;
+    auto ast = analyze(ctx, Program, "Calc");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    for (auto text : ErrorCases) {
+        auto err_num = ctx.diag().err_num();
+        auto error = ulam::sema::ExprError::Error;
+        try {
+            error = eval.eval(text).error();
+        } catch (const ulam::sema::EvalExceptError&) {}
+        results.push_back({error, ctx.diag().err_num() - err_num});
+    }
+}
+
+// code compiled for each effective class is run without fallback
+static bool check_eff_cls() {
+    ulam::Context ctx;
+    ctx.options.eval_options.bytecode = true;
+    auto ast = analyze(ctx, Program, "Calc");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    ulam::Integer expected = 2;
+    for (auto text : EffClsCases) {
+        const auto& stats = ulam::FunCode::stats();
+        auto runs = stats.runs.load();
+        auto deopts = stats.deopts.load();
+        auto res = eval.eval(text);
+        if (!res || res.value().rvalue().get<ulam::Integer>() != expected) {
+            std::cerr << "`" << text << "`: invalid result\n";
+            return false;
+        }
+        if (stats.runs.load() != runs + 1 || stats.deopts.load() != deopts) {
+            std::cerr << "`" << text << "`: not run by VM\n";
+            return false;
+        }
+        ++expected;
+    }
+    return true;
+}
+
+int main() {
+    std::vector<ulam::Integer> expected;
+    if (!run(false, expected))
+        return -1;
+
+    auto runs = ulam::FunCode::stats().runs.load();
+    std::vector<ulam::Integer> results;
+    if (!run(true, results))
+        return -1;
+    if (ulam::FunCode::stats().runs.load() == runs) {
+        std::cerr << "no functions compiled\n";
+        return -1;
+    }
+
+    for (unsigned n = 0; n < expected.size(); ++n) {
+        if (results[n] != expected[n]) {
+            std::cerr << "`" << Cases[n] << "`: " << results[n]
+                      << " != " << expected[n] << "\n";
+            return -1;
+        }
+    }
+
+    if (!check_eff_cls())
+        return -1;
+
+    // errors and diagnostics are the same as without VM
+    std::vector<ErrorRes> expected_errors;
+    run_errors(false, expected_errors);
+    std::vector<ErrorRes> errors;
+    run_errors(true, errors);
+    for (unsigned n = 0; n < expected_errors.size(); ++n) {
+        const auto& expected = expected_errors[n];
+        if (expected.error == ulam::sema::ExprError::Ok ||
+            expected.err_num == 0) {
+            std::cerr << "`" << ErrorCases[n] << "`: no error\n";
+            return -1;
+        }
+        if (errors[n].error != expected.error ||
+            errors[n].err_num != expected.err_num) {
+            std::cerr << "`" << ErrorCases[n] << "`: error "
+                      << (int)errors[n].error << " != "
+                      << (int)expected.error << ", " << errors[n].err_num
+                      << " != " << expected.err_num << " diagnostics\n";
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/fun/call_cache.hpp>
+#include <libulam/semantic/value.hpp>
+
+static const char* Program = R"END(
+quark Base {
+  virtual Int f(Int(8) x) { return 1; }
+  virtual Int f(Int(4) x) { return 2; }
+}
+
+quark Derived : Base {
+  virtual Int f(Int(8) x) { return 3; }
+  virtual Int f(Int(4) x) { return 4; }
+}
+
+// `b.f(x)` call site is shared by instances, argument type depends on `n`
+quark Call(Unsigned n) {
+  typedef Int(n) T;
+
+  Int call(Base& b) {
+    T x = 1;
+    return b.f(x);
+  }
+}
+)END";
+
+struct Case {
+    const char* text;
+    ulam::Integer expected;
+    bool is_hit; // in `Call.call`
+};
+
+static const Case Cases[] = {
+    {"Call(8) c; Base b; c.call(b);", 1, false},
+    {"Call(8) c; Base b; c.call(b);", 1, true},
+    // cached, override is dispatched
+    {"Call(8) c; Derived d; c.call(d);", 3, true},
+    // different argument type, not cached
+    {"Call(4) c; Derived d; c.call(d);", 4, false},
+    {"Call(4) c; Base b; c.call(b);", 2, true},
+    {"Call(8) c; Derived d; c.call(d);", 3, true},
+};
+
+int main() {
+    ulam::Context ctx;
+    auto ast = analyze(ctx, Program, "Call");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    const auto& stats = ulam::FunCallCache::stats();
+    for (const auto& case_ : Cases) {
+        auto hits = stats.hits.load();
+        auto res = eval.eval(case_.text);
+        if (!res) {
+            std::cerr << "failed to evaluate `" << case_.text << "`\n";
+            return -1;
+        }
+        auto value = res.value().rvalue().get<ulam::Integer>();
+        if (value != case_.expected) {
+            std::cerr << "`" << case_.text << "`: " << value
+                      << " != " << case_.expected << "\n";
+            return -1;
+        }
+        // top-level call site is new for each evaluation
+        if ((stats.hits.load() - hits == 1) != case_.is_hit) {
+            std::cerr << "`" << case_.text << "`: "
+                      << (case_.is_hit ? "miss" : "hit") << "\n";
+            return -1;
+        }
+    }
+}
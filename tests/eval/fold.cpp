@@ -0,0 +1,86 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/value.hpp>
+#include <libulam/semantic/value/fold_cache.hpp>
+#include <vector>
+
+static const char* Program = R"END(
+quark Q(Int n) {
+  constant Int c = n * 2;
+
+  Int get(Int x) {
+    return x + c + (n > 2 ? 1 : 0) + Int(4).maxof;
+  }
+}
+
+element A {
+  constant Unsigned c = 3;
+  Int x = 1;
+
+  Int loop(Int k) {
+    Int sum = 0;
+    for (Int i = 0; i < k; ++i) {
+      sum += 2 * 3 + (Int) (c << 1) - x;
+      sum += (Int) Unsigned(8).maxof;
+      sum += -(1 + 2);
+    }
+    return sum;
+  }
+
+  Int inst() {
+    Q(1) q1;
+    Q(3) q3;
+    return q1.get(0) * 100 + q3.get(0);
+  }
+}
+)END";
+
+// evaluated twice, second run uses cached values
+static const char* Cases[] = {
+    "A a; a.loop(3);", "A a; a.loop(0);", "A a; a.inst();",
+    "Q(2) q; q.get(5);", "Q(5) q; q.get(-5);",
+};
+
+static bool run(bool fold_consts, std::vector<ulam::Integer>& results) {
+    ulam::Context ctx;
+    ctx.options.eval_options.fold_consts = fold_consts;
+    auto ast = analyze(ctx, Program, "A");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    for (unsigned i = 0; i < 2; ++i) {
+        for (auto text : Cases) {
+            auto res = eval.eval(text);
+            if (!res) {
+                std::cerr << "failed to evaluate `" << text << "`\n";
+                return false;
+            }
+            results.push_back(res.value().rvalue().get<ulam::Integer>());
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::vector<ulam::Integer> expected;
+    if (!run(false, expected))
+        return -1;
+
+    auto hits = ulam::FoldCache::stats().hits.load();
+    std::vector<ulam::Integer> results;
+    if (!run(true, results))
+        return -1;
+    if (ulam::FoldCache::stats().hits.load() == hits) {
+        std::cerr << "folded values are not used\n";
+        return -1;
+    }
+
+    const unsigned CaseNum = sizeof(Cases) / sizeof(Cases[0]);
+    for (unsigned n = 0; n < expected.size(); ++n) {
+        if (results[n] != expected[n]) {
+            std::cerr << "`" << Cases[n % CaseNum] << "`: " << results[n]
+                      << " != " << expected[n] << "\n";
+            return -1;
+        }
+    }
+}
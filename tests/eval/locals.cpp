@@ -0,0 +1,92 @@
+#include "tests/sema/common.hpp"
+
+static const char* Program = R"END(
+quark B {
+  Int b = 5;
+
+  Int get() {
+    return b;
+  }
+}
+
+quark T(Unsigned n) {
+  Unsigned types() {
+    Unsigned sum = 0;
+    for (Int i = 0; i < 3; ++i) {
+      typedef Unsigned(n) U;
+      U u = U.maxof;
+      U v[2] = {u, 1};
+      sum += v[0] + v[1];
+    }
+    return sum;
+  }
+}
+
+element A : B {
+  Int x = 3;
+
+  Int shadow(Int x) {
+    Int r = x;
+    {
+      Int x = 10;
+      r = r + x;
+    }
+    return r + x + self.x;
+  }
+
+  Int loop(Int n) {
+    Int sum = 0;
+    for (Int i = 0; i < n; ++i) {
+      Int t = i * 2;
+      if (t == 4)
+        continue;
+      sum += t;
+      if (i == 6)
+        break;
+    }
+    return sum;
+  }
+
+  Int reset(Int n) {
+    Int sum = 0;
+    Int i = 0;
+    while (i < n) {
+      Int t;
+      t += i;
+      sum += t;
+      ++i;
+    }
+    if (n > 0)
+      sum += reset(n - 1);
+    return sum;
+  }
+
+  Int cond() {
+    constant Int c = 4;
+    Int(c) r = 0;
+    Atom a = self;
+    if (a as B)
+      r = (Int(c)) a.get();
+    return r;
+  }
+
+  Int types() {
+    T(2) t2;
+    T(4) t4;
+    return (Int) t2.types() * 100 + (Int) t4.types();
+  }
+}
+
+)END";
+
+int main() {
+    analyze_print_and_run(Program, "A", R"END(
+A a;
+a.shadow(2);
+a.loop(10);
+a.reset(4);
+a.cond();
+a.types();
+a.types();
+)END");
+}
@@ -0,0 +1,89 @@
+#include "tests/sema/common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/sema/eval/env.hpp>
+#include <libulam/sema/eval/native.hpp>
+#include <libulam/semantic/type/builtin/int.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/semantic/value.hpp>
+#include <utility>
+
+static const char* Program = R"END(
+quark Math {
+  Int max(...) native;
+}
+
+element Counter {
+  Int mCount = 1;
+  Int add(Int x) native;
+  Int addTwice(Int x) { add(x); return add(x); }
+}
+)END";
+
+static const std::pair<const char*, ulam::Integer> Cases[] = {
+    {"Math m; m.max(3, 7, 5);", 7},
+    {"Math m; m.max(-2);", -2},
+    {"Counter c; c.add(2);", 3},
+    {"Counter c; c.addTwice(2);", 5},
+    {"Counter c; c.add(2); c.mCount;", 3},
+};
+
+using ulam::sema::ExprRes;
+using ulam::sema::NativeCall;
+
+static ulam::Integer int_arg(NativeCall& call) {
+    auto arg = call.args().pop_front();
+    arg = call.env().cast(call.node(), ulam::IntId, std::move(arg));
+    return arg.move_value().move_rvalue().get<ulam::Integer>();
+}
+
+static ExprRes int_res(NativeCall& call, ulam::Integer value) {
+    auto type = call.env().builtins().int_type();
+    return {type, ulam::Value{type->construct(value)}};
+}
+
+static ExprRes math_max(NativeCall& call) {
+    ++*static_cast<unsigned*>(call.data());
+    auto max = int_arg(call);
+    while (!call.args().empty())
+        max = std::max(max, int_arg(call));
+    return int_res(call, max);
+}
+
+static ExprRes counter_add(NativeCall& call) {
+    auto sym = call.fun()->cls()->get("mCount");
+    auto count = call.self().prop(sym->get<ulam::Prop>());
+    auto value = count.rvalue().get<ulam::Integer>() + int_arg(call);
+    count.assign(call.env().builtins().int_type()->construct(value));
+    return int_res(call, value);
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = analyze(ctx, Program, "Math");
+    auto& natives = ast->program()->natives();
+    unsigned max_calls = 0;
+    natives.add("Math", "max@*", math_max, &max_calls);
+    natives.add("Counter", "add@232i", counter_add);
+
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+    for (const auto& [text, expected] : Cases) {
+        auto res = eval.eval(text);
+        if (!res) {
+            std::cerr << "failed to evaluate `" << text << "`\n";
+            return -1;
+        }
+        auto value = res.value().rvalue().get<ulam::Integer>();
+        if (value != expected) {
+            std::cerr << "`" << text << "`: " << value << " != " << expected
+                      << "\n";
+            return -1;
+        }
+    }
+    if (max_calls != 2) {
+        std::cerr << "invalid number of native calls: " << max_calls << "\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/sema/eval/except.hpp>
+#include <libulam/semantic/value.hpp>
+#include <libulam/str_pool.hpp>
+#include <string>
+
+static const char* Program = R"END(
+quark Q {
+  String mS;
+}
+)END";
+
+// String data are 18 bits wide
+static constexpr unsigned StrNum = 1u << 18;
+
+static bool
+check_len(ulam::sema::Eval& eval, const char* text, ulam::Unsigned expected) {
+    auto res = eval.eval(text);
+    if (!res) {
+        std::cerr << "failed to evaluate `" << text << "`\n";
+        return false;
+    }
+    auto len = res.value().rvalue().get<ulam::Unsigned>();
+    if (len != expected) {
+        std::cerr << "`" << text << "`: " << len << " != " << expected << "\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = analyze(ctx, Program, "Q");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    if (!check_len(eval, "Q q; q.mS = \"abc\"; q.mS.lengthof;", 3))
+        return -1;
+
+#if ULAM_STR_ID_32
+    auto& text_pool = ast->ctx().text_pool();
+    for (unsigned n = 0; n < StrNum; ++n)
+        text_pool.put("str" + std::to_string(n));
+
+    // ID of new string does not fit into data member
+    try {
+        eval.eval("Q q; q.mS = \"overflow\";");
+        std::cerr << "string ID overflow is not reported\n";
+        return -1;
+    } catch (const ulam::sema::EvalExceptError&) {}
+
+    // strings added earlier and local variables are not affected
+    if (!check_len(eval, "Q q; q.mS = \"abc\"; q.mS.lengthof;", 3))
+        return -1;
+    if (!check_len(eval, "String s = \"local\"; s.lengthof;", 5))
+        return -1;
+#endif
+}
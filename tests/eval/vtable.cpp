@@ -0,0 +1,83 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/value.hpp>
+#include <utility>
+
+static const char* Program = R"END(
+quark Base {
+  virtual Int f() { return 1; }
+  virtual Int g(Int x) { return x; }
+  Int callF() { return f(); }
+  Int callG(Int x) { return g(x); }
+}
+
+quark Mix {
+  virtual Int h() { return 100; }
+  Int callH() { return h(); }
+}
+
+quark L1 : Base {
+  @Override Int f() { return 2; }
+}
+
+quark L2 : L1 + Mix {
+  @Override Int g(Int x) { return x * 2; }
+  @Override Int h() { return 200; }
+}
+
+quark L3 : L2 {
+  @Override Int f() { return 3; }
+}
+
+element E1 : L1 {}
+element E2 : L2 {}
+element E3 : L3 {}
+element E4 : L3 {
+  @Override Int g(Int x) { return x * 4; }
+  @Override Int h() { return 400; }
+}
+element E5 : Base {}
+element E6 : Mix {}
+)END";
+
+// same call sites see more dynamic classes than call cache can hold
+static const std::pair<const char*, ulam::Integer> Cases[] = {
+    {"E1 e; e.callF();", 2},
+    {"E2 e; e.callF();", 2},
+    {"E3 e; e.callF();", 3},
+    {"E4 e; e.callF();", 3},
+    {"E5 e; e.callF();", 1},
+    {"E2 e; e.callG(5);", 10},
+    {"E4 e; e.callG(5);", 20},
+    {"E5 e; e.callG(5);", 5},
+    {"E2 e; e.callH();", 200},
+    {"E3 e; e.callH();", 200},
+    {"E4 e; e.callH();", 400},
+    {"E6 e; e.callH();", 100},
+    {"E3 e; Base& b = e; b.f();", 3},
+    {"E4 e; Mix& m = e; m.h();", 400},
+    {"E4 e; L1& l = e; l.g(3);", 12},
+};
+
+int main() {
+    ulam::Context ctx;
+    auto ast = analyze(ctx, Program, "Base");
+    ulam::sema::Eval eval{ctx, ulam::ref(ast)};
+
+    for (unsigned i = 0; i < 2; ++i) {
+        for (const auto& [text, expected] : Cases) {
+            auto res = eval.eval(text);
+            if (!res) {
+                std::cerr << "failed to evaluate `" << text << "`\n";
+                return -1;
+            }
+            auto value = res.value().rvalue().get<ulam::Integer>();
+            if (value != expected) {
+                std::cerr << "`" << text << "`: " << value
+                          << " != " << expected << "\n";
+                return -1;
+            }
+        }
+    }
+}
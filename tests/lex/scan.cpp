@@ -0,0 +1,115 @@
+#include <cctype>
+#include <iostream>
+#include <libulam/context.hpp>
+#include <libulam/lex.hpp>
+#include <libulam/preproc.hpp>
+#include <libulam/src.hpp>
+#include <libulam/src_man.hpp>
+#include <libulam/token.hpp>
+#include <string>
+
+// word of given length, runs cross SIMD block boundaries
+static std::string word(unsigned size) {
+    const std::string chars{"aZ_09yQ"};
+    std::string str{"x"};
+    for (unsigned n = 1; n < size; ++n)
+        str += chars[n % chars.size()];
+    return str;
+}
+
+static bool check_keyword(const char* str, ulam::tok::Type type) {
+    if (!str || !(str[0] == '@' || str[0] == '_' || std::isalpha(str[0])))
+        return true; // not a keyword
+    if (ulam::tok::type_by_keyword(str) != type) {
+        std::cerr << "keyword `" << str << "' not found\n";
+        return false;
+    }
+    return true;
+}
+
+static bool check_keywords() {
+#define TOK(str, type)                                                         \
+    if (!check_keyword(str, ulam::tok::type))                                  \
+        return false;
+#include <libulam/token.inc.hpp>
+#undef TOK
+
+    const std::pair<const char*, ulam::tok::Type> NotKeywords[] = {
+        {"i", ulam::tok::Ident},
+        {"ifs", ulam::tok::Ident},
+        {"whil", ulam::tok::Ident},
+        {"Ints", ulam::tok::TypeIdent},
+        {"STRING", ulam::tok::TypeIdent},
+        {"__FUNC", ulam::tok::Ident},
+        {"@Overrides", ulam::tok::InvalidAtKeyword},
+        {"@override", ulam::tok::InvalidAtKeyword},
+        {"__CLASS_SIGNATURE__x", ulam::tok::Ident},
+    };
+    for (auto [str, type] : NotKeywords) {
+        if (ulam::tok::type_by_keyword(str) != type) {
+            std::cerr << "unexpected type for `" << str << "'\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool check_scan() {
+    const unsigned MaxSize = 80;
+
+    std::string text;
+    for (unsigned n = 1; n <= MaxSize; ++n) {
+        for (unsigned i = 0; i < n % 40; ++i)
+            text += (i % 3 == 0) ? '\t' : ' ';
+        text += word(n);
+        text += (n % 2 == 0) ? " // " : "// ";
+        text += std::string(n, 'c') + "\\\n";
+        text += std::string(n, '/') + "\n";
+        text += "/*" + std::string(n, 'm') + "\n" + std::string(n, '*') + "*/";
+        text += (n % 2 == 0) ? "\n" : ";\n";
+    }
+
+    ulam::Context ctx;
+    ulam::Preproc pp{ctx};
+    auto src = ctx.src_man().string(text, "Scan");
+    ulam::Lex lex{pp, ctx.src_man(), src->id(), src->content()};
+    ulam::Token token;
+
+    auto expect = [&](ulam::tok::Type type, ulam::linum_t linum) -> bool {
+        lex.lex(token);
+        auto loc = ctx.src_man().loc(token.loc_id);
+        if (token.type != type || loc.linum() != linum) {
+            std::cerr << "line " << linum << ": unexpected token "
+                      << token.type_name() << " at line " << loc.linum()
+                      << "\n";
+            return false;
+        }
+        return true;
+    };
+
+    ulam::linum_t linum = 1;
+    for (unsigned n = 1; n <= MaxSize; ++n) {
+        if (!expect(ulam::tok::Ident, linum))
+            return false;
+        auto str = ctx.src_man().str_at(token.loc_id, token.size);
+        if (str != word(n)) {
+            std::cerr << "unexpected identifier `" << str << "'\n";
+            return false;
+        }
+        if (!expect(ulam::tok::Comment, linum))
+            return false;
+        linum += 2;
+        if (!expect(ulam::tok::Comment, linum))
+            return false;
+        ++linum;
+        if (n % 2 == 1 && !expect(ulam::tok::Semicol, linum))
+            return false;
+        ++linum;
+    }
+    return expect(ulam::tok::Eof, linum);
+}
+
+int main() {
+    if (!check_keywords() || !check_scan())
+        return -1;
+}
@@ -0,0 +1,63 @@
+#include "libulam/memory/arena.hpp"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static bool is_aligned(const void* ptr) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t) ==
+           0;
+}
+
+int main() {
+    const std::size_t PageSize = 256;
+    ulam::mem::Arena arena{PageSize};
+
+    // small and large allocations, spanning multiple pages
+    std::vector<std::pair<char*, std::size_t>> allocs;
+    for (std::size_t n = 0; n < 64; ++n) {
+        std::size_t size = (n % 8 == 7) ? PageSize * 2 : n % 40 + 1;
+        auto data = static_cast<char*>(arena.alloc(size));
+        if (!is_aligned(data)) {
+            std::cerr << "allocation is not aligned\n";
+            return -1;
+        }
+        std::memset(data, (char)n, size);
+        allocs.emplace_back(data, size);
+    }
+    for (std::size_t n = 0; n < allocs.size(); ++n) {
+        auto [data, size] = allocs[n];
+        for (std::size_t i = 0; i < size; ++i) {
+            if (data[i] != (char)n) {
+                std::cerr << "allocation " << n << " is overwritten\n";
+                return -1;
+            }
+        }
+    }
+
+    // allocator uses current arena
+    std::size_t size = arena.size();
+    {
+        ulam::mem::Arena::Scope scope{&arena};
+        std::vector<std::string, ulam::mem::ArenaAllocator<std::string>> strs;
+        for (unsigned n = 0; n < 100; ++n)
+            strs.push_back("string " + std::to_string(n));
+        if (strs[99] != "string 99" || arena.size() <= size) {
+            std::cerr << "vector is not allocated in arena\n";
+            return -1;
+        }
+
+        // nested scope without arena
+        ulam::mem::Arena::Scope heap_scope{{}};
+        if (ulam::mem::Arena::current()) {
+            std::cerr << "unexpected current arena\n";
+            return -1;
+        }
+    }
+    if (ulam::mem::Arena::current()) {
+        std::cerr << "current arena is not reset\n";
+        return -1;
+    }
+    return 0;
+}
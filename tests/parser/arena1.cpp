@@ -0,0 +1,55 @@
+#include "tests/ast/print.hpp"
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <sstream>
+#include <string>
+
+static const char* Program = R"END(
+quark Foo(Unsigned cBits) {
+  typedef Unsigned(cBits) Count;
+  Count mCount = 0;
+  Int mValues[4] = { 1, 2, 3, 4 };
+
+  Bool bar(Int x, Int y) {
+    for (Int i = 0; i < 4; ++i)
+      mValues[i] = x * (Int) mCount + y;
+    return mCount == Count.maxof;
+  }
+}
+
+element Baz : Foo(3) {
+  Void behave() {
+    if (bar(1, 2))
+      mCount = 0;
+  }
+}
+)END";
+
+// parses and prints program
+static std::string parse(bool use_arena) {
+    ulam::Context ctx;
+    auto ast = ulam::make<ulam::ast::Root>(use_arena);
+    ulam::Parser parser{ctx, ast->ctx()};
+    ast->add_module(parser.parse_module_str(Program, "Foo"));
+
+    std::stringstream ss;
+    test::ast::Printer p{ss, ulam::ref(ast)};
+    p.print();
+
+    auto arena = ast->ctx().arena();
+    if (use_arena && (!arena || arena->size() == 0))
+        return {};
+    return ss.str();
+}
+
+int main() {
+    auto str = parse(false);
+    auto arena_str = parse(true);
+    std::cout << arena_str << "\n";
+    if (str.empty() || arena_str != str) {
+        std::cerr << "output does not match\n";
+        return -1;
+    }
+}
@@ -0,0 +1,216 @@
+#include "tests/ast/print.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/ast/serial.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <libulam/parser/cache.hpp>
+#include <libulam/src.hpp>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static const char* Program = R"END(
+ulam 5;
+load "Base.ulam";
+
+/**
+   Generated quark.
+ */
+quark Foo(Unsigned cBits) : Base + Other {
+  typedef Unsigned(cBits) Count;
+  constant Count cMax = Count.maxof;
+  Count mCount = 0;
+  Int mValues[4] = { 1, 2, 3, 4 };
+  Bool(3) mFlag;
+
+  Self(Int x) { mCount = (Count) x; }
+
+  Int operator+(Int x) { return x + (Int) mCount; }
+
+  virtual Bool bar(Int x, Int& y) {
+    for (Int i = 0; i < 4; ++i)
+      mValues[i] = x * (Int) mCount + y;
+    while (y > 0) {
+      if (y == 3)
+        break;
+      --y;
+      continue;
+    }
+    which (x) {
+      case 1:
+      case 2: { y = 1; }
+      otherwise: { y = 0; }
+    }
+    return mCount == cMax ? true : false;
+  }
+
+  Int baz() native;
+}
+
+element Baz : Foo(3) {
+  String mName = "baz\n";
+  Foo mFoo = { .mCount = 1, .mFlag = false };
+
+  @Override Bool bar(Int x, Int& y) {
+    Atom a = self.atomof;
+    if (a as Baz)
+      a.mName = "as";
+    Int& r = y;
+    r = super.bar(x, r) ? 'a' : 0x10;
+    return self.Foo.bar(x, y) && Foo.cMax > mFoo.sizeof;
+  }
+
+  Void behave() {
+    Int y;
+    if (bar(1, y))
+      mCount = 0;
+    else
+      mFoo.mCount += 1u;
+  }
+}
+)END";
+
+static const char* BaseProgram = R"END(
+quark Base {
+  Int mBase = -1;
+}
+
+quark Other {}
+)END";
+
+static void write_file(const std::filesystem::path& path, const char* text) {
+    std::ofstream file{path};
+    file << text;
+}
+
+// collects node locations in pre-order
+static void locs(
+    ulam::SrcMan& src_man,
+    ulam::Ref<const ulam::ast::Node> node,
+    std::string& out) {
+    if (!node) {
+        out += "-\n";
+        return;
+    }
+    if (node->loc_id() != ulam::NoLocId) {
+        auto loc = src_man.loc(node->loc_id());
+        out += src_man.src(loc.src_id())->path().filename().string() + ":" +
+               std::to_string(loc.linum()) + ":" + std::to_string(loc.chr());
+    }
+    out += "\n";
+    for (unsigned n = 0; n < node->child_num(); ++n)
+        locs(src_man, node->child(n), out);
+}
+
+struct Parsed {
+    std::string text;
+    std::string locs;
+    std::string data;
+};
+
+// parses, prints and serializes program
+static Parsed parse(
+    const std::filesystem::path& path,
+    const std::filesystem::path& cache_dir = {}) {
+    ulam::Context ctx;
+    ctx.options.parser_options.cache_dir = cache_dir;
+    auto ast = ulam::make<ulam::ast::Root>();
+    ulam::Parser parser{ctx, ast->ctx()};
+    auto module = parser.parse_module_file(path);
+    if (!module || ctx.diag().err_num() > 0)
+        return {};
+
+    Parsed parsed;
+    locs(ctx.src_man(), ulam::ref(module), parsed.locs);
+    parsed.data = ulam::ast::write_module(
+        ctx.src_man(), ast->ctx().str_pool(), ast->ctx().text_pool(),
+        ulam::ref(module));
+    ast->add_module(std::move(module));
+
+    std::stringstream ss;
+    test::ast::Printer p{ss, ulam::ref(ast)};
+    p.print();
+    parsed.text = ss.str();
+    return parsed;
+}
+
+// deserializes and prints program
+static Parsed read(const std::string& data) {
+    ulam::Context ctx;
+    auto ast = ulam::make<ulam::ast::Root>(true /* use arena */);
+    auto module = ulam::ast::read_module(
+        ctx.src_man(), ast->ctx().str_pool(), ast->ctx().text_pool(), data);
+    if (!module)
+        return {};
+
+    Parsed parsed;
+    locs(ctx.src_man(), ulam::ref(module), parsed.locs);
+    ast->add_module(std::move(module));
+
+    std::stringstream ss;
+    test::ast::Printer p{ss, ulam::ref(ast)};
+    p.print();
+    parsed.text = ss.str();
+    return parsed;
+}
+
+static bool check(bool ok, const char* text) {
+    if (!ok)
+        std::cerr << text << "\n";
+    return ok;
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("ulam_test_parser_cache1_" + std::to_string(getpid()));
+    const auto cache_dir = dir / "cache";
+    std::filesystem::create_directories(dir);
+    write_file(dir / "Foo.ulam", Program);
+    write_file(dir / "Base.ulam", BaseProgram);
+
+    const auto& stats = ulam::ParseCache::stats();
+    bool ok = true;
+
+    // round trip
+    auto parsed = parse(dir / "Foo.ulam");
+    ok = check(!parsed.text.empty(), "failed to parse") && ok;
+    ok = check(!parsed.data.empty(), "failed to serialize") && ok;
+    auto loaded = read(parsed.data);
+    std::cout << loaded.text << "\n";
+    ok = check(loaded.text == parsed.text, "output does not match") && ok;
+    ok = check(loaded.locs == parsed.locs, "locations do not match") && ok;
+
+    // truncated data
+    for (std::size_t size = 0; size < parsed.data.size(); size += 7)
+        ok = check(
+                 read(parsed.data.substr(0, size)).text.empty(),
+                 "truncated data accepted") &&
+             ok;
+
+    // cache miss, store, hit
+    auto cached = parse(dir / "Foo.ulam", cache_dir);
+    ok = check(stats.misses == 1 && stats.stores == 1, "not stored") && ok;
+    cached = parse(dir / "Foo.ulam", cache_dir);
+    ok = check(stats.hits == 1, "not loaded from cache") && ok;
+    ok = check(cached.text == parsed.text, "cached output does not match") &&
+         ok;
+    ok = check(cached.locs == parsed.locs, "cached locations do not match") &&
+         ok;
+
+    // loaded source changed
+    write_file(dir / "Base.ulam", "quark Base {}\nquark Other {}\n");
+    cached = parse(dir / "Foo.ulam", cache_dir);
+    ok = check(stats.hits == 1 && stats.misses == 2, "stale entry loaded") &&
+         ok;
+    ok = check(
+             cached.text.find("mBase") == std::string::npos,
+             "stale output") &&
+         ok;
+
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : -1;
+}
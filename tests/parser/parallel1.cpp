@@ -0,0 +1,93 @@
+#include "tests/ast/print.hpp"
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser/parallel.hpp>
+#include <sstream>
+#include <string>
+
+static constexpr unsigned ModuleNum = 16;
+static constexpr unsigned BadModule = 5; // has syntax error
+
+static const char* Common = R"END(
+quark Common {
+  constant Int cCommon = 7;
+}
+)END";
+
+static std::string module_text(unsigned n) {
+    const auto name = "Q" + std::to_string(n);
+    std::string text = "load \"Common.inc\";\n";
+    text += "quark " + name + " {\n";
+    for (unsigned i = 0; i <= n; ++i) {
+        const auto idx = std::to_string(i);
+        text += "  Int fun" + idx + "_" + name + "(Int x) {\n";
+        text += "    String s = \"" + name + "_" + idx + "\";\n";
+        if (n == BadModule && i == 1)
+            text += "    x = x +;\n";
+        text += "    return x * " + idx + " + Common.cCommon;\n";
+        text += "  }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+struct Parsed {
+    std::string text;
+    std::string strs; // all strings in ID order
+    unsigned err_num;
+};
+
+static Parsed parse(unsigned jobs) {
+    ulam::Context ctx;
+    auto ast = ulam::make<ulam::ast::Root>(true /* use arena */);
+    ulam::ParallelParser parser{ctx, ast->ctx()};
+    parser.add_str_src(Common, "Common.inc");
+    for (unsigned n = 0; n < ModuleNum; ++n)
+        parser.add_module_str(
+            module_text(n), "Q" + std::to_string(n) + ".ulam");
+
+    Parsed parsed;
+    auto modules = parser.parse(jobs);
+    for (unsigned n = 0; n < ModuleNum; ++n) {
+        // NOTE: module with errors cannot be printed
+        if (modules[n] && n != BadModule)
+            ast->add_module(std::move(modules[n]));
+    }
+    parsed.err_num = ctx.diag().err_num();
+
+    std::stringstream ss;
+    test::ast::Printer p{ss, ulam::ref(ast)};
+    p.print();
+    parsed.text = ss.str();
+
+    auto& str_pool = ast->ctx().str_pool();
+    for (ulam::str_id_t id = 0; str_pool.has_id(id); ++id)
+        parsed.strs += std::string{str_pool.get(id)} + " ";
+    return parsed;
+}
+
+int main() {
+    auto serial = parse(1);
+    if (serial.err_num == 0) {
+        std::cerr << "error not reported\n";
+        return -1;
+    }
+    auto parallel = parse(4);
+    std::cout << parallel.text << "\n";
+    if (parallel.text != serial.text) {
+        std::cerr << "output does not match\n";
+        return -1;
+    }
+    if (parallel.err_num != serial.err_num) {
+        std::cerr << "error number does not match\n";
+        return -1;
+    }
+    // string IDs do not depend on scheduling
+    for (unsigned i = 0; i < 4; ++i) {
+        if (parse(3 + i).strs != parallel.strs) {
+            std::cerr << "string IDs do not match\n";
+            return -1;
+        }
+    }
+}
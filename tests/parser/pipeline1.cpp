@@ -0,0 +1,92 @@
+#include "tests/ast/print.hpp"
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <sstream>
+#include <string>
+
+static constexpr unsigned FunNum = 64; // enough tokens to wrap the ring
+
+static const char* Common = R"END(
+quark Common {
+  constant Int cCommon = 7;
+  String mFile = __FILE__;
+}
+)END";
+
+static std::string module_text() {
+    std::string text = "ulam 5;\nload \"Common.inc\";\n";
+    text += "quark Data {\n  Int mA;\n  Bool mB;\n}\n";
+    text += "quark Gen {\n";
+    for (unsigned i = 0; i < FunNum; ++i) {
+        const auto idx = std::to_string(i);
+        text += "  Int fun" + idx + "(Int x) {\n";
+        text += "    Data d = { .mA = " + idx + ", .mB = true };\n";
+        text += "    Int a[2] = { x, " + idx + " };\n";
+        text += "    String f = __FILE__;\n";
+        text += "    return x * Common.cCommon + d.mA + a[1];\n";
+        text += "  }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+struct Parsed {
+    std::string text;
+    unsigned version;
+    unsigned err_num;
+};
+
+// input ends inside class head
+static const char* Truncated = "element";
+
+static Parsed parse(const std::string& text, bool preproc_thread) {
+    ulam::Context ctx;
+    ctx.options.parser_options.preproc_thread = preproc_thread;
+    auto ast = ulam::make<ulam::ast::Root>();
+    ulam::Parser parser{ctx, ast->ctx()};
+    parser.add_str_src(Common, "Common.inc");
+    auto module = parser.parse_module_str(text, "Gen.ulam");
+
+    Parsed parsed;
+    parsed.version = module ? module->ulam_version() : 0;
+    parsed.err_num = ctx.diag().err_num();
+    if (module && parsed.err_num == 0)
+        ast->add_module(std::move(module));
+
+    std::stringstream ss;
+    test::ast::Printer p{ss, ulam::ref(ast)};
+    p.print();
+    parsed.text = ss.str();
+    return parsed;
+}
+
+int main() {
+    const auto text = module_text();
+    auto serial = parse(text, false);
+    auto pipelined = parse(text, true);
+    std::cout << pipelined.text << "\n";
+    if (serial.err_num > 0 || pipelined.err_num > 0) {
+        std::cerr << "errors reported\n";
+        return -1;
+    }
+    if (pipelined.version != 5 || pipelined.version != serial.version) {
+        std::cerr << "invalid version\n";
+        return -1;
+    }
+    if (pipelined.text != serial.text) {
+        std::cerr << "output does not match\n";
+        return -1;
+    }
+
+    // parser keeps reading `Eof' after end of input
+    auto serial_trunc = parse(Truncated, false);
+    auto pipelined_trunc = parse(Truncated, true);
+    if (serial_trunc.err_num == 0 ||
+        pipelined_trunc.err_num != serial_trunc.err_num) {
+        std::cerr << "truncated input: invalid error number\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <libulam/sema.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <string>
+
+static constexpr unsigned Depth = 70; // ancestor sets span multiple words
+
+// Q0 <- Q1 (+ M1) <- ... <- Q<Depth - 1> (+ M<Depth - 1>)
+static std::string module_text() {
+    std::string text = "quark Q0 { Bool mQ0; }\n";
+    for (unsigned n = 1; n < Depth; ++n) {
+        const auto idx = std::to_string(n);
+        text += "quark M" + idx + " {";
+        if (n % 10 == 0)
+            text += " Bool mM" + idx + ";";
+        text += " }\n";
+        text += "quark Q" + idx + " : Q" + std::to_string(n - 1) + " + M" +
+                idx + " {}\n";
+    }
+    text += "element E : Q" + std::to_string(Depth - 1) + " { Bool mE; }\n";
+    text += "element F : M10 + Q3 {}\n";
+    return text;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = ulam::make<ulam::ast::Root>();
+    ulam::Parser parser{ctx, ast->ctx().str_pool(), ast->ctx().text_pool()};
+    ast->add_module(parser.parse_module_str(module_text(), "E"));
+
+    auto program = ulam::sema::init(ctx, ulam::ref(ast));
+    if (!ulam::sema::resolve(ctx, program) || ctx.diag().err_num() > 0) {
+        std::cerr << "failed to analyze\n";
+        return -1;
+    }
+
+    // subtype checks and offsets match ancestor lists
+    auto classes = program->module("E")->classes();
+    unsigned base_num = 0;
+    for (auto cls : classes) {
+        for (auto base : classes) {
+            ulam::Ref<ulam::cls::Ancestor> found{};
+            for (auto anc : cls->ancestors()) {
+                if (anc->cls() == base)
+                    found = anc;
+            }
+            if (base->is_base_of(cls) != (bool)found) {
+                std::cerr << "invalid subtype check: " << base->name()
+                          << ", " << cls->name() << "\n";
+                return -1;
+            }
+            if (!found)
+                continue;
+            ++base_num;
+            auto off = cls->direct_bitsize() + found->data_off();
+            if (cls->base_off(base) != off) {
+                std::cerr << "invalid offset of " << base->name() << " in "
+                          << cls->name() << "\n";
+                return -1;
+            }
+        }
+    }
+    if (base_num == 0) {
+        std::cerr << "no bases found\n";
+        return -1;
+    }
+    return 0;
+}
@@ -41,6 +41,13 @@ analyze(const std::string& text, const std::string& module_name) {
     return do_analyze(ctx, text, module_name);
 }
 
+ulam::Ptr<ulam::ast::Root> analyze(
+    ulam::Context& ctx,
+    const std::string& text,
+    const std::string& module_name) {
+    return do_analyze(ctx, text, module_name);
+}
+
 ulam::Ptr<ulam::ast::Root>
 analyze_and_print(const std::string& text, const std::string& module_name) {
     ulam::Context ctx;
@@ -1,9 +1,16 @@
 #include <libulam/ast.hpp>
+#include <libulam/context.hpp>
 #include <string>
 
 ulam::Ptr<ulam::ast::Root>
 analyze(const std::string& text, const std::string& module_name);
 
+// uses context options
+ulam::Ptr<ulam::ast::Root> analyze(
+    ulam::Context& ctx,
+    const std::string& text,
+    const std::string& module_name);
+
 ulam::Ptr<ulam::ast::Root>
 analyze_and_print(const std::string& text, const std::string& module_name);
 
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <libulam/sema.hpp>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class_tpl.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+static const char* ModuleA = R"END(
+quark T(Unsigned a, Int b) {
+  Unsigned(4) mT;
+  Int get() { return (Int) a * 10 + b; }
+}
+
+quark B {
+  Int f(Int x) { return 1; }
+  Int f(Unsigned x) { return 2; }
+  Int f(T(1u, 2) t) { return t.get(); }
+  Int f(T(1u, 3) t) { return t.get(); }
+  Int f(Int x, Int y) { return 5; }
+}
+
+quark A : B {
+  typedef T(1u, 2) T1;
+  typedef T(1u, 2) T1Same;
+  typedef T(1u, 3) T2;
+  typedef T(2u, 2) T3;
+  @Override Int f(Unsigned x) { return 20; }
+}
+)END";
+
+static bool eval(
+    ulam::Context& ctx,
+    ulam::Ref<ulam::ast::Root> ast,
+    const std::string& text,
+    ulam::Integer expected) {
+    ulam::sema::Eval eval{ctx, ast};
+    auto res = eval.eval(text);
+    if (!res) {
+        std::cerr << "failed to evaluate `" << text << "`\n";
+        return false;
+    }
+    auto value = res.value().rvalue().get<ulam::Integer>();
+    if (value != expected) {
+        std::cerr << "`" << text << "`: " << value << " != " << expected
+                  << "\n";
+        return false;
+    }
+    return true;
+}
+
+static bool check(bool ok, const char* text) {
+    if (!ok)
+        std::cerr << text << "\n";
+    return ok;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = ulam::make<ulam::ast::Root>();
+    ulam::Parser parser{ctx, ast->ctx().str_pool(), ast->ctx().text_pool()};
+    ast->add_module(parser.parse_module_str(ModuleA, "A"));
+
+    auto program = ulam::sema::init(ctx, ulam::ref(ast));
+    ulam::sema::resolve(ctx, program);
+
+    bool ok = check(ctx.diag().err_num() == 0, "errors reported");
+
+    // same arguments, same instance
+    ulam::Ref<ulam::ClassTpl> tpl{};
+    auto sym = program->module("A")->get("T");
+    if (sym && sym->is<ulam::ClassTpl>())
+        tpl = sym->get<ulam::ClassTpl>();
+    ok = check(tpl && tpl->classes().size() == 3, "invalid instance number") &&
+         ok;
+
+    // overloads merged by parameter types
+    ok = eval(ctx, ulam::ref(ast), "A a; a.f(1);", 1) && ok;
+    ok = eval(ctx, ulam::ref(ast), "A a; a.f(1u);", 20) && ok;
+    ok = eval(ctx, ulam::ref(ast), "A a; T(1u, 2) t; a.f(t);", 12) && ok;
+    ok = eval(ctx, ulam::ref(ast), "A a; T(1u, 3) t; a.f(t);", 13) && ok;
+    ok = eval(ctx, ulam::ref(ast), "A a; a.f(1, 2);", 5) && ok;
+    ok = eval(ctx, ulam::ref(ast), "A.T3 t; t.get();", 22) && ok;
+    ok = check(tpl && tpl->classes().size() == 3, "instance re-created") &&
+         ok;
+
+    return ok ? 0 : -1;
+}
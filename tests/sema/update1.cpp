@@ -0,0 +1,180 @@
+#include <iostream>
+#include <libulam/ast.hpp>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/context.hpp>
+#include <libulam/parser.hpp>
+#include <libulam/sema.hpp>
+#include <libulam/sema/eval.hpp>
+#include <libulam/semantic/fun.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/semantic/value.hpp>
+#include <string>
+
+static const char* ModuleA = R"END(
+quark A {
+  Unsigned(3) mA;
+  Int value() { return 1; }
+}
+)END";
+
+static const char* ModuleAChanged = R"END(
+quark A {
+  Unsigned(5) mA;
+  Int value() { return 2; }
+}
+)END";
+
+static const char* ModuleB = R"END(
+quark B {
+  A mA;
+  Bool mB;
+  Int get() { return mA.value(); }
+}
+)END";
+
+static const char* ModuleC = R"END(
+quark C {
+  Int(4) mC;
+  Int get() { return 3; }
+}
+)END";
+
+// not affected, local type cache is keyed by effective class (D)
+static const char* ModuleBase = R"END(
+quark Base {
+  Unsigned(2) mBase;
+  Int size() {
+    typedef Self S;
+    return S.sizeof;
+  }
+}
+)END";
+
+static const char* ModuleD = R"END(
+quark D : Base {
+  A mA;
+}
+)END";
+
+static ulam::Ref<ulam::Class>
+get_class(ulam::Ref<ulam::Program> program, const std::string& name) {
+    auto module = program->module(name);
+    if (!module)
+        return {};
+    auto sym = module->get(name);
+    return (sym && sym->is<ulam::Class>()) ? sym->get<ulam::Class>()
+                                           : ulam::Ref<ulam::Class>{};
+}
+
+// type cache of `typedef` in Base.size
+static ulam::Ref<ulam::LocalTypeCache>
+size_type_cache(ulam::Ref<ulam::ast::Root> ast, ulam::Ref<ulam::Class> base) {
+    auto name_id = ast->ctx().str_pool().id("size");
+    auto fun = *base->fun(name_id)->begin();
+    auto type_def = dynamic_cast<ulam::Ref<ulam::ast::TypeDef>>(
+        fun->body_node()->get(0));
+    if (!type_def)
+        return {};
+    return type_def->type_cache();
+}
+
+static bool eval(
+    ulam::Context& ctx,
+    ulam::Ref<ulam::ast::Root> ast,
+    const std::string& text,
+    ulam::Integer expected) {
+    ulam::sema::Eval eval{ctx, ast};
+    auto res = eval.eval(text);
+    if (!res) {
+        std::cerr << "failed to evaluate `" << text << "`\n";
+        return false;
+    }
+    auto value = res.value().rvalue().get<ulam::Integer>();
+    if (value != expected) {
+        std::cerr << "`" << text << "`: " << value << " != " << expected
+                  << "\n";
+        return false;
+    }
+    return true;
+}
+
+static bool check(bool ok, const char* text) {
+    if (!ok)
+        std::cerr << text << "\n";
+    return ok;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = ulam::make<ulam::ast::Root>();
+    ulam::Parser parser{ctx, ast->ctx().str_pool(), ast->ctx().text_pool()};
+    ast->add_module(parser.parse_module_str(ModuleA, "A"));
+    ast->add_module(parser.parse_module_str(ModuleB, "B"));
+    ast->add_module(parser.parse_module_str(ModuleC, "C"));
+    ast->add_module(parser.parse_module_str(ModuleBase, "Base"));
+    ast->add_module(parser.parse_module_str(ModuleD, "D"));
+
+    auto program = ulam::sema::init(ctx, ulam::ref(ast));
+    ulam::sema::resolve(ctx, program);
+
+    bool ok = true;
+    ok = eval(ctx, ulam::ref(ast), "B b; b.get();", 1) && ok;
+    ok = eval(ctx, ulam::ref(ast), "C c; c.get();", 3) && ok;
+    ok = eval(ctx, ulam::ref(ast), "D d; d.Self.size();", 2) && ok;
+
+    auto base_cls = get_class(program, "Base");
+    ok = check(
+             size_type_cache(ulam::ref(ast), base_cls) &&
+                 !size_type_cache(ulam::ref(ast), base_cls)->empty(),
+             "local type is not cached") &&
+         ok;
+
+    auto b_module = program->module("B");
+    auto a_name_id = ast->ctx().str_pool().id("A");
+    ok = check(
+             b_module->deps().count(a_name_id) == 1,
+             "dependency of B on A not recorded") &&
+         ok;
+    ok = check(get_class(program, "B")->bitsize() == 4, "invalid B size") &&
+         ok;
+    ok = check(get_class(program, "D")->bitsize() == 5, "invalid D size") &&
+         ok;
+    auto c_cls = get_class(program, "C");
+    auto class_num = program->classes().list().size();
+
+    // replace A, B and D are re-initialized, C and Base are not affected
+    // (new source path, string sources are registered by path)
+    auto a_module = ulam::sema::update(
+        ctx, ulam::ref(ast),
+        parser.parse_module_str(ModuleAChanged, "changed/A"));
+    ulam::sema::resolve(ctx, program);
+
+    ok = check(a_module && program->module("A") == a_module, "A not added") &&
+         ok;
+    ok = check(program->modules().size() == 5, "invalid module number") && ok;
+    ok = check(ast->child_num() == 5, "invalid AST module number") && ok;
+    ok = check(get_class(program, "C") == c_cls, "C is re-created") && ok;
+    ok = check(
+             program->classes().list().size() == class_num,
+             "class IDs are not reused") &&
+         ok;
+    ok = check(
+             get_class(program, "Base") == base_cls, "Base is re-created") &&
+         ok;
+    ok = check(
+             !size_type_cache(ulam::ref(ast), base_cls),
+             "local type cache of Base is not cleared") &&
+         ok;
+    ok = check(get_class(program, "B")->bitsize() == 6, "B is not updated") &&
+         ok;
+    ok = check(get_class(program, "D")->bitsize() == 7, "D is not updated") &&
+         ok;
+    ok = check(ctx.diag().err_num() == 0, "errors reported") && ok;
+
+    ok = eval(ctx, ulam::ref(ast), "B b; b.get();", 2) && ok;
+    ok = eval(ctx, ulam::ref(ast), "C c; c.get();", 3) && ok;
+    ok = eval(ctx, ulam::ref(ast), "D d; d.Self.size();", 2) && ok;
+
+    return ok ? 0 : -1;
+}
@@ -54,5 +54,20 @@ int main() {
         }
         std::cerr << "\n";
     }
+
+    {
+        // copy-on-write
+        ulam::Bits bits1{1337};
+        bits1.flip();
+        auto bits2 = bits1.share();
+        auto bits3 = bits1.share();
+        bits2.write_bit(0, false);
+        bits1.view(1000, 337) &= ulam::Bits{10}.view();
+        if (!bits3.read_bit(0) || !bits3.read_bit(1336) || bits2.read_bit(0) ||
+            !bits2.read_bit(1336) || bits1.read_bit(1336)) {
+            std::cerr << "shared storage modified\n";
+            return -1;
+        }
+    }
     return 0;
 }
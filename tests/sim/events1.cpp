@@ -0,0 +1,110 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/semantic/type/class/prop.hpp>
+#include <libulam/sim.hpp>
+
+static const char* Program = R"END(
+quark EventWindow {
+  Atom& aref(Int index) native;
+}
+
+element Empty {}
+
+element Seed {
+  Void behave() {
+    EventWindow ew;
+    Atom a = ew.aref(0);
+    ew.aref(1) = a;
+  }
+}
+
+element Counter {
+  Unsigned(8) mCount;
+  Void behave() { ++mCount; }
+}
+)END";
+
+static ulam::Ref<ulam::Class>
+get_class(ulam::Ref<ulam::Program> program, const char* name) {
+    auto sym = program->module("EventWindow")->get(name);
+    return (sym && sym->is<ulam::Class>()) ? sym->get<ulam::Class>()
+                                           : ulam::Ref<ulam::Class>{};
+}
+
+// sum of Counter.mCount over grid
+static std::size_t
+count_sum(ulam::sim::Grid& grid, ulam::Ref<ulam::Class> counter) {
+    auto sym = counter->get("mCount");
+    auto off = sym->get<ulam::Prop>()->data_off_in(counter);
+    std::size_t sum = 0;
+    for (unsigned y = 0; y < grid.height(); ++y) {
+        for (unsigned x = 0; x < grid.width(); ++x)
+            sum += grid.site(x, y).read(off, 8);
+    }
+    return sum;
+}
+
+static ulam::sim::Grid
+make_counters(unsigned size, ulam::Ref<ulam::Class> counter) {
+    ulam::sim::Grid grid{size, size};
+    for (unsigned y = 0; y < size; ++y) {
+        for (unsigned x = 0; x < size; ++x)
+            grid.set(x, y, counter);
+    }
+    return grid;
+}
+
+static bool check(bool ok, const char* text) {
+    if (!ok)
+        std::cerr << text << "\n";
+    return ok;
+}
+
+int main() {
+    ulam::Context ctx;
+    auto ast = analyze(ctx, Program, "EventWindow");
+    auto program = ast->program();
+    auto seed = get_class(program, "Seed");
+    auto counter = get_class(program, "Counter");
+    if (!seed || !counter) {
+        std::cerr << "classes not found\n";
+        return -1;
+    }
+    bool ok = true;
+
+    // single thread, seed copies itself through event window
+    std::size_t seed_num = 0;
+    for (unsigned i = 0; i < 2; ++i) {
+        ulam::sim::Grid grid{16, 16};
+        grid.set(8, 8, seed);
+        ulam::sim::SimOptions options;
+        options.tile_size = 16;
+        ulam::sim::Sim sim{program, grid, options};
+        auto stats = sim.run(20000);
+        ok = check(stats.events == 20000, "invalid event number") && ok;
+        ok = check(stats.failed == 0, "failed events") && ok;
+        auto num = grid.count(seed->element_id());
+        ok = check(num > 1, "seed did not spread") && ok;
+        ok = check(i == 0 || num == seed_num, "not deterministic") && ok;
+        seed_num = num;
+    }
+
+    // every event on counter increments it, no updates lost in workers
+    {
+        auto grid = make_counters(32, counter);
+        ulam::sim::SimOptions options;
+        options.threads = 4;
+        options.tile_size = 8;
+        ulam::sim::Sim sim{program, grid, options};
+        auto stats = sim.run(10000);
+        ok = check(stats.events == 10000, "invalid event number") && ok;
+        ok = check(stats.failed == 0, "failed events") && ok;
+        ok = check(count_sum(grid, counter) == 10000, "lost updates") && ok;
+        stats = sim.run(10000);
+        ok = check(count_sum(grid, counter) == 20000, "lost updates") && ok;
+    }
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,145 @@
+#include "tests/sema/common.hpp"
+#include <iostream>
+#include <libulam/ast/nodes/access.hpp>
+#include <libulam/ast/nodes/module.hpp>
+#include <libulam/semantic/program.hpp>
+#include <libulam/semantic/type/class.hpp>
+#include <libulam/semantic/type/class/prop.hpp>
+#include <libulam/sim.hpp>
+
+// behave() is inherited from a quark and declares locals in branches and
+// loop body: caches of its body are keyed by each element class
+static const char* Program = R"END(
+quark EventWindow {
+  Atom& aref(Int index) native;
+}
+
+element Empty {}
+
+quark Counting {
+  Unsigned(8) mCount;
+  Unsigned(8) step(Unsigned(8) x) { return x; }
+  Unsigned(8) step(Int x) { return 0; }
+  Void behave() {
+    typedef Unsigned(8) Count;
+    EventWindow ew;
+    Count inc = 0;
+    for (Int i = 0; i < 3; ++i) {
+      if (i == 1) {
+        Atom a = ew.aref(0);
+        if (a as Empty)
+          return;
+        continue;
+      }
+      Count one = 1;
+      inc += step(one);
+    }
+    mCount = (Count) (mCount + inc / 2u);
+  }
+}
+
+element CounterA : Counting {}
+
+element CounterB : Counting {
+  Bool mFlag;
+}
+)END";
+
+static ulam::Ref<ulam::Class>
+get_class(ulam::Ref<ulam::Program> program, const char* name) {
+    auto sym = program->module("EventWindow")->get(name);
+    return (sym && sym->is<ulam::Class>()) ? sym->get<ulam::Class>()
+                                           : ulam::Ref<ulam::Class>{};
+}
+
+// sum of Counting.mCount over sites of counter
+static std::size_t
+count_sum(ulam::sim::Grid& grid, ulam::Ref<ulam::Class> counter) {
+    auto sym = counter->get("mCount");
+    auto off = sym->get<ulam::Prop>()->data_off_in(counter);
+    std::size_t sum = 0;
+    for (unsigned y = 0; y < grid.height(); ++y) {
+        for (unsigned x = 0; x < grid.width(); ++x) {
+            if (grid.element_id(x, y) == counter->element_id())
+                sum += grid.site(x, y).read(off, 8);
+        }
+    }
+    return sum;
+}
+
+// drops call site and local type caches, e.g. filled by Sim::prepare, so
+// that workers reach call site keys prepare didn't see (cf. sema::update)
+static void clear_caches(ulam::Ref<ulam::ast::Node> node) {
+    if (auto funcall = dynamic_cast<ulam::Ref<ulam::ast::FunCall>>(node))
+        funcall->set_call_cache({});
+    if (auto var_def = dynamic_cast<ulam::Ref<ulam::ast::VarDef>>(node))
+        var_def->set_type_cache({});
+    for (unsigned n = 0; n < node->child_num(); ++n) {
+        auto child = node->child(n);
+        if (child)
+            clear_caches(child);
+    }
+}
+
+// number of call site and local type caches
+static std::size_t cache_num(ulam::Ref<ulam::ast::Node> node) {
+    std::size_t num = 0;
+    if (auto funcall = dynamic_cast<ulam::Ref<ulam::ast::FunCall>>(node))
+        num += funcall->call_cache() ? 1 : 0;
+    if (auto var_def = dynamic_cast<ulam::Ref<ulam::ast::VarDef>>(node))
+        num += var_def->type_cache() ? 1 : 0;
+    for (unsigned n = 0; n < node->child_num(); ++n) {
+        auto child = node->child(n);
+        if (child)
+            num += cache_num(child);
+    }
+    return num;
+}
+
+static bool check(bool ok, const char* text) {
+    if (!ok)
+        std::cerr << text << "\n";
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    for (bool bytecode : {false, true}) {
+        ulam::Context ctx;
+        ctx.options.eval_options.bytecode = bytecode;
+        auto ast = analyze(ctx, Program, "EventWindow");
+        auto program = ast->program();
+        auto counter_a = get_class(program, "CounterA");
+        auto counter_b = get_class(program, "CounterB");
+        if (!counter_a || !counter_b) {
+            std::cerr << "classes not found\n";
+            return -1;
+        }
+
+        ulam::sim::Grid grid{32, 32};
+        for (unsigned y = 0; y < grid.height(); ++y) {
+            for (unsigned x = 0; x < grid.width(); ++x)
+                grid.set(x, y, ((x + y) % 2 == 0) ? counter_a : counter_b);
+        }
+
+        ulam::sim::SimOptions options;
+        options.threads = 4;
+        options.tile_size = 8;
+        ulam::sim::Sim sim{program, grid, options};
+        for (std::size_t total = 10000; total <= 20000; total += 10000) {
+            auto stats = sim.run(10000);
+            ok = check(stats.events == 10000, "invalid event number") && ok;
+            ok = check(stats.failed == 0, "failed events") && ok;
+            auto sum = count_sum(grid, counter_a) + count_sum(grid, counter_b);
+            ok = check(sum == total, "lost updates") && ok;
+            if (total == 20000) {
+                // workers evaluate misses without adding caches
+                ok = check(cache_num(ulam::ref(ast)) == 0, "cache added") && ok;
+            } else {
+                // prepared only once, next run starts with empty caches
+                clear_caches(ulam::ref(ast));
+            }
+        }
+    }
+    return ok ? 0 : -1;
+}
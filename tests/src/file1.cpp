@@ -0,0 +1,46 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <libulam/context.hpp>
+#include <libulam/src.hpp>
+#include <libulam/src_man.hpp>
+#include <string>
+#include <unistd.h>
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("ulam_test_src_file1_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+
+    // sizes around page boundary, page-sized files are not mapped
+    const std::size_t page_size = sysconf(_SC_PAGESIZE);
+    const std::size_t Sizes[] = {
+        0, 1, page_size - 1, page_size, page_size + 1, 3 * page_size};
+
+    int ret = 0;
+    ulam::Context ctx;
+    for (auto size : Sizes) {
+        std::string text;
+        for (std::size_t n = 0; n < size; ++n)
+            text += (n % 64 == 63) ? '\n' : (char)('a' + n % 26);
+        const auto path = dir / (std::to_string(size) + ".ulam");
+        {
+            std::ofstream file{path};
+            file << text;
+        }
+
+        auto src = ctx.src_man().file(path);
+        auto buf = src->content();
+        if (buf.size() != size + 1 || buf.end()[-1] != '\0' ||
+            std::string{buf.start(), size} != text) {
+            std::cerr << "invalid content of " << size << " byte file\n";
+            ret = -1;
+        }
+        if (size > 0 && src->line(1).size() != std::min<std::size_t>(size, 64)) {
+            std::cerr << "invalid first line of " << size << " byte file\n";
+            ret = -1;
+        }
+    }
+    std::filesystem::remove_all(dir);
+    return ret;
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <libulam/context.hpp>
+#include <libulam/lex.hpp>
+#include <libulam/preproc.hpp>
+#include <libulam/src.hpp>
+#include <libulam/src_man.hpp>
+#include <libulam/token.hpp>
+#include <string>
+#include <vector>
+
+static const char* Texts[] = {
+    "quark A {\n  Int a = 1;\n}\n",
+    "\n\n\telement B {\r\n  /* multi\n line */ Bool b;\n  String s = \"str\\\n\";\n}",
+    "", // empty
+    "Int\tc; // comment\nInt d;\n\n",
+};
+
+struct Expected {
+    ulam::linum_t linum;
+    ulam::chr_t chr;
+    std::string line;
+};
+
+// computes location of character at offset
+static Expected expected(const std::string& text, std::size_t off) {
+    Expected exp{1, 1, {}};
+    std::size_t line_start = 0;
+    for (std::size_t n = 0; n < off; ++n) {
+        if (text[n] == '\n') {
+            ++exp.linum;
+            line_start = n + 1;
+        }
+    }
+    exp.chr = off - line_start + 1;
+    auto line_end = text.find('\n', line_start);
+    exp.line = text.substr(
+        line_start, (line_end == std::string::npos)
+                        ? std::string::npos
+                        : line_end + 1 - line_start);
+    return exp;
+}
+
+int main() {
+    ulam::Context ctx;
+    ulam::Preproc pp{ctx};
+    auto& src_man = ctx.src_man();
+
+    std::vector<ulam::Src*> srcs;
+    for (auto text : Texts)
+        srcs.push_back(src_man.string(text, std::to_string(srcs.size())));
+
+    // lex in reverse order, collect tokens
+    std::vector<std::pair<unsigned, ulam::Token>> tokens;
+    for (unsigned n = srcs.size(); n-- > 0;) {
+        auto src = srcs[n];
+        ulam::Lex lex{pp, src_man, src->id(), src->content()};
+        ulam::Token token;
+        do {
+            lex.lex(token);
+            tokens.emplace_back(n, token);
+        } while (!token.is(ulam::tok::Eof));
+    }
+
+    for (const auto& [n, token] : tokens) {
+        const std::string text{Texts[n]};
+        auto loc = src_man.loc(token.loc_id);
+        if (loc.src_id() != srcs[n]->id()) {
+            std::cerr << "invalid source ID\n";
+            return -1;
+        }
+
+        // NOTE: EOF token includes terminating \0
+        auto str = src_man.str_at(token.loc_id, token.size);
+        if (!token.is(ulam::tok::Eof) &&
+            str != text.substr(loc.off(), token.size)) {
+            std::cerr << "invalid token string `" << str << "'\n";
+            return -1;
+        }
+
+        auto exp = expected(text, loc.off());
+        if (loc.linum() != exp.linum || loc.chr() != exp.chr) {
+            std::cerr << "source " << n << ", `" << str << "': " << loc.linum()
+                      << ":" << loc.chr() << ", expected " << exp.linum
+                      << ":" << exp.chr << "\n";
+            return -1;
+        }
+        if (src_man.line_at(token.loc_id) != exp.line) {
+            std::cerr << "source " << n << ", `" << str << "': invalid line `"
+                      << src_man.line_at(token.loc_id) << "'\n";
+            return -1;
+        }
+    }
+}
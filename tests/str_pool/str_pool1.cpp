@@ -0,0 +1,70 @@
+#include "libulam/str_pool.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    // more strings than 16-bit ids allow
+    const unsigned StrNum = 100000;
+
+    std::vector<std::string> strs;
+    for (unsigned n = 0; n < StrNum; ++n)
+        strs.push_back("str" + std::to_string(n));
+
+    ulam::UniqStrPool parent;
+    auto parent_id = parent.put("parent");
+
+    ulam::UniqStrPool pool{&parent};
+    if (pool.put("parent") != parent_id || pool.id("parent") != parent_id) {
+        std::cerr << "parent string is not reused\n";
+        return -1;
+    }
+
+    // concurrent readers
+    std::atomic<bool> done{false};
+    std::atomic<unsigned> found{0};
+    std::vector<std::thread> readers;
+    for (unsigned i = 0; i < 2; ++i) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                for (unsigned n = 0; n < StrNum; n += 997) {
+                    auto id = pool.id(strs[n]);
+                    if (id != ulam::NoStrId) {
+                        if (pool.get(id) != strs[n])
+                            std::abort();
+                        ++found;
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<ulam::str_id_t> ids;
+    for (const auto& str : strs)
+        ids.push_back(pool.put(str));
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    for (unsigned n = 0; n < StrNum; ++n) {
+        if (pool.put(strs[n]) != ids[n] || pool.id(strs[n]) != ids[n] ||
+            pool.get(ids[n]) != strs[n]) {
+            std::cerr << "invalid id for `" << strs[n] << "`\n";
+            return -1;
+        }
+    }
+    if (ids.back() < 0xffff) {
+        std::cerr << "unexpected id range\n";
+        return -1;
+    }
+    if (pool.has("missing")) {
+        std::cerr << "unexpected string\n";
+        return -1;
+    }
+
+    std::cout << "strings: " << StrNum << ", found by readers: " << found
+              << "\n";
+    return 0;
+}